@@ -0,0 +1,997 @@
+#include "stdafx.h"
+#include "PathfindingBenchmark.h"
+#include "ReferencePathfinders.h"
+
+#include "framework/EliteAI/EliteGraphs/EliteGraphAlgorithms/EAStar.h"
+#include "framework/EliteAI/EliteGraphs/EliteGraphAlgorithms/EBFS.h"
+#include "framework/EliteAI/EliteGraphs/EliteGraphAlgorithms/EBidirectionalAStar.h"
+#include "framework/EliteAI/EliteGraphs/EliteGraphAlgorithms/EBlockJPS.h"
+#include "framework/EliteAI/EliteGraphs/EliteGraphAlgorithms/EHPAStar.h"
+#include "framework/EliteAI/EliteGraphs/EliteGraphAlgorithms/EJPS.h"
+#include "framework/EliteAI/EliteGraphs/EliteGraphAlgorithms/EJPSPlus.h"
+#include "framework/EliteAI/EliteGraphs/EliteGraphUtilities/EJPSNeighborTable.h"
+#include "framework/EliteAI/EliteGraphs/EliteGraphUtilities/EGridMapFile.h"
+#include "framework/EliteAI/EliteGraphs/EliteGraphUtilities/EMovingAIMap.h"
+#include "framework/EliteAI/EliteGraphs/EliteGraphUtilities/EScenarioRunner.h"
+
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#endif
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+using namespace Elite;
+
+namespace
+{
+	using Clock = std::chrono::steady_clock;
+
+	//every heap allocation of the process, counted by the operator new below
+	std::atomic<long long> g_NrOfHeapAllocations{ 0 };
+
+	double GetMilliseconds(Clock::time_point startTime)
+	{
+		return std::chrono::duration<double, std::milli>(Clock::now() - startTime).count();
+	}
+
+	std::string EscapeJson(const std::string& text)
+	{
+		std::string escaped;
+		for (char c : text)
+		{
+			if (c == '"' || c == '\\')
+				escaped += '\\';
+			escaped += c;
+		}
+		return escaped;
+	}
+}
+
+//replaces the global operator new of the benchmark, the array and nothrow versions call this one
+//Measure counts the allocations of every search with it, SearchContext only notices its own buffers growing
+void* operator new(size_t size)
+{
+	++g_NrOfHeapAllocations;
+	if (void* pMemory = malloc(size > 0 ? size : 1))
+		return pMemory;
+	throw std::bad_alloc{};
+}
+
+void operator delete(void* pMemory) noexcept
+{
+	free(pMemory);
+}
+
+PathfindingBenchmark::PathfindingBenchmark(const BenchmarkOptions& options)
+	: m_Options{ options }
+{
+}
+
+PathfindingBenchmark::~PathfindingBenchmark()
+{
+	SAFE_DELETE(m_pGraph);
+}
+
+bool PathfindingBenchmark::Initialize()
+{
+	const auto startTime = Clock::now();
+	if (!m_Options.movingAIMapPath.empty() || !m_Options.gridMapPath.empty())
+	{
+		if (!LoadMap())
+			return false;
+	}
+	else
+		GenerateMap();
+	m_GraphBuildTime = GetMilliseconds(startTime);
+
+	//the other graphs the pathfinders can search, built out of the GridGraph
+	auto buildStartTime = Clock::now();
+	m_CompressedGraph.Build(m_pGraph);
+	m_CompressedGraphBuildTime = GetMilliseconds(buildStartTime);
+
+	//a grid map searches the mapped file without copying it, the other maps get their terrain copied cell by cell
+	buildStartTime = Clock::now();
+	if (m_GridMapFile.IsOpen())
+		m_pImplicitGraph = std::make_unique<ImplicitGridGraph>(m_GridMapFile.CreateImplicitGridGraph());
+	else
+	{
+		m_pImplicitGraph = std::make_unique<ImplicitGridGraph>(m_pGraph->GetColumns(), m_pGraph->GetRows(), m_pGraph->GetCellSize(),
+			m_pGraph->IsConnectedDiagonally(), m_pGraph->GetDefaultCostStraight(), m_pGraph->GetDefaultCostDiagonal(), m_pGraph->IsCornerCuttingAllowed());
+		for (int idx = 0; idx < m_pGraph->GetNrOfNodes(); ++idx)
+			m_pImplicitGraph->SetTerrainType(idx, m_pGraph->GetNode(idx)->GetTerrainType());
+	}
+	m_ImplicitGraphBuildTime = GetMilliseconds(buildStartTime);
+
+	if (!m_Options.scenarioPath.empty())
+		return LoadQueries();
+
+	GenerateQueries();
+	return !m_Queries.empty();
+}
+
+bool PathfindingBenchmark::LoadMap()
+{
+	if (!m_Options.movingAIMapPath.empty())
+	{
+		MovingAIMap map{};
+		if (!map.Load(m_Options.movingAIMapPath))
+			return false;
+		m_pGraph = map.CreateGridGraph<NodeType, ConnectionType>(1, false);
+		return true;
+	}
+
+	if (!m_GridMapFile.Open(m_Options.gridMapPath))
+		return false;
+	m_pGraph = m_GridMapFile.CreateGridGraph<NodeType, ConnectionType>(false);
+	return true;
+}
+
+void PathfindingBenchmark::GenerateMap()
+{
+	//the costs of the Moving AI benchmarks, so generated and loaded maps can be compared
+	m_pGraph = new GraphType(m_Options.nrOfColumns, m_Options.nrOfRows, 1, false, true, MovingAIMap::GetCostStraight(), MovingAIMap::GetCostDiagonal());
+
+	std::mt19937 randomEngine{ m_Options.seed };
+	std::uniform_real_distribution<float> distribution{ 0.f, 1.f };
+	std::vector<TerrainType> terrainTypes(m_pGraph->GetNrOfNodes(), TerrainType::Ground);
+	for (TerrainType& terrain : terrainTypes)
+	{
+		const float value{ distribution(randomEngine) };
+		if (value < m_Options.obstacleRatio)
+			terrain = TerrainType::Water;
+		else if (value < m_Options.obstacleRatio + m_Options.mudRatio)
+			terrain = TerrainType::Mud;
+	}
+	m_pGraph->SetTerrainTypes(terrainTypes);
+}
+
+bool PathfindingBenchmark::LoadQueries()
+{
+	std::vector<MovingAIScenario> scenarios;
+	if (!MovingAIMap::LoadScenarios(m_Options.scenarioPath, scenarios))
+		return false;
+
+	for (const MovingAIScenario& scenario : scenarios)
+	{
+		if (!m_pGraph->IsWithinBounds(scenario.startCol, scenario.startRow) || !m_pGraph->IsWithinBounds(scenario.goalCol, scenario.goalRow))
+			continue;
+		m_Scenarios.push_back(scenario);
+		m_Queries.push_back(Query{ m_pGraph->GetIndex(scenario.startCol, scenario.startRow), m_pGraph->GetIndex(scenario.goalCol, scenario.goalRow), scenario.optimalCost });
+	}
+	return !m_Queries.empty();
+}
+
+void PathfindingBenchmark::GenerateQueries()
+{
+	//label the connected areas first so every query has a path
+	const int nrOfNodes{ m_pImplicitGraph->GetNrOfNodes() };
+	std::vector<int> areas(nrOfNodes, invalid_node_index);
+	std::vector<int> walkableNodes;
+	std::vector<int> stack;
+	for (int idx = 0; idx < nrOfNodes; ++idx)
+	{
+		if (!m_pImplicitGraph->IsWalkable(idx) || areas[idx] != invalid_node_index)
+			continue;
+
+		areas[idx] = idx;
+		stack.push_back(idx);
+		while (!stack.empty())
+		{
+			const int currentIdx{ stack.back() };
+			stack.pop_back();
+			walkableNodes.push_back(currentIdx);
+			m_pImplicitGraph->ForEachConnection(currentIdx, [&](int nextIdx, float)
+			{
+				if (areas[nextIdx] == invalid_node_index)
+				{
+					areas[nextIdx] = idx;
+					stack.push_back(nextIdx);
+				}
+				return true;
+			});
+		}
+	}
+	if (walkableNodes.empty())
+		return;
+
+	std::mt19937 randomEngine{ m_Options.seed + 1 };
+	std::uniform_int_distribution<size_t> distribution{ 0, walkableNodes.size() - 1 };
+	const int maxNrOfAttempts{ m_Options.nrOfQueries * 100 };
+	for (int attempt = 0; attempt < maxNrOfAttempts && int(m_Queries.size()) < m_Options.nrOfQueries; ++attempt)
+	{
+		const int startIdx{ walkableNodes[distribution(randomEngine)] };
+		const int goalIdx{ walkableNodes[distribution(randomEngine)] };
+		if (startIdx != goalIdx && areas[startIdx] == areas[goalIdx])
+			m_Queries.push_back(Query{ startIdx, goalIdx, 0.f });
+	}
+}
+
+/// <summary>
+/// AStar, bidirectional AStar and JPS on the connection lists of the graph with one heuristic
+/// </summary>
+template<class T_HeuristicPolicy>
+void PathfindingBenchmark::RunHeuristic(const std::string& heuristicName, T_HeuristicPolicy heuristic)
+{
+	AStar<NodeType, ConnectionType, T_HeuristicPolicy> aStar{ m_pGraph, heuristic };
+	Measure("AStar", heuristicName, "lists", [&](int startIdx, int goalIdx, SearchContext& context) { return aStar.FindPath(startIdx, goalIdx, context); });
+
+	BidirectionalAStar<NodeType, ConnectionType, T_HeuristicPolicy> bidirectionalAStar{ m_pGraph, heuristic };
+	Measure("BidirectionalAStar", heuristicName, "lists", [&](int startIdx, int goalIdx, SearchContext& context)
+	{
+		return bidirectionalAStar.FindPath(startIdx, goalIdx, context);
+	});
+
+	JPS<NodeType, ConnectionType, T_HeuristicPolicy> jps{ m_pGraph, heuristic };
+	jps.SetExpandPath(true);
+	Measure("JPS", heuristicName, "lists", [&](int startIdx, int goalIdx, SearchContext& context) { return jps.FindPath(startIdx, goalIdx, context); });
+}
+
+/// <summary>
+/// Run every query through a pathfinder after a warm-up, each pathfinder gets a context of its own
+/// </summary>
+/// <param name="findPath">bool(startIdx, goalIdx, context), has to leave every cell of the path in context.GetPath()</param>
+template<class T_FindPath>
+void PathfindingBenchmark::Measure(const std::string& algorithm, const std::string& heuristic, const std::string& graph, T_FindPath findPath,
+	double precomputeTime, size_t precomputeMemory)
+{
+	//the warm-up grows the buffers of the context and pulls the graph into the caches
+	SearchContext context{};
+	for (int i = 0; i < m_Options.nrOfWarmUpQueries; ++i)
+	{
+		m_QueryNr = i % m_Queries.size();
+		const Query& query = m_Queries[m_QueryNr];
+		findPath(query.startIdx, query.goalIdx, context);
+	}
+
+	BenchmarkResult result{};
+	result.algorithm = algorithm;
+	result.heuristic = heuristic;
+	result.graph = graph;
+	result.querySet = m_QuerySetName;
+	result.nrOfQueries = int(m_Queries.size());
+	result.precomputeTime = precomputeTime;
+	result.precomputeMemory = precomputeMemory;
+
+	const GraphAdjacency<NodeType, ConnectionType> adjacency{ m_pGraph };
+	std::vector<double> times;
+	times.reserve(m_Queries.size());
+	double totalTime{ 0.0 };
+	double totalPathCost{ 0.0 };
+	double totalCostRatio{ 0.0 };
+	int nrOfCostRatios{ 0 };
+	long long totalExpandedNodes{ 0 };
+	long long totalGeneratedNodes{ 0 };
+	long long totalReopenedNodes{ 0 };
+	long long totalHeapPushes{ 0 };
+	long long totalHeapPops{ 0 };
+	long long totalDecreaseKeys{ 0 };
+	long long totalPeakOpenListSize{ 0 };
+	long long totalJumpSteps{ 0 };
+	double totalSearchTime{ 0.0 };
+	double totalReconstructionTime{ 0.0 };
+	long long nrOfHeapAllocations{ 0 };
+	const unsigned int nrOfWarmAllocatingSearches{ context.GetNrOfAllocatingSearches() };
+	for (m_QueryNr = 0; m_QueryNr < m_Queries.size(); ++m_QueryNr)
+	{
+		const Query& query = m_Queries[m_QueryNr];
+		const long long nrOfStartHeapAllocations{ g_NrOfHeapAllocations };
+		const auto startTime = Clock::now();
+		const bool foundPath{ findPath(query.startIdx, query.goalIdx, context) };
+		const double time{ std::chrono::duration<double, std::micro>(Clock::now() - startTime).count() };
+		nrOfHeapAllocations += g_NrOfHeapAllocations - nrOfStartHeapAllocations;
+
+		times.push_back(time);
+		totalTime += time;
+		const SearchStats& stats = context.GetStats();
+		totalExpandedNodes += stats.nrOfExpandedNodes;
+		totalGeneratedNodes += stats.nrOfGeneratedNodes;
+		totalReopenedNodes += stats.nrOfReopenedNodes;
+		totalHeapPushes += stats.nrOfHeapPushes;
+		totalHeapPops += stats.nrOfHeapPops;
+		totalDecreaseKeys += stats.nrOfDecreaseKeys;
+		totalPeakOpenListSize += stats.peakOpenListSize;
+		totalJumpSteps += stats.nrOfJumpSteps;
+		totalSearchTime += stats.searchTime;
+		totalReconstructionTime += stats.reconstructionTime;
+
+		double pathCost{};
+		if (!foundPath || !TryGetPathCost(adjacency, context.GetPath(), pathCost))
+			continue;
+
+		++result.nrOfSolved;
+		totalPathCost += pathCost;
+		if (query.optimalCost > 0.0)
+		{
+			totalCostRatio += pathCost / query.optimalCost;
+			++nrOfCostRatios;
+		}
+	}
+
+	std::sort(times.begin(), times.end());
+	const size_t nrOfTimes{ times.size() };
+	result.minTime = times.front();
+	result.medianTime = times[nrOfTimes / 2];
+	result.p99Time = times[std::min(nrOfTimes - 1, size_t(ceil(nrOfTimes * 0.99)) - 1)];
+	result.meanTime = totalTime / nrOfTimes;
+	result.throughput = totalTime > 0.0 ? nrOfTimes / (totalTime / 1000000.0) : 0.0;
+	result.averageExpandedNodes = double(totalExpandedNodes) / nrOfTimes;
+	result.expansionsPerSecond = totalTime > 0.0 ? totalExpandedNodes / (totalTime / 1000000.0) : 0.0;
+	result.averageGeneratedNodes = double(totalGeneratedNodes) / nrOfTimes;
+	result.averageReopenedNodes = double(totalReopenedNodes) / nrOfTimes;
+	result.averageHeapPushes = double(totalHeapPushes) / nrOfTimes;
+	result.averageHeapPops = double(totalHeapPops) / nrOfTimes;
+	result.averageDecreaseKeys = double(totalDecreaseKeys) / nrOfTimes;
+	result.averagePeakOpenListSize = double(totalPeakOpenListSize) / nrOfTimes;
+	result.averageJumpSteps = double(totalJumpSteps) / nrOfTimes;
+	result.averageSearchTime = totalSearchTime * 1000.0 / nrOfTimes;
+	result.averageReconstructionTime = totalReconstructionTime * 1000.0 / nrOfTimes;
+	result.averagePathCost = result.nrOfSolved > 0 ? totalPathCost / result.nrOfSolved : 0.0;
+	result.averageCostRatio = nrOfCostRatios > 0 ? totalCostRatio / nrOfCostRatios : 0.0;
+	result.scratchMemory = context.GetScratchMemorySize();
+	result.nrOfAllocatingSearches = int(context.GetNrOfAllocatingSearches() - nrOfWarmAllocatingSearches);
+	result.nrOfHeapAllocations = nrOfHeapAllocations;
+	result.peakProcessMemory = GetPeakProcessMemory();
+	m_Results.push_back(result);
+
+	std::cerr << algorithm << ' ' << heuristic << ' ' << graph << ' ' << m_QuerySetName << ": median " << result.medianTime << " us\n";
+}
+
+bool PathfindingBenchmark::Run()
+{
+	if (m_Options.mode == "buckets")
+		return RunScenarioBuckets();
+	if (m_Options.mode == "openlist")
+		return RunOpenListComparison();
+	if (m_Options.mode == "lookups")
+		return RunConnectionLookupComparison();
+	if (m_Options.mode == "adjacency")
+		return RunAdjacencyComparison();
+	if (m_Options.mode == "pruning")
+		return RunPruningCheck();
+
+	RunPathfinders();
+	return true;
+}
+
+/// <summary>
+/// Every pathfinder on every graph it can search, one result each
+/// </summary>
+void PathfindingBenchmark::RunPathfinders()
+{
+	//BFS doesn't use a heuristic
+	{
+		BFS<NodeType, ConnectionType> bfs{ m_pGraph };
+		Measure("BFS", "none", "lists", [&](int startIdx, int goalIdx, SearchContext& context) { return bfs.FindPath(startIdx, goalIdx, context); });
+		bfs.SetCompressedGraph(&m_CompressedGraph);
+		Measure("BFS", "none", "csr", [&](int startIdx, int goalIdx, SearchContext& context) { return bfs.FindPath(startIdx, goalIdx, context); },
+			m_CompressedGraphBuildTime, m_CompressedGraph.GetMemorySize());
+	}
+
+	//Manhattan overestimates diagonal steps, so its paths don't have to be the shortest
+	RunHeuristic<HeuristicPolicies::Manhattan>("manhattan");
+	RunHeuristic<HeuristicPolicies::Euclidean>("euclidean");
+	RunHeuristic<HeuristicPolicies::Octile>("octile");
+	//the same octile distance called through a function pointer, the way the pathfinders took their heuristic before the policies
+	RunHeuristic<HeuristicPolicies::Function>("octile_function", HeuristicPolicies::Function{ HeuristicFunctions::Octile });
+	RunHeuristic<HeuristicPolicies::Chebyshev>("chebyshev");
+
+	//the other graphs and the precomputed variants of JPS, with the heuristic that fits an 8 connected grid best
+	using Octile = HeuristicPolicies::Octile;
+	{
+		AStar<NodeType, ConnectionType, Octile> aStar{ m_pGraph };
+		aStar.SetCompressedGraph(&m_CompressedGraph);
+		Measure("AStar", "octile", "csr", [&](int startIdx, int goalIdx, SearchContext& context) { return aStar.FindPath(startIdx, goalIdx, context); },
+			m_CompressedGraphBuildTime, m_CompressedGraph.GetMemorySize());
+
+		BidirectionalAStar<NodeType, ConnectionType, Octile> bidirectionalAStar{ m_pGraph };
+		bidirectionalAStar.SetCompressedGraph(&m_CompressedGraph);
+		Measure("BidirectionalAStar", "octile", "csr", [&](int startIdx, int goalIdx, SearchContext& context)
+		{
+			return bidirectionalAStar.FindPath(startIdx, goalIdx, context);
+		}, m_CompressedGraphBuildTime, m_CompressedGraph.GetMemorySize());
+
+		JPS<NodeType, ConnectionType, Octile> jps{ m_pGraph };
+		jps.SetExpandPath(true);
+		jps.SetCompressedGraph(&m_CompressedGraph);
+		Measure("JPS", "octile", "csr", [&](int startIdx, int goalIdx, SearchContext& context) { return jps.FindPath(startIdx, goalIdx, context); },
+			m_CompressedGraphBuildTime, m_CompressedGraph.GetMemorySize());
+	}
+	{
+		AStar<NodeType, ConnectionType, Octile> aStar{ m_pImplicitGraph.get() };
+		Measure("AStar", "octile", "implicit", [&](int startIdx, int goalIdx, SearchContext& context) { return aStar.FindPath(startIdx, goalIdx, context); },
+			m_ImplicitGraphBuildTime, m_pImplicitGraph->GetMemorySize());
+
+		JPS<NodeType, ConnectionType, Octile> jps{ m_pImplicitGraph.get() };
+		jps.SetExpandPath(true);
+		Measure("JPS", "octile", "implicit", [&](int startIdx, int goalIdx, SearchContext& context) { return jps.FindPath(startIdx, goalIdx, context); },
+			m_ImplicitGraphBuildTime, m_pImplicitGraph->GetMemorySize());
+	}
+	{
+		auto startTime = Clock::now();
+		BlockJPS<NodeType, ConnectionType, Octile> blockJPS{ m_pGraph };
+		const double buildTime{ GetMilliseconds(startTime) };
+		blockJPS.SetExpandPath(true);
+		Measure("BlockJPS", "octile", "lists", [&](int startIdx, int goalIdx, SearchContext& context)
+		{
+			return blockJPS.FindPath(m_pGraph->GetNode(startIdx), m_pGraph->GetNode(goalIdx), context);
+		}, buildTime, blockJPS.GetGrid().GetMemorySize());
+	}
+	{
+		auto startTime = Clock::now();
+		JPSPlus<NodeType, ConnectionType, Octile> jpsPlus{ m_pGraph };
+		const double buildTime{ GetMilliseconds(startTime) };
+		jpsPlus.SetExpandPath(true);
+		Measure("JPS+", "octile", "lists", [&](int startIdx, int goalIdx, SearchContext& context)
+		{
+			return jpsPlus.FindPath(m_pGraph->GetNode(startIdx), m_pGraph->GetNode(goalIdx), context);
+		}, buildTime, jpsPlus.GetGrid().GetMemorySize() + jpsPlus.GetJumpDistances().GetMemorySize());
+	}
+	//HPA* with a small and a large cluster size: larger clusters make the abstract graph smaller but the paths inside a cluster longer
+	for (int clusterSize : { 16, 32 })
+	{
+		auto startTime = Clock::now();
+		HPAStar<NodeType, ConnectionType, Octile> hpaStar{ m_pGraph, clusterSize };
+		const double buildTime{ GetMilliseconds(startTime) };
+		hpaStar.SetCompressedGraph(&m_CompressedGraph);
+		Measure("HPA*" + std::to_string(clusterSize), "octile", "csr", [&](int startIdx, int goalIdx, SearchContext& context)
+		{
+			return hpaStar.FindPath(startIdx, goalIdx, context);
+		}, buildTime, hpaStar.GetMemorySize());
+	}
+
+	RunLongQueries();
+	RunMultiGoalQueries(8);
+	RunMultiGoalQueries(64);
+}
+
+/// <summary>
+/// BFS, AStar and JPS over the scenarios per bucket, on the connection lists, the compressed graph and the implicit graph
+/// AStar and JPS have to find the optimal cost of every scenario, BFS only finds the fewest steps so it is only measured
+/// </summary>
+/// <returns>false when AStar or JPS left a scenario unsolved or missed its optimal cost</returns>
+bool PathfindingBenchmark::RunScenarioBuckets()
+{
+	const GraphAdjacency<NodeType, ConnectionType> adjacency{ m_pGraph };
+	BFS<NodeType, ConnectionType> bfs{ m_pGraph };
+	MeasureBuckets("BFS lists", bfs, adjacency, false);
+	bfs.SetCompressedGraph(&m_CompressedGraph);
+	MeasureBuckets("BFS csr", bfs, m_CompressedGraph, false);
+
+	using Octile = HeuristicPolicies::Octile;
+	bool foundOptimalCosts{ true };
+	{
+		AStar<NodeType, ConnectionType, Octile> aStar{ m_pGraph };
+		foundOptimalCosts &= MeasureBuckets("AStar octile lists", aStar, adjacency, true);
+		aStar.SetCompressedGraph(&m_CompressedGraph);
+		foundOptimalCosts &= MeasureBuckets("AStar octile csr", aStar, m_CompressedGraph, true);
+
+		AStar<NodeType, ConnectionType, Octile> implicitAStar{ m_pImplicitGraph.get() };
+		foundOptimalCosts &= MeasureBuckets("AStar octile implicit", implicitAStar, *m_pImplicitGraph, true);
+	}
+	{
+		JPS<NodeType, ConnectionType, Octile> jps{ m_pGraph };
+		jps.SetExpandPath(true);
+		foundOptimalCosts &= MeasureBuckets("JPS octile lists", jps, adjacency, true);
+		jps.SetCompressedGraph(&m_CompressedGraph);
+		foundOptimalCosts &= MeasureBuckets("JPS octile csr", jps, m_CompressedGraph, true);
+
+		JPS<NodeType, ConnectionType, Octile> implicitJPS{ m_pImplicitGraph.get() };
+		implicitJPS.SetExpandPath(true);
+		foundOptimalCosts &= MeasureBuckets("JPS octile implicit", implicitJPS, *m_pImplicitGraph, true);
+	}
+	return foundOptimalCosts;
+}
+
+/// <summary>
+/// AStar against the sorted vector open list AStar had before IndexedPriorityQueue, on the same graph with the same queries
+/// the rows differ in the open list only, their expansions per second show what the heap gains on this map size
+/// </summary>
+/// <returns>false when the two don't solve the same queries with the same average path cost</returns>
+bool PathfindingBenchmark::RunOpenListComparison()
+{
+	using Octile = HeuristicPolicies::Octile;
+	const GraphAdjacency<NodeType, ConnectionType> adjacency{ m_pGraph };
+	SortedOpenListAStar<GraphAdjacency<NodeType, ConnectionType>, Octile> sortedAStar{ adjacency, m_pGraph->GetColumns() };
+	Measure("AStarSortedOpenList", "octile", "lists", [&](int startIdx, int goalIdx, SearchContext& context)
+	{
+		return sortedAStar.FindPath(startIdx, goalIdx, context);
+	});
+
+	AStar<NodeType, ConnectionType, Octile> aStar{ m_pGraph };
+	Measure("AStar", "octile", "lists", [&](int startIdx, int goalIdx, SearchContext& context) { return aStar.FindPath(startIdx, goalIdx, context); });
+
+	const BenchmarkResult& sortedResult = m_Results[m_Results.size() - 2];
+	const BenchmarkResult& heapResult = m_Results.back();
+	std::cerr << "expansions per second: sorted vector " << sortedResult.expansionsPerSecond << ", heap " << heapResult.expansionsPerSecond
+		<< " (x" << (sortedResult.expansionsPerSecond > 0.0 ? heapResult.expansionsPerSecond / sortedResult.expansionsPerSecond : 0.0) << ")\n";
+	return HaveSamePathCosts(sortedResult, heapResult);
+}
+
+/// <summary>
+/// JPS and AStar on the connection lists of the graph, first on a copy that scans the lists to look a connection up
+/// like GridGraph did before its direction slots, then on the graph itself
+/// </summary>
+/// <returns>false when a pathfinder doesn't solve the same queries with the same average path cost on both</returns>
+bool PathfindingBenchmark::RunConnectionLookupComparison()
+{
+	ListScanGridGraph<NodeType, ConnectionType> listScanGraph{ *m_pGraph };
+
+	//every lookup between neighbors, the first thing the slots speed up
+	//the connections found get counted so the lookups can't be left out
+	long long nrOfConnections{ 0 };
+	auto getLookupTime = [&nrOfConnections](const GraphType& graph)
+	{
+		const int nrOfRounds{ 10 };
+		long long nrOfLookups{ 0 };
+		const auto startTime = Clock::now();
+		for (int round = 0; round < nrOfRounds; ++round)
+		{
+			for (int idx = 0; idx < graph.GetNrOfNodes(); ++idx)
+			{
+				const int col{ idx % graph.GetColumns() };
+				const int row{ idx / graph.GetColumns() };
+				for (int direction = 0; direction < GridDirections::nr_of_directions; ++direction)
+				{
+					const int neighborCol{ col + GridDirections::GetDeltaCol(direction) };
+					const int neighborRow{ row + GridDirections::GetDeltaRow(direction) };
+					if (!graph.IsWithinBounds(neighborCol, neighborRow))
+						continue;
+					++nrOfLookups;
+					nrOfConnections += graph.GetConnection(idx, graph.GetIndex(neighborCol, neighborRow)) != nullptr;
+				}
+			}
+		}
+		return nrOfLookups > 0 ? GetMilliseconds(startTime) * 1000000.0 / nrOfLookups : 0.0;
+	};
+	const double listScanLookupTime{ getLookupTime(listScanGraph) };
+	const double slotLookupTime{ getLookupTime(*m_pGraph) };
+	std::cerr << "GetConnection between neighbors: list scan " << listScanLookupTime << " ns, direction slots " << slotLookupTime
+		<< " ns (" << nrOfConnections << " connections found)\n";
+
+	using Octile = HeuristicPolicies::Octile;
+	bool haveSamePathCosts{ true };
+	{
+		JPS<NodeType, ConnectionType, Octile> listScanJPS{ &listScanGraph };
+		listScanJPS.SetExpandPath(true);
+		Measure("JPS", "octile", "lists_scan", [&](int startIdx, int goalIdx, SearchContext& context) { return listScanJPS.FindPath(startIdx, goalIdx, context); });
+
+		JPS<NodeType, ConnectionType, Octile> jps{ m_pGraph };
+		jps.SetExpandPath(true);
+		Measure("JPS", "octile", "lists", [&](int startIdx, int goalIdx, SearchContext& context) { return jps.FindPath(startIdx, goalIdx, context); });
+		haveSamePathCosts &= HaveSamePathCosts(m_Results[m_Results.size() - 2], m_Results.back());
+	}
+	{
+		AStar<NodeType, ConnectionType, Octile> listScanAStar{ &listScanGraph };
+		Measure("AStar", "octile", "lists_scan", [&](int startIdx, int goalIdx, SearchContext& context) { return listScanAStar.FindPath(startIdx, goalIdx, context); });
+
+		AStar<NodeType, ConnectionType, Octile> aStar{ m_pGraph };
+		Measure("AStar", "octile", "lists", [&](int startIdx, int goalIdx, SearchContext& context) { return aStar.FindPath(startIdx, goalIdx, context); });
+		haveSamePathCosts &= HaveSamePathCosts(m_Results[m_Results.size() - 2], m_Results.back());
+	}
+	return haveSamePathCosts;
+}
+
+/// <summary>
+/// The connection lists of the graph against its CompressedGraph copy: how fast ForEachConnection walks every node and how much memory a connection takes,
+/// then AStar on both
+/// </summary>
+/// <returns>false when the two don't have the same connections or AStar finds paths of a different cost</returns>
+bool PathfindingBenchmark::RunAdjacencyComparison()
+{
+	//every connection of every node a few rounds, the destinations and costs get summed so the walk can't be left out
+	struct WalkResult
+	{
+		long long nrOfConnections;
+		long long destinationSum;
+		double costSum;
+		double connectionsPerSecond;
+	};
+	auto walk = [](const auto& adjacency)
+	{
+		const int nrOfRounds{ 10 };
+		WalkResult result{};
+		const auto startTime = Clock::now();
+		for (int round = 0; round < nrOfRounds; ++round)
+		{
+			for (int idx = 0; idx < adjacency.GetNrOfNodes(); ++idx)
+			{
+				adjacency.ForEachConnection(idx, [&result](int toIdx, float cost)
+				{
+					++result.nrOfConnections;
+					result.destinationSum += toIdx;
+					result.costSum += cost;
+					return true;
+				});
+			}
+		}
+		const double time{ GetMilliseconds(startTime) };
+		result.connectionsPerSecond = time > 0.0 ? result.nrOfConnections / (time / 1000.0) : 0.0;
+		return result;
+	};
+	const WalkResult listsResult{ walk(GraphAdjacency<NodeType, ConnectionType>{ m_pGraph }) };
+	const WalkResult compressedResult{ walk(m_CompressedGraph) };
+
+	//a list entry is a heap node with 2 links and the pointer, and the connection is allocated on its own, both without the allocator overhead
+	const size_t nrOfConnections{ size_t(m_pGraph->GetNrOfConnections()) };
+	const size_t listsMemorySize{ m_pGraph->GetAllConnections().capacity() * sizeof(GraphType::ConnectionList)
+		+ nrOfConnections * (3 * sizeof(void*) + sizeof(ConnectionType)) };
+	const double listsBytesPerConnection{ nrOfConnections > 0 ? double(listsMemorySize) / nrOfConnections : 0.0 };
+	const double compressedBytesPerConnection{ nrOfConnections > 0 ? double(m_CompressedGraph.GetMemorySize()) / nrOfConnections : 0.0 };
+	std::cerr << "ForEachConnection over every node: lists " << listsResult.connectionsPerSecond / 1000000.0 << " M connections/s, csr "
+		<< compressedResult.connectionsPerSecond / 1000000.0 << " M connections/s\n"
+		<< "memory: lists " << listsBytesPerConnection << " B per connection, csr " << compressedBytesPerConnection << " B per connection ("
+		<< nrOfConnections << " connections)\n";
+
+	const bool haveSameConnections{ listsResult.nrOfConnections == compressedResult.nrOfConnections
+		&& listsResult.destinationSum == compressedResult.destinationSum && fabs(listsResult.costSum - compressedResult.costSum) <= 0.001 * listsResult.costSum };
+	if (!haveSameConnections)
+		std::cerr << "the lists have " << listsResult.nrOfConnections << " connections and the csr copy " << compressedResult.nrOfConnections << '\n';
+
+	using Octile = HeuristicPolicies::Octile;
+	AStar<NodeType, ConnectionType, Octile> aStar{ m_pGraph };
+	Measure("AStar", "octile", "lists", [&](int startIdx, int goalIdx, SearchContext& context) { return aStar.FindPath(startIdx, goalIdx, context); });
+	AStar<NodeType, ConnectionType, Octile> compressedAStar{ m_pGraph };
+	compressedAStar.SetCompressedGraph(&m_CompressedGraph);
+	Measure("AStar", "octile", "csr", [&](int startIdx, int goalIdx, SearchContext& context) { return compressedAStar.FindPath(startIdx, goalIdx, context); },
+		m_CompressedGraphBuildTime, m_CompressedGraph.GetMemorySize());
+	return HaveSamePathCosts(m_Results[m_Results.size() - 2], m_Results.back()) && haveSameConnections;
+}
+
+/// <summary>
+/// JPSNeighborTable against CostPruningJPS, which prunes by the cost based definition the table replaced
+/// first the directions of every cell and incoming direction on small seeded random grids, with and without corner cutting,
+/// then the path costs of both kinds of JPS and AStar on those grids and on the queries, and last how fast both JPS are
+/// </summary>
+/// <returns>false when the directions or a path cost differ anywhere</returns>
+bool PathfindingBenchmark::RunPruningCheck()
+{
+	using Octile = HeuristicPolicies::Octile;
+	using Adjacency = GraphAdjacency<NodeType, ConnectionType>;
+
+	//true when JPS and the cost pruning JPS find a path exactly when AStar does, of the same cost
+	int nrOfPathChecks{ 0 };
+	int nrOfPathDifferences{ 0 };
+	SearchContext context{};
+	auto checkPaths = [&](const Adjacency& adjacency, auto& jps, auto& costPruningJPS, auto& aStar, int startIdx, int goalIdx)
+	{
+		double aStarCost{};
+		const bool foundAStarPath{ aStar.FindPath(startIdx, goalIdx, context) && TryGetPathCost(adjacency, context.GetPath(), aStarCost) };
+		auto isSame = [&](bool foundPath)
+		{
+			double cost{};
+			const bool isValidPath{ foundPath && TryGetPathCost(adjacency, context.GetPath(), cost) };
+			return isValidPath == foundAStarPath && (!foundAStarPath || fabs(cost - aStarCost) <= aStarCost * 0.0001);
+		};
+		const bool isSameForJPS{ isSame(jps.FindPath(startIdx, goalIdx, context)) };
+		const bool isSameForCostPruningJPS{ isSame(costPruningJPS.FindPath(startIdx, goalIdx, context)) };
+		++nrOfPathChecks;
+		if (!isSameForJPS || !isSameForCostPruningJPS)
+			++nrOfPathDifferences;
+	};
+
+	//small grids so every pattern of blocked neighbors shows up often, from open to mostly water
+	const int nrOfGrids{ 200 };
+	const int gridSize{ 16 };
+	const int nrOfQueriesPerGrid{ 20 };
+	std::mt19937 randomEngine{ m_Options.seed };
+	std::uniform_real_distribution<float> distribution{ 0.f, 1.f };
+	std::uniform_int_distribution<int> cellDistribution{ 0, gridSize * gridSize - 1 };
+	long long nrOfDirectionChecks{ 0 };
+	long long nrOfDirectionDifferences{ 0 };
+	for (int gridNr = 0; gridNr < nrOfGrids; ++gridNr)
+	{
+		const bool isCornerCuttingAllowed{ gridNr % 2 == 0 };
+		const float obstacleRatio{ distribution(randomEngine) * 0.6f };
+		GraphType graph{ gridSize, gridSize, 1, false, true, MovingAIMap::GetCostStraight(), MovingAIMap::GetCostDiagonal(), isCornerCuttingAllowed };
+		std::vector<TerrainType> terrainTypes(graph.GetNrOfNodes(), TerrainType::Ground);
+		for (TerrainType& terrain : terrainTypes)
+		{
+			if (distribution(randomEngine) < obstacleRatio)
+				terrain = TerrainType::Water;
+		}
+		graph.SetTerrainTypes(terrainTypes);
+
+		const Adjacency adjacency{ &graph };
+		CostPruningJPS<Adjacency, Octile> costPruningJPS{ adjacency, gridSize, gridSize, graph.GetDefaultCostStraight(), graph.GetDefaultCostDiagonal() };
+		for (int idx = 0; idx < graph.GetNrOfNodes(); ++idx)
+		{
+			//every direction the cell can be reached in
+			const unsigned int walkableDirections{ costPruningJPS.GetWalkableDirections(idx) };
+			for (int direction = 0; direction < GridDirections::nr_of_directions; ++direction)
+			{
+				if ((walkableDirections & (1u << GridDirections::Rotate(direction, GridDirections::nr_of_directions / 2))) == 0)
+					continue;
+
+				const unsigned int directions{ JPSNeighborTable::GetDirectionsToExplore(direction, static_cast<unsigned char>(~walkableDirections), isCornerCuttingAllowed) };
+				++nrOfDirectionChecks;
+				if (directions != costPruningJPS.GetDirectionsToExplore(idx, direction))
+					++nrOfDirectionDifferences;
+			}
+		}
+
+		//the cells don't have to be walkable or connected, not finding a path has to agree as well
+		JPS<NodeType, ConnectionType, Octile> jps{ &graph };
+		jps.SetExpandPath(true);
+		AStar<NodeType, ConnectionType, Octile> aStar{ &graph };
+		for (int i = 0; i < nrOfQueriesPerGrid; ++i)
+			checkPaths(adjacency, jps, costPruningJPS, aStar, cellDistribution(randomEngine), cellDistribution(randomEngine));
+	}
+	std::cerr << "pruning directions: " << nrOfDirectionDifferences << " of " << nrOfDirectionChecks << " cell and direction pairs differ\n"
+		<< "paths on the random grids: " << nrOfPathDifferences << " of " << nrOfPathChecks << " differ from AStar\n";
+	const bool isSameOnRandomGrids{ nrOfDirectionDifferences == 0 && nrOfPathDifferences == 0 };
+
+	//the queries on the map of the benchmark
+	const Adjacency adjacency{ m_pGraph };
+	CostPruningJPS<Adjacency, Octile> costPruningJPS{ adjacency, m_pGraph->GetColumns(), m_pGraph->GetRows(),
+		m_pGraph->GetDefaultCostStraight(), m_pGraph->GetDefaultCostDiagonal() };
+	JPS<NodeType, ConnectionType, Octile> jps{ m_pGraph };
+	jps.SetExpandPath(true);
+	AStar<NodeType, ConnectionType, Octile> aStar{ m_pGraph };
+	nrOfPathChecks = 0;
+	nrOfPathDifferences = 0;
+	for (const Query& query : m_Queries)
+		checkPaths(adjacency, jps, costPruningJPS, aStar, query.startIdx, query.goalIdx);
+	std::cerr << "paths on the map: " << nrOfPathDifferences << " of " << nrOfPathChecks << " differ from AStar\n";
+
+	Measure("JPSCostPruning", "octile", "lists", [&](int startIdx, int goalIdx, SearchContext& context) { return costPruningJPS.FindPath(startIdx, goalIdx, context); });
+	Measure("JPS", "octile", "lists", [&](int startIdx, int goalIdx, SearchContext& context) { return jps.FindPath(startIdx, goalIdx, context); });
+	return isSameOnRandomGrids && nrOfPathDifferences == 0;
+}
+
+/// <summary>
+/// Check whether 2 pathfinders that should find paths of the same cost did, on the same queries
+/// </summary>
+bool PathfindingBenchmark::HaveSamePathCosts(const BenchmarkResult& result, const BenchmarkResult& otherResult) const
+{
+	if (result.nrOfSolved == otherResult.nrOfSolved && fabs(result.averagePathCost - otherResult.averagePathCost) <= 0.001)
+		return true;
+
+	std::cerr << result.algorithm << ' ' << result.graph << " solved " << result.nrOfSolved << " with an average cost of " << result.averagePathCost
+		<< ", " << otherResult.algorithm << ' ' << otherResult.graph << " solved " << otherResult.nrOfSolved << " with " << otherResult.averagePathCost << '\n';
+	return false;
+}
+
+/// <summary>
+/// Replay the scenarios through a pathfinder after a warm-up and keep its results per bucket
+/// </summary>
+/// <param name="pathfinder">Anything RunScenarios can run</param>
+/// <param name="adjacency">The graph the pathfinder searches, the path costs are measured on it</param>
+/// <param name="isOptimal">Whether the pathfinder has to find the optimal cost of every scenario</param>
+/// <returns>false when it had to find every optimal cost and didn't</returns>
+template<class T_Pathfinder, class T_Adjacency>
+bool PathfindingBenchmark::MeasureBuckets(const std::string& name, T_Pathfinder& pathfinder, const T_Adjacency& adjacency, bool isOptimal)
+{
+	SearchContext context{};
+	for (int i = 0; i < m_Options.nrOfWarmUpQueries; ++i)
+	{
+		const Query& query = m_Queries[i % m_Queries.size()];
+		pathfinder.FindPath(query.startIdx, query.goalIdx, context);
+	}
+	//the optimal costs of a .scen file are rounded, a ratio this close to 1 is still the optimal cost
+	const double maxCostRatioError{ 0.0001 };
+	m_BucketResults.emplace_back(name, RunScenarios(pathfinder, adjacency, m_pGraph->GetColumns(), m_Scenarios, context, maxCostRatioError));
+	std::cerr << name << ": " << m_Scenarios.size() << " scenarios in " << m_BucketResults.back().second.size() << " buckets\n";
+	if (!isOptimal)
+		return true;
+
+	//a ratio under 1 is a path that is cheaper than possible, a graph that cuts corners the benchmark doesn't for example
+	bool foundOptimalCosts{ true };
+	for (const ScenarioBucketResult& result : m_BucketResults.back().second)
+	{
+		const bool hasOptimalCostRatios{ result.GetNrOfSolved() == 0
+			|| (fabs(result.minCostRatio - 1.0) <= maxCostRatioError && fabs(result.maxCostRatio - 1.0) <= maxCostRatioError) };
+		if (result.nrOfUnsolved == 0 && result.nrOfSuboptimal == 0 && hasOptimalCostRatios)
+			continue;
+
+		std::cerr << name << ": bucket " << result.bucket << " has " << result.nrOfUnsolved << " unsolved and " << result.nrOfSuboptimal
+			<< " suboptimal scenarios, cost ratios " << result.minCostRatio << " to " << result.maxCostRatio << '\n';
+		foundOptimalCosts = false;
+	}
+	return foundOptimalCosts;
+}
+
+/// <summary>
+/// AStar against bidirectional AStar on only the longest tenth of the queries, where searching from both ends should pay off most
+/// </summary>
+void PathfindingBenchmark::RunLongQueries()
+{
+	if (m_Queries.size() < 10)
+		return;
+
+	//the optimal cost of a scenario when it's known, the octile distance otherwise
+	const int nrOfColumns{ m_pGraph->GetColumns() };
+	const HeuristicPolicies::Octile octile{};
+	auto getLength = [&](const Query& query)
+	{
+		if (query.optimalCost > 0.0)
+			return query.optimalCost;
+		return double(octile(abs(query.goalIdx % nrOfColumns - query.startIdx % nrOfColumns), abs(query.goalIdx / nrOfColumns - query.startIdx / nrOfColumns)));
+	};
+
+	std::vector<Query> longQueries{ m_Queries };
+	const size_t nrOfLongQueries{ longQueries.size() / 10 };
+	std::nth_element(longQueries.begin(), longQueries.begin() + nrOfLongQueries, longQueries.end(),
+		[&](const Query& a, const Query& b) { return getLength(a) > getLength(b); });
+	longQueries.resize(nrOfLongQueries);
+
+	std::swap(m_Queries, longQueries);
+	m_QuerySetName = "long";
+
+	using Octile = HeuristicPolicies::Octile;
+	AStar<NodeType, ConnectionType, Octile> aStar{ m_pGraph };
+	aStar.SetCompressedGraph(&m_CompressedGraph);
+	Measure("AStar", "octile", "csr", [&](int startIdx, int goalIdx, SearchContext& context) { return aStar.FindPath(startIdx, goalIdx, context); },
+		m_CompressedGraphBuildTime, m_CompressedGraph.GetMemorySize());
+
+	BidirectionalAStar<NodeType, ConnectionType, Octile> bidirectionalAStar{ m_pGraph };
+	bidirectionalAStar.SetCompressedGraph(&m_CompressedGraph);
+	Measure("BidirectionalAStar", "octile", "csr", [&](int startIdx, int goalIdx, SearchContext& context)
+	{
+		return bidirectionalAStar.FindPath(startIdx, goalIdx, context);
+	}, m_CompressedGraphBuildTime, m_CompressedGraph.GetMemorySize());
+
+	std::swap(m_Queries, longQueries);
+	m_QuerySetName = "all";
+}
+
+/// <summary>
+/// One AStar search to the nearest of many destinations against one search per destination
+/// </summary>
+/// <param name="nrOfDestinations">The goal of a query and the goals of the queries after it are its destinations</param>
+void PathfindingBenchmark::RunMultiGoalQueries(int nrOfDestinations)
+{
+	//the goals of the other queries don't have to be reachable from the start, like the health pack on an island
+	std::vector<std::vector<int>> destinations(m_Queries.size());
+	for (size_t i = 0; i < m_Queries.size(); ++i)
+	{
+		for (int j = 0; j < nrOfDestinations; ++j)
+			destinations[i].push_back(m_Queries[(i + j) % m_Queries.size()].goalIdx);
+	}
+
+	//the optimal cost of a query is the one to its own goal, not to the nearest destination
+	std::vector<Query> multiGoalQueries{ m_Queries };
+	for (Query& query : multiGoalQueries)
+		query.optimalCost = 0.0;
+	std::swap(m_Queries, multiGoalQueries);
+	m_QuerySetName = "goals_" + std::to_string(nrOfDestinations);
+
+	using Octile = HeuristicPolicies::Octile;
+	AStar<NodeType, ConnectionType, Octile> aStar{ m_pGraph };
+	aStar.SetCompressedGraph(&m_CompressedGraph);
+	Measure("MultiGoalAStar", "octile", "csr", [&](int startIdx, int, SearchContext& context)
+	{
+		return aStar.FindPath(startIdx, destinations[m_QueryNr], context);
+	}, m_CompressedGraphBuildTime, m_CompressedGraph.GetMemorySize());
+
+	//the path to the cheapest destination is copied back into the context at the end, its search counters are the ones of the last search
+	std::vector<int> cheapestPath;
+	Measure("AStarPerGoal", "octile", "csr", [&](int startIdx, int, SearchContext& context)
+	{
+		float cheapestCost{ FLT_MAX };
+		for (int destinationIdx : destinations[m_QueryNr])
+		{
+			if (!aStar.FindPath(startIdx, destinationIdx, context))
+				continue;
+
+			const float cost{ context.GetNodeStates().GetState(destinationIdx).costSoFar };
+			if (cost < cheapestCost)
+			{
+				cheapestCost = cost;
+				cheapestPath = context.GetPath();
+			}
+		}
+		if (cheapestCost == FLT_MAX)
+			return false;
+
+		context.GetPath() = cheapestPath;
+		return true;
+	}, m_CompressedGraphBuildTime, m_CompressedGraph.GetMemorySize());
+
+	std::swap(m_Queries, multiGoalQueries);
+	m_QuerySetName = "all";
+}
+
+bool PathfindingBenchmark::WriteResults() const
+{
+	if (m_Options.outputPath.empty())
+	{
+		Write(std::cout);
+		return bool(std::cout);
+	}
+
+	std::ofstream file{ m_Options.outputPath };
+	if (!file)
+		return false;
+	Write(file);
+	return bool(file);
+}
+
+void PathfindingBenchmark::Write(std::ostream& stream) const
+{
+	if (m_Options.mode == "buckets")
+	{
+		for (const auto& bucketResults : m_BucketResults)
+			PrintScenarioResults(stream, bucketResults.first, bucketResults.second);
+	}
+	else if (m_Options.writeJson)
+		WriteJson(stream);
+	else
+		WriteCsv(stream);
+}
+
+void PathfindingBenchmark::WriteCsv(std::ostream& stream) const
+{
+	stream << "algorithm,heuristic,graph,query_set,queries,solved,min_us,median_us,p99_us,mean_us,throughput_qps,avg_expanded,expansions_per_s,"
+		"avg_generated,avg_reopened,avg_heap_pushes,avg_heap_pops,avg_decrease_keys,avg_peak_open,avg_jump_steps,avg_search_us,avg_reconstruction_us,"
+		"avg_path_cost,avg_cost_ratio,precompute_ms,precompute_bytes,scratch_bytes,allocating_searches,heap_allocations,peak_process_bytes\n";
+	for (const BenchmarkResult& result : m_Results)
+	{
+		stream << result.algorithm << ',' << result.heuristic << ',' << result.graph << ',' << result.querySet << ',' << result.nrOfQueries << ',' << result.nrOfSolved << ','
+			<< result.minTime << ',' << result.medianTime << ',' << result.p99Time << ',' << result.meanTime << ',' << result.throughput << ','
+			<< result.averageExpandedNodes << ',' << result.expansionsPerSecond << ',' << result.averageGeneratedNodes << ',' << result.averageReopenedNodes << ','
+			<< result.averageHeapPushes << ',' << result.averageHeapPops << ',' << result.averageDecreaseKeys << ','
+			<< result.averagePeakOpenListSize << ',' << result.averageJumpSteps << ','
+			<< result.averageSearchTime << ',' << result.averageReconstructionTime << ','
+			<< result.averagePathCost << ',' << result.averageCostRatio << ','
+			<< result.precomputeTime << ',' << result.precomputeMemory << ',' << result.scratchMemory << ','
+			<< result.nrOfAllocatingSearches << ',' << result.nrOfHeapAllocations << ',' << result.peakProcessMemory << '\n';
+	}
+}
+
+void PathfindingBenchmark::WriteJson(std::ostream& stream) const
+{
+	stream << "{\n"
+		<< "  \"map\": { \"columns\": " << m_pGraph->GetColumns() << ", \"rows\": " << m_pGraph->GetRows()
+		<< ", \"source\": \"" << EscapeJson(!m_Options.movingAIMapPath.empty() ? m_Options.movingAIMapPath : m_Options.gridMapPath.empty() ? "generated" : m_Options.gridMapPath)
+		<< "\", \"build_ms\": " << m_GraphBuildTime << " },\n"
+		<< "  \"queries\": " << m_Queries.size() << ",\n"
+		<< "  \"warm_up_queries\": " << m_Options.nrOfWarmUpQueries << ",\n"
+		<< "  \"results\": [\n";
+	for (size_t i = 0; i < m_Results.size(); ++i)
+	{
+		const BenchmarkResult& result = m_Results[i];
+		stream << "    { \"algorithm\": \"" << result.algorithm << "\", \"heuristic\": \"" << result.heuristic << "\", \"graph\": \"" << result.graph
+			<< "\", \"query_set\": \"" << result.querySet << "\", \"queries\": " << result.nrOfQueries << ", \"solved\": " << result.nrOfSolved
+			<< ", \"min_us\": " << result.minTime << ", \"median_us\": " << result.medianTime << ", \"p99_us\": " << result.p99Time
+			<< ", \"mean_us\": " << result.meanTime << ", \"throughput_qps\": " << result.throughput
+			<< ", \"avg_expanded\": " << result.averageExpandedNodes << ", \"expansions_per_s\": " << result.expansionsPerSecond
+			<< ", \"avg_generated\": " << result.averageGeneratedNodes
+			<< ", \"avg_reopened\": " << result.averageReopenedNodes << ", \"avg_heap_pushes\": " << result.averageHeapPushes
+			<< ", \"avg_heap_pops\": " << result.averageHeapPops << ", \"avg_decrease_keys\": " << result.averageDecreaseKeys
+			<< ", \"avg_peak_open\": " << result.averagePeakOpenListSize << ", \"avg_jump_steps\": " << result.averageJumpSteps
+			<< ", \"avg_search_us\": " << result.averageSearchTime << ", \"avg_reconstruction_us\": " << result.averageReconstructionTime
+			<< ", \"avg_path_cost\": " << result.averagePathCost
+			<< ", \"avg_cost_ratio\": " << result.averageCostRatio << ", \"precompute_ms\": " << result.precomputeTime
+			<< ", \"precompute_bytes\": " << result.precomputeMemory << ", \"scratch_bytes\": " << result.scratchMemory
+			<< ", \"allocating_searches\": " << result.nrOfAllocatingSearches << ", \"heap_allocations\": " << result.nrOfHeapAllocations
+			<< ", \"peak_process_bytes\": " << result.peakProcessMemory << " }" << (i + 1 < m_Results.size() ? "," : "") << '\n';
+	}
+	stream << "  ]\n}\n";
+}
+
+size_t PathfindingBenchmark::GetPeakProcessMemory()
+{
+#ifdef _WIN32
+	PROCESS_MEMORY_COUNTERS counters{};
+	if (!GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+		return 0;
+	return counters.PeakWorkingSetSize;
+#else
+	//kilobytes on Linux
+	rusage usage{};
+	if (getrusage(RUSAGE_SELF, &usage) != 0)
+		return 0;
+	return size_t(usage.ru_maxrss) * 1024;
+#endif
+}
@@ -0,0 +1,158 @@
+#pragma once
+
+#include "framework/EliteAI/EliteGraphs/EGridGraph.h"
+#include "framework/EliteAI/EliteGraphs/EImplicitGridGraph.h"
+#include "framework/EliteAI/EliteGraphs/EliteGraphUtilities/ECompressedGraph.h"
+#include "framework/EliteAI/EliteGraphs/EliteGraphUtilities/EGridMapFile.h"
+#include "framework/EliteAI/EliteGraphs/EliteGraphUtilities/EMovingAIMap.h"
+#include "framework/EliteAI/EliteGraphs/EliteGraphUtilities/EScenarioRunner.h"
+#include "framework/EliteAI/EliteGraphs/EliteGraphUtilities/ESearchContext.h"
+
+// settings of a benchmark run, filled in from the command line
+struct BenchmarkOptions
+{
+	// pathfinders measures every pathfinder on the queries,
+	// buckets replays the scenarios of a .scen file per bucket and fails when A* or JPS misses an optimal cost
+	// openlist measures AStar against AStar with the sorted vector open list it used to have, fails when their path costs differ
+	// lookups measures JPS and AStar on the connection lists with and without the direction slots of GridGraph, fails when their path costs differ
+	// adjacency walks every connection through the lists and through CompressedGraph and prints connections/s and bytes per connection,
+	// then measures AStar on both, fails when they see different connections or their path costs differ
+	// pruning checks JPSNeighborTable against the cost based pruning it replaced on seeded random grids and the queries, fails on any difference
+	std::string mode = "pathfinders";
+
+	// a Moving AI .map or a GridMapFile, when both are empty a random map gets generated
+	std::string movingAIMapPath;
+	std::string gridMapPath;
+	// replaces the random queries by the queries of a Moving AI .scen file
+	std::string scenarioPath;
+
+	int nrOfColumns = 512;
+	int nrOfRows = 512;
+	float obstacleRatio = 0.2f;
+	float mudRatio = 0.f;
+	unsigned int seed = 1;
+
+	int nrOfQueries = 1000;
+	int nrOfWarmUpQueries = 50;
+
+	bool writeJson = false;
+	// empty writes to the standard output
+	std::string outputPath;
+};
+
+// one pathfinder with one heuristic on one graph, over all queries
+struct BenchmarkResult
+{
+	std::string algorithm;
+	std::string heuristic;
+	std::string graph; // lists (GridGraph), lists_scan (GridGraph without its direction slots), csr (CompressedGraph) or implicit (ImplicitGridGraph)
+	std::string querySet; // all, long for the longest tenth of the queries, goals_<n> for queries with n destinations
+
+	int nrOfQueries = 0;
+	int nrOfSolved = 0;
+	double minTime = 0.0; // microseconds
+	double medianTime = 0.0;
+	double p99Time = 0.0;
+	double meanTime = 0.0;
+	double throughput = 0.0; // queries per second
+	double averageExpandedNodes = 0.0;
+	double expansionsPerSecond = 0.0;
+	// averages of the SearchStats of the queries
+	double averageGeneratedNodes = 0.0;
+	double averageReopenedNodes = 0.0;
+	double averageHeapPushes = 0.0;
+	double averageHeapPops = 0.0;
+	double averageDecreaseKeys = 0.0;
+	double averagePeakOpenListSize = 0.0;
+	double averageJumpSteps = 0.0;
+	double averageSearchTime = 0.0; // microseconds
+	double averageReconstructionTime = 0.0; // microseconds
+	double averagePathCost = 0.0;
+	double averageCostRatio = 0.0; // path cost / optimal cost, 0 when the queries have no optimal cost
+
+	double precomputeTime = 0.0; // milliseconds spent building what the pathfinder needs next to the graph
+	size_t precomputeMemory = 0; // bytes of it
+	size_t scratchMemory = 0; // bytes of the search context after all queries
+	// after the warm-up: searches that grew a buffer of the context, and heap allocations of all searches together
+	int nrOfAllocatingSearches = 0;
+	long long nrOfHeapAllocations = 0;
+	size_t peakProcessMemory = 0; // bytes, the peak of the whole process so far
+};
+
+class PathfindingBenchmark final
+{
+public:
+	using NodeType = Elite::GridTerrainNode;
+	using ConnectionType = Elite::GraphConnection;
+	using GraphType = Elite::GridGraph<NodeType, ConnectionType>;
+
+	explicit PathfindingBenchmark(const BenchmarkOptions& options);
+	~PathfindingBenchmark();
+
+	// returns false when the map or the scenarios can't be loaded
+	bool Initialize();
+	// returns false when a check of the mode fails, the results are still there to write
+	bool Run();
+	// writes CSV or JSON, depending on the options, the buckets mode writes a table per pathfinder
+	bool WriteResults() const;
+
+	PathfindingBenchmark(const PathfindingBenchmark&) = delete;
+	PathfindingBenchmark& operator=(const PathfindingBenchmark&) = delete;
+
+private:
+	struct Query
+	{
+		int startIdx;
+		int goalIdx;
+		double optimalCost; // 0 when unknown
+	};
+
+	bool LoadMap();
+	void GenerateMap();
+	bool LoadQueries();
+	void GenerateQueries();
+	void RunPathfinders();
+	bool RunScenarioBuckets();
+	bool RunOpenListComparison();
+	bool RunConnectionLookupComparison();
+	bool RunAdjacencyComparison();
+	bool RunPruningCheck();
+	bool HaveSamePathCosts(const BenchmarkResult& result, const BenchmarkResult& otherResult) const;
+	void RunLongQueries();
+	void RunMultiGoalQueries(int nrOfDestinations);
+
+	template<class T_HeuristicPolicy>
+	void RunHeuristic(const std::string& heuristicName, T_HeuristicPolicy heuristic = T_HeuristicPolicy{});
+	template<class T_FindPath>
+	void Measure(const std::string& algorithm, const std::string& heuristic, const std::string& graph, T_FindPath findPath,
+		double precomputeTime = 0.0, size_t precomputeMemory = 0);
+	template<class T_Pathfinder, class T_Adjacency>
+	bool MeasureBuckets(const std::string& name, T_Pathfinder& pathfinder, const T_Adjacency& adjacency, bool isOptimal);
+
+	void Write(std::ostream& stream) const;
+	void WriteCsv(std::ostream& stream) const;
+	void WriteJson(std::ostream& stream) const;
+
+	static size_t GetPeakProcessMemory();
+
+	BenchmarkOptions m_Options;
+	GraphType* m_pGraph = nullptr;
+	Elite::CompressedGraph m_CompressedGraph;
+	double m_CompressedGraphBuildTime = 0.0;
+	// stays open for a --gridmap, the implicit graph searches the mapped terrain of it
+	Elite::GridMapFile m_GridMapFile;
+	std::unique_ptr<Elite::ImplicitGridGraph> m_pImplicitGraph;
+	double m_ImplicitGraphBuildTime = 0.0;
+	double m_GraphBuildTime = 0.0;
+
+	std::vector<Query> m_Queries;
+	// the scenarios the queries came from, in bucket order
+	std::vector<Elite::MovingAIScenario> m_Scenarios;
+	// written into the results Measure adds
+	std::string m_QuerySetName = "all";
+	// the position in m_Queries of the query Measure is running, for pathfinders that need more than a start and a goal
+	size_t m_QueryNr = 0;
+	std::vector<BenchmarkResult> m_Results;
+	// filled by the buckets mode instead of m_Results
+	std::vector<std::pair<std::string, std::vector<Elite::ScenarioBucketResult>>> m_BucketResults;
+};
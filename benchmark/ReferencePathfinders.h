@@ -0,0 +1,389 @@
+#pragma once
+
+#include "framework/EliteAI/EliteGraphs/EGridGraph.h"
+#include "framework/EliteAI/EliteGraphs/EliteGraphUtilities/EGridDirections.h"
+#include "framework/EliteAI/EliteGraphs/EliteGraphUtilities/EGridPath.h"
+#include "framework/EliteAI/EliteGraphs/EliteGraphUtilities/ESearchContext.h"
+
+// the ways the framework used to search, kept here to measure and check the current pathfinders against
+
+/// <summary>
+/// A copy of a GridGraph that looks its connections up by scanning the connection list of the cell, like before the direction slots
+/// </summary>
+template<class T_NodeType, class T_ConnectionType>
+class ListScanGridGraph final : public Elite::GridGraph<T_NodeType, T_ConnectionType>
+{
+public:
+	explicit ListScanGridGraph(const Elite::GridGraph<T_NodeType, T_ConnectionType>& other) : Elite::GridGraph<T_NodeType, T_ConnectionType>(other) {}
+
+	virtual T_ConnectionType* GetConnection(int from, int to) const override { return Elite::IGraph<T_NodeType, T_ConnectionType>::GetConnection(from, to); }
+
+protected:
+	virtual bool IsUniqueConnection(int from, int to) const override { return Elite::IGraph<T_NodeType, T_ConnectionType>::IsUniqueConnection(from, to); }
+};
+
+/// <summary>
+/// AStar with the open list it had before IndexedPriorityQueue: a vector that gets sorted every iteration, its front erased
+/// and scanned from the start to find a neighbor that is already on it
+/// the node states of the context are the closed list, like in AStar, so only the open list differs
+/// </summary>
+/// <typeparam name="T_Adjacency">GraphAdjacency, CompressedGraph or ImplicitGridGraph of a grid</typeparam>
+template<class T_Adjacency, class T_HeuristicPolicy>
+class SortedOpenListAStar final
+{
+public:
+	// the adjacency has to outlive the pathfinder
+	SortedOpenListAStar(const T_Adjacency& adjacency, int nrOfColumns) : m_Adjacency{ adjacency }, m_NrOfColumns{ nrOfColumns } {}
+
+	bool FindPath(int startIdx, int destinationIdx, Elite::SearchContext& context);
+
+private:
+	struct OpenRecord
+	{
+		int idx;
+		float estimatedTotalCost;
+
+		bool operator<(const OpenRecord& other) const { return estimatedTotalCost < other.estimatedTotalCost; }
+	};
+
+	float GetHeuristicCost(int fromIdx, int toIdx) const
+	{
+		return m_Heuristic(abs(toIdx % m_NrOfColumns - fromIdx % m_NrOfColumns), abs(toIdx / m_NrOfColumns - fromIdx / m_NrOfColumns));
+	}
+
+	const T_Adjacency& m_Adjacency;
+	int m_NrOfColumns;
+	T_HeuristicPolicy m_Heuristic{};
+	std::vector<OpenRecord> m_OpenList;
+};
+
+/// <summary>
+/// find a path from 2 given node indices, the path ends up in context.GetPath()
+/// </summary>
+/// <returns>true if the destination was reached, the path is empty otherwise</returns>
+template<class T_Adjacency, class T_HeuristicPolicy>
+inline bool SortedOpenListAStar<T_Adjacency, T_HeuristicPolicy>::FindPath(int startIdx, int destinationIdx, Elite::SearchContext& context)
+{
+	using namespace Elite;
+
+	bool foundPath{ false };
+	context.BeginSearch(m_Adjacency.GetNrOfNodes());
+	SearchStateTable& nodeStates = context.GetNodeStates();
+	m_OpenList.clear();
+
+	SearchNodeState& startState = nodeStates.Visit(startIdx);
+	startState.estimatedTotalCost = GetHeuristicCost(startIdx, destinationIdx);
+	startState.status = SearchNodeStatus::Open;
+	m_OpenList.push_back(OpenRecord{ startIdx, startState.estimatedTotalCost });
+
+	while (!m_OpenList.empty())
+	{
+		//sort the openlist by estimated total cost, then take the first one (lowest cost)
+		std::sort(m_OpenList.begin(), m_OpenList.end());
+		const int currentIdx{ m_OpenList.front().idx };
+		m_OpenList.erase(m_OpenList.begin());
+		if (currentIdx == destinationIdx)
+		{
+			foundPath = true;
+			break;
+		}
+		context.CountExpandedNode();
+
+		SearchNodeState& currentState = nodeStates.GetState(currentIdx);
+		m_Adjacency.ForEachConnection(currentIdx, [&](int neighborIdx, float connectionCost)
+		{
+			const float costSoFar{ currentState.costSoFar + connectionCost };
+			bool isOnOpenList{ false };
+			if (nodeStates.IsVisited(neighborIdx))
+			{
+				const SearchNodeState& neighborState = nodeStates.GetState(neighborIdx);
+				if (neighborState.costSoFar <= costSoFar)
+					return true;
+				isOnOpenList = neighborState.status == SearchNodeStatus::Open;
+			}
+
+			SearchNodeState& neighborState = nodeStates.Visit(neighborIdx);
+			neighborState.costSoFar = costSoFar;
+			neighborState.estimatedTotalCost = costSoFar + GetHeuristicCost(neighborIdx, destinationIdx);
+			neighborState.parentIdx = currentIdx;
+			neighborState.status = SearchNodeStatus::Open;
+			context.CountGeneratedNode();
+
+			//find the neighbor in the open list to lower its cost, add it when it isn't on it
+			if (isOnOpenList)
+			{
+				for (OpenRecord& record : m_OpenList)
+				{
+					if (record.idx == neighborIdx)
+					{
+						record.estimatedTotalCost = neighborState.estimatedTotalCost;
+						break;
+					}
+				}
+			}
+			else
+				m_OpenList.push_back(OpenRecord{ neighborIdx, neighborState.estimatedTotalCost });
+			return true;
+		});
+		currentState.status = SearchNodeStatus::Closed;
+	}
+	context.BeginReconstruction();
+
+	std::vector<int>& finalPath = context.GetPath();
+	if (foundPath)
+	{
+		for (int currentIdx = destinationIdx; currentIdx != invalid_node_index; currentIdx = nodeStates.GetState(currentIdx).parentIdx)
+			finalPath.push_back(currentIdx);
+		std::reverse(finalPath.begin(), finalPath.end());
+	}
+
+	context.EndSearch();
+	return foundPath;
+}
+
+/// <summary>
+/// JPS that prunes by the cost based definition the old PruneNeighbors implemented instead of JPSNeighborTable:
+/// a neighbor of a cell is worth going to when the cheapest route from the previous cell through the 3x3 around the cell,
+/// without the cell itself, costs more (diagonal moves) or at least as much (straight moves) as the route through the cell
+/// a cell has a forced neighbor when that keeps a direction the move doesn't naturally continue in
+/// the routes use the connections of the graph, so the corner cutting rules of the graph come along by themselves
+/// </summary>
+/// <typeparam name="T_Adjacency">GraphAdjacency, CompressedGraph or ImplicitGridGraph of a grid</typeparam>
+template<class T_Adjacency, class T_HeuristicPolicy>
+class CostPruningJPS final
+{
+public:
+	// the adjacency has to outlive the pathfinder
+	CostPruningJPS(const T_Adjacency& adjacency, int nrOfColumns, int nrOfRows, float costStraight, float costDiagonal)
+		: m_Adjacency{ adjacency }, m_NrOfColumns{ nrOfColumns }, m_NrOfRows{ nrOfRows }, m_CostStraight{ costStraight }, m_CostDiagonal{ costDiagonal } {}
+
+	// every cell of the path ends up in context.GetPath(), it is empty when the destination can't be reached
+	bool FindPath(int startIdx, int destinationIdx, Elite::SearchContext& context);
+
+	// the directions (bit i is direction i of GridDirections) worth going in after reaching a cell in a direction
+	unsigned int GetDirectionsToExplore(int idx, int direction) const;
+	// the directions the cell has a connection in
+	unsigned int GetWalkableDirections(int idx) const;
+
+private:
+	int Jump(int idx, int direction, int destinationIdx, float& costSoFar) const;
+	bool HasDefaultCosts(int idx) const;
+	int GetNeighbor(int idx, int direction) const;
+	float GetHeuristicCost(int fromIdx, int toIdx) const
+	{
+		return m_Heuristic(abs(toIdx % m_NrOfColumns - fromIdx % m_NrOfColumns), abs(toIdx / m_NrOfColumns - fromIdx / m_NrOfColumns));
+	}
+
+	const T_Adjacency& m_Adjacency;
+	int m_NrOfColumns;
+	int m_NrOfRows;
+	float m_CostStraight;
+	float m_CostDiagonal;
+	T_HeuristicPolicy m_Heuristic{};
+};
+
+template<class T_Adjacency, class T_HeuristicPolicy>
+inline bool CostPruningJPS<T_Adjacency, T_HeuristicPolicy>::FindPath(int startIdx, int destinationIdx, Elite::SearchContext& context)
+{
+	using namespace Elite;
+
+	bool foundPath{ false };
+	context.BeginSearch(m_Adjacency.GetNrOfNodes());
+	IndexedPriorityQueue<float>& openList = context.GetOpenList();
+	SearchStateTable& nodeStates = context.GetNodeStates();
+
+	SearchNodeState& startState = nodeStates.Visit(startIdx);
+	startState.estimatedTotalCost = GetHeuristicCost(startIdx, destinationIdx);
+	startState.status = SearchNodeStatus::Open;
+	openList.Push(startIdx, startState.estimatedTotalCost);
+
+	while (!openList.IsEmpty())
+	{
+		const int currentIdx{ openList.Pop() };
+		if (currentIdx == destinationIdx)
+		{
+			foundPath = true;
+			break;
+		}
+		context.CountExpandedNode();
+
+		//the start and cells next to other terrain go everywhere, like in JPS
+		SearchNodeState& currentState = nodeStates.GetState(currentIdx);
+		unsigned int directions{ GetWalkableDirections(currentIdx) };
+		if (currentState.parentIdx != invalid_node_index && HasDefaultCosts(currentIdx))
+		{
+			const int deltaCol{ currentIdx % m_NrOfColumns - currentState.parentIdx % m_NrOfColumns };
+			const int deltaRow{ currentIdx / m_NrOfColumns - currentState.parentIdx / m_NrOfColumns };
+			directions = GetDirectionsToExplore(currentIdx, GridDirections::GetDirection((deltaCol > 0) - (deltaCol < 0), (deltaRow > 0) - (deltaRow < 0)));
+		}
+
+		for (int direction = 0; direction < GridDirections::nr_of_directions; ++direction)
+		{
+			if ((directions & (1u << direction)) == 0)
+				continue;
+
+			float costSoFar{ currentState.costSoFar };
+			const int successorIdx{ Jump(currentIdx, direction, destinationIdx, costSoFar) };
+			if (successorIdx == invalid_node_index)
+				continue;
+
+			bool isOnOpenList{ false };
+			if (nodeStates.IsVisited(successorIdx))
+			{
+				const SearchNodeState& successorState = nodeStates.GetState(successorIdx);
+				if (successorState.costSoFar <= costSoFar)
+					continue;
+				isOnOpenList = successorState.status == SearchNodeStatus::Open;
+			}
+
+			SearchNodeState& successorState = nodeStates.Visit(successorIdx);
+			successorState.costSoFar = costSoFar;
+			successorState.estimatedTotalCost = costSoFar + GetHeuristicCost(successorIdx, destinationIdx);
+			successorState.parentIdx = currentIdx;
+			successorState.status = SearchNodeStatus::Open;
+			if (isOnOpenList)
+				openList.DecreaseKey(successorIdx, successorState.estimatedTotalCost);
+			else
+				openList.Push(successorIdx, successorState.estimatedTotalCost);
+			context.CountGeneratedNode();
+		}
+		currentState.status = SearchNodeStatus::Closed;
+	}
+	context.BeginReconstruction();
+
+	std::vector<int>& finalPath = context.GetPath();
+	if (foundPath)
+	{
+		for (int currentIdx = destinationIdx; currentIdx != invalid_node_index; currentIdx = nodeStates.GetState(currentIdx).parentIdx)
+			finalPath.push_back(currentIdx);
+		std::reverse(finalPath.begin(), finalPath.end());
+		ExpandGridPath(finalPath, m_NrOfColumns);
+	}
+
+	context.EndSearch();
+	return foundPath;
+}
+
+/// <summary>
+/// Compare the route through a cell with the cheapest route around it, from the cell before it, for every neighbor
+/// </summary>
+/// <param name="direction">The direction the cell was reached in, the cell before it has to be connected to it</param>
+template<class T_Adjacency, class T_HeuristicPolicy>
+inline unsigned int CostPruningJPS<T_Adjacency, T_HeuristicPolicy>::GetDirectionsToExplore(int idx, int direction) const
+{
+	using namespace Elite;
+
+	const unsigned int walkableDirections{ GetWalkableDirections(idx) };
+	const int parentDirection{ GridDirections::Rotate(direction, GridDirections::nr_of_directions / 2) };
+	const int parentIdx{ GetNeighbor(idx, parentDirection) };
+
+	//the cheapest route from the cell before to every neighbor, only over the other neighbors, 8 cells are few enough to relax them all a few times
+	float costs[GridDirections::nr_of_directions];
+	for (float& cost : costs)
+		cost = FLT_MAX;
+	costs[parentDirection] = 0.f;
+	for (int round = 0; round < GridDirections::nr_of_directions; ++round)
+	{
+		for (int from = 0; from < GridDirections::nr_of_directions; ++from)
+		{
+			if ((walkableDirections & (1u << from)) == 0 || costs[from] == FLT_MAX)
+				continue;
+			for (int to = 0; to < GridDirections::nr_of_directions; ++to)
+			{
+				float connectionCost{};
+				if (to != from && (walkableDirections & (1u << to)) != 0
+					&& m_Adjacency.TryGetConnectionCost(GetNeighbor(idx, from), GetNeighbor(idx, to), connectionCost))
+					costs[to] = std::min(costs[to], costs[from] + connectionCost);
+			}
+		}
+	}
+
+	float parentCost{};
+	m_Adjacency.TryGetConnectionCost(parentIdx, idx, parentCost);
+	unsigned int directions{ 0 };
+	for (int neighborDirection = 0; neighborDirection < GridDirections::nr_of_directions; ++neighborDirection)
+	{
+		if ((walkableDirections & (1u << neighborDirection)) == 0 || neighborDirection == parentDirection)
+			continue;
+
+		//the costs are sums of a few default costs, the small margin keeps equal routes equal
+		float neighborCost{};
+		m_Adjacency.TryGetConnectionCost(idx, GetNeighbor(idx, neighborDirection), neighborCost);
+		const float costThroughCell{ parentCost + neighborCost };
+		const bool isPruned{ GridDirections::IsDiagonal(direction) ? costs[neighborDirection] < costThroughCell - 0.0001f
+			: costs[neighborDirection] <= costThroughCell + 0.0001f };
+		if (!isPruned)
+			directions |= 1u << neighborDirection;
+	}
+	return directions;
+}
+
+/// <summary>
+/// Step in a direction until a cell with a forced neighbor, other terrain around it or the destination,
+/// a diagonal also stops where a straight jump along one of its components finds such a cell
+/// </summary>
+/// <returns>The cell it stopped at, invalid_node_index when it ran into something</returns>
+template<class T_Adjacency, class T_HeuristicPolicy>
+inline int CostPruningJPS<T_Adjacency, T_HeuristicPolicy>::Jump(int idx, int direction, int destinationIdx, float& costSoFar) const
+{
+	using namespace Elite;
+
+	unsigned int naturalDirections{ 1u << direction };
+	if (GridDirections::IsDiagonal(direction))
+		naturalDirections |= (1u << GridDirections::Rotate(direction, -1)) | (1u << GridDirections::Rotate(direction, 1));
+
+	float cost{ costSoFar };
+	for (;;)
+	{
+		const int nextIdx{ GetNeighbor(idx, direction) };
+		float stepCost{};
+		if (nextIdx == invalid_node_index || !m_Adjacency.TryGetConnectionCost(idx, nextIdx, stepCost))
+			return invalid_node_index;
+		cost += stepCost;
+		idx = nextIdx;
+
+		if (idx == destinationIdx || !HasDefaultCosts(idx) || (GetDirectionsToExplore(idx, direction) & ~naturalDirections) != 0)
+			break;
+
+		float straightCost{ 0.f };
+		if (GridDirections::IsDiagonal(direction)
+			&& (Jump(idx, GridDirections::Rotate(direction, -1), destinationIdx, straightCost) != invalid_node_index
+				|| Jump(idx, GridDirections::Rotate(direction, 1), destinationIdx, straightCost) != invalid_node_index))
+			break;
+	}
+	costSoFar = cost;
+	return idx;
+}
+
+template<class T_Adjacency, class T_HeuristicPolicy>
+inline unsigned int CostPruningJPS<T_Adjacency, T_HeuristicPolicy>::GetWalkableDirections(int idx) const
+{
+	unsigned int walkableDirections{ 0 };
+	m_Adjacency.ForEachConnection(idx, [&](int neighborIdx, float)
+	{
+		walkableDirections |= 1u << Elite::GridDirections::GetDirection(neighborIdx % m_NrOfColumns - idx % m_NrOfColumns, neighborIdx / m_NrOfColumns - idx / m_NrOfColumns);
+		return true;
+	});
+	return walkableDirections;
+}
+
+template<class T_Adjacency, class T_HeuristicPolicy>
+inline bool CostPruningJPS<T_Adjacency, T_HeuristicPolicy>::HasDefaultCosts(int idx) const
+{
+	return m_Adjacency.ForEachConnection(idx, [&](int neighborIdx, float cost)
+	{
+		const bool isStraight{ neighborIdx % m_NrOfColumns == idx % m_NrOfColumns || neighborIdx / m_NrOfColumns == idx / m_NrOfColumns };
+		return cost == (isStraight ? m_CostStraight : m_CostDiagonal);
+	});
+}
+
+/// <returns>The cell next to a cell in a direction, invalid_node_index outside the grid</returns>
+template<class T_Adjacency, class T_HeuristicPolicy>
+inline int CostPruningJPS<T_Adjacency, T_HeuristicPolicy>::GetNeighbor(int idx, int direction) const
+{
+	const int col{ idx % m_NrOfColumns + Elite::GridDirections::GetDeltaCol(direction) };
+	const int row{ idx / m_NrOfColumns + Elite::GridDirections::GetDeltaRow(direction) };
+	if (col < 0 || col >= m_NrOfColumns || row < 0 || row >= m_NrOfRows)
+		return invalid_node_index;
+	return row * m_NrOfColumns + col;
+}
@@ -0,0 +1,123 @@
+//Precompiled Header [ALWAYS ON TOP IN CPP]
+#include "stdafx.h"
+
+//-----------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------
+#include "PathfindingBenchmark.h"
+
+namespace
+{
+	void PrintUsage()
+	{
+		std::cerr << "usage: GPP_Benchmark [options]\n"
+			"  --mode <name>           what to run (default pathfinders)\n"
+			"  --map <file.map>        Moving AI map to search\n"
+			"  --gridmap <file>        grid map written by GridMapFile\n"
+			"  --scen <file.scen>      Moving AI scenarios to use as queries, with their optimal costs\n"
+			"  --size <columns> <rows> size of the generated map (default 512 512)\n"
+			"  --obstacles <ratio>     water cells of the generated map (default 0.2)\n"
+			"  --mud <ratio>           mud cells of the generated map (default 0)\n"
+			"  --seed <number>         seed of the generated map and queries (default 1)\n"
+			"  --queries <n>           random queries per pathfinder (default 1000)\n"
+			"  --warmup <n>            queries before the measured ones (default 50)\n"
+			"  --json                  write JSON instead of CSV\n"
+			"  --out <file>            write the results to a file instead of the standard output\n"
+			"modes:\n"
+			"  pathfinders             every pathfinder on every graph, one CSV or JSON row each\n"
+			"  buckets                 BFS, A* and JPS per bucket of the --scen scenarios, one table each,\n"
+			"                          fails when A* or JPS doesn't find the optimal cost of every scenario\n"
+			"  openlist                A* against A* with the sorted vector open list it used to have, compare expansions_per_s,\n"
+			"                          fails when their paths cost differently\n"
+			"  lookups                 JPS and A* on a copy of the graph that scans its connection lists (lists_scan)\n"
+			"                          and on the graph with its direction slots (lists), fails when their paths cost differently\n"
+			"  adjacency               ForEachConnection over every node on the connection lists and on the csr copy,\n"
+			"                          prints connections/s and bytes per connection of both and measures A* on both\n"
+			"  pruning                 JPS pruning against the cost based pruning it replaced, on seeded random grids\n"
+			"                          and on the queries, fails on any difference\n";
+	}
+
+	// returns false on an unknown option or a missing value
+	bool ParseOptions(int argc, char* argv[], BenchmarkOptions& options)
+	{
+		for (int i = 1; i < argc; ++i)
+		{
+			const std::string option{ argv[i] };
+			const int nrOfValues{ argc - i - 1 };
+			if (option == "--json")
+				options.writeJson = true;
+			else if (option == "--size" && nrOfValues >= 2)
+			{
+				options.nrOfColumns = stoi(string(argv[++i]));
+				options.nrOfRows = stoi(string(argv[++i]));
+			}
+			else if (nrOfValues < 1)
+				return false;
+			else if (option == "--mode")
+				options.mode = argv[++i];
+			else if (option == "--map")
+				options.movingAIMapPath = argv[++i];
+			else if (option == "--gridmap")
+				options.gridMapPath = argv[++i];
+			else if (option == "--scen")
+				options.scenarioPath = argv[++i];
+			else if (option == "--obstacles")
+				options.obstacleRatio = stof(string(argv[++i]));
+			else if (option == "--mud")
+				options.mudRatio = stof(string(argv[++i]));
+			else if (option == "--seed")
+				options.seed = unsigned(stoul(string(argv[++i])));
+			else if (option == "--queries")
+				options.nrOfQueries = stoi(string(argv[++i]));
+			else if (option == "--warmup")
+				options.nrOfWarmUpQueries = stoi(string(argv[++i]));
+			else if (option == "--out")
+				options.outputPath = argv[++i];
+			else
+				return false;
+		}
+		const bool isValidMode{ options.mode == "pathfinders" || options.mode == "openlist" || options.mode == "lookups"
+			|| options.mode == "adjacency" || options.mode == "pruning" || (options.mode == "buckets" && !options.scenarioPath.empty()) };
+		return isValidMode && options.nrOfColumns > 0 && options.nrOfRows > 0 && options.nrOfQueries > 0 && options.nrOfWarmUpQueries >= 0;
+	}
+}
+
+//Main
+int main(int argc, char* argv[])
+{
+	BenchmarkOptions options{};
+	try
+	{
+		if (!ParseOptions(argc, argv, options))
+		{
+			PrintUsage();
+			return 1;
+		}
+	}
+	catch (const std::exception&)
+	{
+		//stoi and friends throw on values that aren't numbers
+		PrintUsage();
+		return 1;
+	}
+
+	PathfindingBenchmark benchmark{ options };
+	if (!benchmark.Initialize())
+	{
+		std::cerr << "could not load the map or find queries on it\n";
+		return 1;
+	}
+
+	const bool passed{ benchmark.Run() };
+	if (!benchmark.WriteResults())
+	{
+		std::cerr << "could not write the results\n";
+		return 1;
+	}
+	if (!passed)
+	{
+		std::cerr << "the checks of the " << options.mode << " mode failed\n";
+		return 1;
+	}
+	return 0;
+}
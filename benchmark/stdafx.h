@@ -0,0 +1,41 @@
+/*=============================================================================*/
+// stdafx.h: Stand-in for the precompiled header of the framework for the headless benchmark.
+// Only includes the standard library and what the EliteAI graphs and pathfinders need,
+// no SDL, OpenGL, ImGui or Box2D, so the benchmark runs without a display.
+// The framework sources compiled into the benchmark include this one instead of the root stdafx.h,
+// because the project directory comes first in the include directories.
+/*=============================================================================*/
+#pragma once
+#pragma region StandardLibraryIncludes
+#include <iostream>
+#include <chrono>
+#include <string>
+#include <sstream>
+#include <math.h>
+#include <cassert>
+#include <cfloat>
+#include <climits>
+#include <fstream>
+#include <random>
+#include <stdio.h>
+#include <vector>
+#include <list>
+#include <queue>
+#include <algorithm>
+#include <functional>
+#include <memory>
+using namespace std;
+#pragma endregion //StandardLibraryIncludes
+
+#pragma region Utilities
+#define UNREFERENCED_PARAMETER(x) (x)
+#define SAFE_DELETE(p) if (p) { delete (p); (p) = nullptr; }
+#pragma endregion //Utilities
+
+#pragma region FrameworkIncludes
+#include "framework/EliteHelpers/EMemoryPool.h"
+#include "framework/EliteMath/EMath.h"
+#include "framework/EliteRendering/ERenderingTypes.h"
+#pragma endregion //FrameworkIncludes
+
+#include "framework/EliteAI/EliteNavigation/ENavigation.h"
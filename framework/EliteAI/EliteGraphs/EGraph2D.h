@@ -136,7 +136,7 @@ namespace Elite
 			if (clickedIdx != invalid_node_index && m_SelectedNodeIdx != clickedIdx)
 			{
 				if(IsUniqueConnection(m_SelectedNodeIdx, clickedIdx))
-					AddConnection(new GraphConnection2D(m_SelectedNodeIdx, clickedIdx));
+					AddConnection(CreateConnection(m_SelectedNodeIdx, clickedIdx));
 			}
 
 			m_SelectedNodeIdx = invalid_node_index;
@@ -147,7 +147,7 @@ namespace Elite
 		}
 		else
 		{
-			AddNode(new GraphNode2D(GetNextFreeNodeIndex(), mousePos));
+			AddNode(CreateNode(GetNextFreeNodeIndex(), mousePos));
 		}
 	}
 
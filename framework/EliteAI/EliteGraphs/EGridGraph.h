@@ -9,6 +9,7 @@
 #include "EIGraph.h"
 #include "EGraphConnectionTypes.h"
 #include "EGraphNodeTypes.h"
+#include "framework/EliteAI/EliteGraphs/EliteGraphUtilities/EGridDirections.h"
 
 namespace Elite
 {
@@ -16,15 +17,26 @@ namespace Elite
 	class GridGraph : public IGraph<T_NodeType, T_ConnectionType>
 	{
 	public:
-		GridGraph(int columns, int rows, int cellSize, bool isDirectionalGraph, bool isConnectedDiagonally, float costStraight = 1.f, float costDiagonal = 1.5);
+		// without corner cutting a diagonal connection needs both cells beside it to be walkable (not water), like the Moving AI benchmarks
+		// only SetTerrainTypes keeps that up to date, IsolateNode and UnIsolateNode can only be used on a grid that allows corner cutting
+		GridGraph(int columns, int rows, int cellSize, bool isDirectionalGraph, bool isConnectedDiagonally, float costStraight = 1.f, float costDiagonal = 1.5,
+			bool isCornerCuttingAllowed = true);
+		GridGraph(const GridGraph& other);
 
 		using IGraph::GetNode;
 		T_NodeType* GetNode(int col, int row) const { return m_Nodes[GetIndex(col, row)]; }
 		const ConnectionList& GetConnections(const T_NodeType& node) const { return m_Connections[node.GetIndex()]; }
 		const ConnectionList& GetConnections(int idx) const { return m_Connections[idx]; }
+		// constant time for connections between neighboring cells, looked up in the direction slot of the from cell
+		virtual T_ConnectionType* GetConnection(int from, int to) const override;
 
 		int GetRows() const { return m_NrOfRows; }
 		int GetColumns() const { return m_NrOfColumns; }
+		float GetDefaultCostStraight() const { return m_DefaultCostStraight; }
+		float GetDefaultCostDiagonal() const { return m_DefaultCostDiagonal; }
+		int GetCellSize() const { return m_CellSize; }
+		bool IsConnectedDiagonally() const { return m_IsConnectedDiagionally; }
+		bool IsCornerCuttingAllowed() const { return m_IsCornerCuttingAllowed; }
 
 		bool IsWithinBounds(int col, int row) const;
 		int GetIndex(int col, int row) const { return row * m_NrOfColumns + col; }
@@ -40,7 +52,31 @@ namespace Elite
 
 		int GetNodeFromWorldPos(Vector2 pos = ZeroVector2) const;
 
+		// only the neighboring cells can have a connection to a cell of the grid, so only their lists are touched
+		// connections added by hand between cells that aren't neighbors are left alone
+		// without corner cutting the diagonals that pass the node would stay, use SetTerrainTypes there
+		virtual void IsolateNode(int idx) override;
+		// isolates the node and connects it to its neighbors again, in both directions
 		void UnIsolateNode(int idx);
+
+		// Terrain editing (GridTerrainNode only)
+		// all cells get their new terrain first, then the connections around the cells that really changed are rebuilt in one pass
+		// and the terrain changed callback gets called once with those cells, without corner cutting followed by the cells
+		// whose diagonal connections appeared or disappeared with them
+		using TerrainChangedCallback = std::function<void(const std::vector<int>& changedNodes)>;
+		void SetTerrainTypes(const std::vector<int>& nodeIndices, TerrainType terrain);
+		// a rectangle of cells, the part outside the grid is ignored
+		void SetTerrainTypes(int col, int row, int nrOfColumns, int nrOfRows, TerrainType terrain);
+		// one terrain type for every cell, in node index order (an imported mask)
+		void SetTerrainTypes(const std::vector<TerrainType>& terrainTypes);
+		// lets copies of the grid (compressed graph, jump point tables ...) follow the terrain edits
+		void SetTerrainChangedCallback(const TerrainChangedCallback& callback) { m_TerrainChangedCallback = callback; }
+
+	protected:
+		virtual bool IsUniqueConnection(int from, int to) const override { return GetConnection(from, to) == nullptr; }
+		virtual void OnConnectionAdded(T_ConnectionType* pConnection) override;
+		virtual void OnConnectionRemoved(T_ConnectionType* pConnection) override;
+
 	private:
 		
 		int m_NrOfColumns;
@@ -48,17 +84,37 @@ namespace Elite
 		int m_CellSize;
 
 		bool m_IsConnectedDiagionally;
+		bool m_IsCornerCuttingAllowed;
 		const float m_DefaultCostStraight;
 		const float m_DefaultCostDiagonal;
 
 		const vector<Vector2> m_StraightDirections = { { 1, 0 }, { 0, 1 }, { -1, 0 }, { 0, -1 } };
 		const vector<Vector2> m_DiagonalDirections = { { 1, 1 }, { -1, 1 }, { -1, -1 }, { 1, -1 } };
 
+		// the connection from every cell in each of the GridDirections, at idx * nr_of_directions + direction
+		// nullptr when there is none, the lists stay the storage that gets iterated
+		vector<T_ConnectionType*> m_ConnectionSlots;
+
+		// cells whose terrain changed during the current terrain edit
+		vector<int> m_ChangedNodes;
+		TerrainChangedCallback m_TerrainChangedCallback;
+
 		// graph creation helper functions
 		void AddConnectionsToAdjacentCells(int idx, int col, int row);
-		void AddConnectionsInDirections(int idx, int col, int row, vector<Vector2> directions);
+		void AddConnectionsInDirections(int idx, int col, int row, const vector<Vector2>& directions);
+		void AddConnectionToNeighbor(int idx, int neighborIdx);
+		void AddConnectionsToNeighbors(int idx);
+		// IsolateNode without the check, the terrain edits update the diagonals around the node themselves
+		void DisconnectNode(int idx);
+		bool IsCuttingCorner(int idx, int neighborIdx) const;
+		void UpdateDiagonalsAround(int idx);
+
+		void ChangeTerrainType(int idx, TerrainType terrain);
+		void RebuildChangedConnections();
 
 		float GetConnectionCost(int fromIdx, int toIdx) const;
+		// returns GridDirections::invalid_direction when the cells aren't neighbors
+		int GetSlotIndex(int fromIdx, int toIdx) const;
 		//void AddCheckedConnection(int idx, int neighborCol, int neighborRow, float cost);
 
 	
@@ -73,22 +129,31 @@ namespace Elite
 		bool isDirectionalGraph, 
 		bool isConnectedDiagonally, 
 		float costStraight /* = 1.f*/, 
-		float costDiagonal /* = 1.5f */)
+		float costDiagonal /* = 1.5f */,
+		bool isCornerCuttingAllowed /* = true */)
 		: IGraph(isDirectionalGraph)
 		, m_NrOfColumns(columns)
 		, m_NrOfRows(rows)
 		, m_CellSize(cellSize)
 		, m_IsConnectedDiagionally(isConnectedDiagonally)
+		, m_IsCornerCuttingAllowed(isCornerCuttingAllowed)
 		, m_DefaultCostStraight(costStraight)
 		, m_DefaultCostDiagonal(costDiagonal)
+		, m_ConnectionSlots(size_t(columns) * rows * GridDirections::nr_of_directions, nullptr)
 	{
+		// Every cell gets a node and at most one connection in each direction
+		const unsigned int nrOfCells{ static_cast<unsigned int>(m_NrOfColumns * m_NrOfRows) };
+		ReserveStorage(nrOfCells, nrOfCells * (m_IsConnectedDiagionally ? 8u : 4u));
+		m_Nodes.reserve(nrOfCells);
+		m_Connections.reserve(nrOfCells);
+
 		// Create all nodes
 		for (auto r = 0; r < m_NrOfRows; ++r)
 		{
 			for (auto c = 0; c < m_NrOfColumns; ++c)
 			{
 				int idx = GetIndex(c, r);
-				AddNode(new T_NodeType(idx, Elite::Vector2(float(c), float(r))));
+				AddNode(CreateNode(idx, Elite::Vector2(float(c), float(r))));
 			}
 		}
 
@@ -103,6 +168,26 @@ namespace Elite
 		}
 	}
 
+	template<class T_NodeType, class T_ConnectionType>
+	GridGraph<T_NodeType, T_ConnectionType>::GridGraph(const GridGraph& other)
+		: IGraph(other)
+		, m_NrOfColumns(other.m_NrOfColumns)
+		, m_NrOfRows(other.m_NrOfRows)
+		, m_CellSize(other.m_CellSize)
+		, m_IsConnectedDiagionally(other.m_IsConnectedDiagionally)
+		, m_IsCornerCuttingAllowed(other.m_IsCornerCuttingAllowed)
+		, m_DefaultCostStraight(other.m_DefaultCostStraight)
+		, m_DefaultCostDiagonal(other.m_DefaultCostDiagonal)
+		, m_ConnectionSlots(other.m_ConnectionSlots.size(), nullptr)
+	{
+		// The copied connections are new objects, so the slots have to point to them instead
+		for (auto& connectionList : m_Connections)
+		{
+			for (auto pConnection : connectionList)
+				OnConnectionAdded(pConnection);
+		}
+	}
+
 	template<class T_NodeType, class T_ConnectionType>
 	bool GridGraph<T_NodeType, T_ConnectionType>::IsWithinBounds(int col, int row) const
 	{
@@ -123,45 +208,168 @@ namespace Elite
 	}
 
 	template<class T_NodeType, class T_ConnectionType>
-	void GridGraph<T_NodeType, T_ConnectionType>::UnIsolateNode(int idx)
+	void GridGraph<T_NodeType, T_ConnectionType>::IsolateNode(int idx)
 	{
-		//Isolate it to make sure it was isolated
-		IsolateNode(idx);
+		assert(m_IsCornerCuttingAllowed && "<GridGraph::IsolateNode>: the diagonals around the node don't get updated without corner cutting, use SetTerrainTypes");
+		DisconnectNode(idx);
+	}
 
-		//Add connections from this node to the neighbouring nodes
-		Vector2 rowCol = GetNodePos(idx);
-		AddConnectionsToAdjacentCells(idx, (int)rowCol.x, (int)rowCol.y);
+	template<class T_NodeType, class T_ConnectionType>
+	void GridGraph<T_NodeType, T_ConnectionType>::DisconnectNode(int idx)
+	{
+		const int col{ idx % m_NrOfColumns };
+		const int row{ idx / m_NrOfColumns };
 
-		//Add connections to the neigbouring nodes to this node
-		for (auto d : m_StraightDirections)
+		//the connection of a neighbor to this node sits in the slot of the opposite direction
+		for (int direction = 0; direction < GridDirections::nr_of_directions; ++direction)
 		{
-			int neighborCol = (int)rowCol.x + (int)d.x;
-			int neighborRow = (int)rowCol.y + (int)d.y;
-			int neighborIdx = neighborRow * m_NrOfColumns + neighborCol;
-			if (IsWithinBounds(neighborCol, neighborRow))
+			const int neighborCol{ col + GridDirections::GetDeltaCol(direction) };
+			const int neighborRow{ row + GridDirections::GetDeltaRow(direction) };
+			if (!IsWithinBounds(neighborCol, neighborRow))
+				continue;
+
+			const int neighborIdx{ GetIndex(neighborCol, neighborRow) };
+			T_ConnectionType* pConnection{ m_ConnectionSlots[neighborIdx * GridDirections::nr_of_directions + GridDirections::Rotate(direction, GridDirections::nr_of_directions / 2)] };
+			if (pConnection)
 			{
-				AddConnectionsToAdjacentCells(neighborIdx, neighborCol, neighborRow);
+				m_Connections[neighborIdx].remove(pConnection);
+				DestroyConnection(pConnection);
 			}
 		}
 
-		if (m_IsConnectedDiagionally)
+		for (auto pConnection : m_Connections[idx])
+			DestroyConnection(pConnection);
+		m_Connections[idx].clear();
+	}
+
+	template<class T_NodeType, class T_ConnectionType>
+	void GridGraph<T_NodeType, T_ConnectionType>::UnIsolateNode(int idx)
+	{
+		assert(m_IsCornerCuttingAllowed && "<GridGraph::UnIsolateNode>: the diagonals around the node don't get updated without corner cutting, use SetTerrainTypes");
+
+		//Isolate it to make sure it was isolated, this also drops the costs of the old terrain
+		DisconnectNode(idx);
+		AddConnectionsToNeighbors(idx);
+	}
+
+	template<class T_NodeType, class T_ConnectionType>
+	void GridGraph<T_NodeType, T_ConnectionType>::AddConnectionsToNeighbors(int idx)
+	{
+		//Add connections from this node to the neighbouring nodes and back, straight directions first like the constructor does
+		const int col{ idx % m_NrOfColumns };
+		const int row{ idx / m_NrOfColumns };
+		const int nrOfPasses{ m_IsConnectedDiagionally ? 2 : 1 };
+		for (int pass = 0; pass < nrOfPasses; ++pass)
 		{
-			for (auto d : m_DiagonalDirections)
+			for (int direction = pass; direction < GridDirections::nr_of_directions; direction += 2)
 			{
-				int neighborCol = (int)rowCol.x + (int)d.x;
-				int neighborRow = (int)rowCol.y + (int)d.y;
-				int neighborIdx = neighborRow * m_NrOfColumns + neighborCol;
-				if (IsWithinBounds(neighborCol, neighborRow))
-				{
-					AddConnectionsToAdjacentCells(neighborIdx, neighborCol, neighborRow);
-				}
+				const int neighborCol{ col + GridDirections::GetDeltaCol(direction) };
+				const int neighborRow{ row + GridDirections::GetDeltaRow(direction) };
+				if (!IsWithinBounds(neighborCol, neighborRow))
+					continue;
+
+				//an undirected graph adds the connection back by itself
+				const int neighborIdx{ GetIndex(neighborCol, neighborRow) };
+				AddConnectionToNeighbor(idx, neighborIdx);
+				if (m_IsDirectionalGraph)
+					AddConnectionToNeighbor(neighborIdx, idx);
 			}
 		}
+	}
+
+	/// <summary>
+	/// Give a list of cells the same terrain
+	/// </summary>
+	/// <param name="nodeIndices">The cells to change, a cell can be in it more than once</param>
+	/// <param name="terrain">Their new terrain</param>
+	template<class T_NodeType, class T_ConnectionType>
+	void GridGraph<T_NodeType, T_ConnectionType>::SetTerrainTypes(const std::vector<int>& nodeIndices, TerrainType terrain)
+	{
+		for (int idx : nodeIndices)
+			ChangeTerrainType(idx, terrain);
+
+		RebuildChangedConnections();
+	}
+
+	/// <summary>
+	/// Give a rectangle of cells the same terrain
+	/// </summary>
+	/// <param name="col">Column of the top left cell</param>
+	/// <param name="row">Row of the top left cell</param>
+	/// <param name="nrOfColumns">Width of the rectangle</param>
+	/// <param name="nrOfRows">Height of the rectangle</param>
+	/// <param name="terrain">The new terrain</param>
+	template<class T_NodeType, class T_ConnectionType>
+	void GridGraph<T_NodeType, T_ConnectionType>::SetTerrainTypes(int col, int row, int nrOfColumns, int nrOfRows, TerrainType terrain)
+	{
+		const int lastCol{ std::min(col + nrOfColumns, m_NrOfColumns) };
+		const int lastRow{ std::min(row + nrOfRows, m_NrOfRows) };
+		for (int r = std::max(row, 0); r < lastRow; ++r)
+		{
+			for (int c = std::max(col, 0); c < lastCol; ++c)
+				ChangeTerrainType(GetIndex(c, r), terrain);
+		}
+
+		RebuildChangedConnections();
+	}
+
+	/// <summary>
+	/// Give every cell of the grid its own terrain
+	/// </summary>
+	/// <param name="terrainTypes">The terrain of every cell, in node index order</param>
+	template<class T_NodeType, class T_ConnectionType>
+	void GridGraph<T_NodeType, T_ConnectionType>::SetTerrainTypes(const std::vector<TerrainType>& terrainTypes)
+	{
+		assert(terrainTypes.size() == m_Nodes.size() && "<GridGraph::SetTerrainTypes>: need one terrain type for every cell");
+		for (int idx = 0; idx < int(terrainTypes.size()); ++idx)
+			ChangeTerrainType(idx, terrainTypes[idx]);
 
+		RebuildChangedConnections();
 	}
 
 	template<class T_NodeType, class T_ConnectionType>
-	void GridGraph<T_NodeType, T_ConnectionType>::AddConnectionsInDirections(int idx, int col, int row, vector<Elite::Vector2> directions)
+	void GridGraph<T_NodeType, T_ConnectionType>::ChangeTerrainType(int idx, TerrainType terrain)
+	{
+		T_NodeType* pNode{ m_Nodes[idx] };
+		if (pNode->GetTerrainType() == terrain)
+			return;
+
+		pNode->SetTerrainType(terrain);
+		m_ChangedNodes.push_back(idx);
+	}
+
+	/// <summary>
+	/// Rebuild the connections of every cell in m_ChangedNodes, they all get isolated before any of them gets connected again
+	/// so a connection between 2 changed cells is only made once, with the cost of both new terrains
+	/// connections between unchanged cells keep their cost, it only depends on the terrain of both ends
+	/// </summary>
+	template<class T_NodeType, class T_ConnectionType>
+	void GridGraph<T_NodeType, T_ConnectionType>::RebuildChangedConnections()
+	{
+		if (m_ChangedNodes.empty())
+			return;
+
+		for (int idx : m_ChangedNodes)
+			DisconnectNode(idx);
+
+		for (int idx : m_ChangedNodes)
+			AddConnectionsToNeighbors(idx);
+
+		//without corner cutting the diagonals that pass a corner of a changed cell can appear or disappear as well
+		if (!m_IsCornerCuttingAllowed && m_IsConnectedDiagionally)
+		{
+			const size_t nrOfChangedNodes{ m_ChangedNodes.size() };
+			for (size_t i = 0; i < nrOfChangedNodes; ++i)
+				UpdateDiagonalsAround(m_ChangedNodes[i]);
+		}
+
+		if (m_TerrainChangedCallback)
+			m_TerrainChangedCallback(m_ChangedNodes);
+		m_ChangedNodes.clear();
+	}
+
+	template<class T_NodeType, class T_ConnectionType>
+	void GridGraph<T_NodeType, T_ConnectionType>::AddConnectionsInDirections(int idx, int col, int row, const vector<Elite::Vector2>& directions)
 	{
 		for (auto d : directions)
 		{
@@ -171,15 +379,127 @@ namespace Elite
 			if (IsWithinBounds(neighborCol, neighborRow)) 
 			{
 				int neighborIdx = neighborRow * m_NrOfColumns + neighborCol;
-				float connectionCost = GetConnectionCost(idx, neighborIdx);
+				AddConnectionToNeighbor(idx, neighborIdx);
+			}
+		}
+	}
+
+	template<class T_NodeType, class T_ConnectionType>
+	void GridGraph<T_NodeType, T_ConnectionType>::AddConnectionToNeighbor(int idx, int neighborIdx)
+	{
+		float connectionCost = GetConnectionCost(idx, neighborIdx);
+
+		if (IsUniqueConnection(idx, neighborIdx)
+			&& connectionCost < 100000 //Extra check for different terrain types
+			&& !IsCuttingCorner(idx, neighborIdx))
+			AddConnection(CreateConnection(idx, neighborIdx, connectionCost));
+	}
+
+	/// <summary>
+	/// Check whether a connection to a neighbor would cut the corner of a blocked cell while that isn't allowed
+	/// </summary>
+	/// <returns>true for a diagonal connection with a blocked cell beside it, always false when corner cutting is allowed</returns>
+	template<class T_NodeType, class T_ConnectionType>
+	bool GridGraph<T_NodeType, T_ConnectionType>::IsCuttingCorner(int idx, int neighborIdx) const
+	{
+		const int col{ idx % m_NrOfColumns };
+		const int row{ idx / m_NrOfColumns };
+		const int deltaCol{ neighborIdx % m_NrOfColumns - col };
+		const int deltaRow{ neighborIdx / m_NrOfColumns - row };
+		if (m_IsCornerCuttingAllowed || deltaCol == 0 || deltaRow == 0)
+			return false;
+
+		//the cells beside a diagonal are the ones both straight steps of it lead to
+		return GetConnectionCost(idx, GetIndex(col + deltaCol, row)) >= 100000
+			|| GetConnectionCost(idx, GetIndex(col, row + deltaRow)) >= 100000;
+	}
 
-				if (IsUniqueConnection(idx, neighborIdx) 
-					&& connectionCost < 100000) //Extra check for different terrain types
-					AddConnection(new GraphConnection(idx, neighborIdx, connectionCost));
+	/// <summary>
+	/// Add or remove the diagonal connections that pass the corners of a cell whose terrain changed, they connect its straight neighbors
+	/// the neighbors whose connections changed are added to m_ChangedNodes
+	/// </summary>
+	template<class T_NodeType, class T_ConnectionType>
+	void GridGraph<T_NodeType, T_ConnectionType>::UpdateDiagonalsAround(int idx)
+	{
+		const int col{ idx % m_NrOfColumns };
+		const int row{ idx / m_NrOfColumns };
+		for (int direction = 1; direction < GridDirections::nr_of_directions; direction += 2)
+		{
+			//the straight neighbors on both sides of a diagonal direction are diagonal neighbors of each other
+			const int firstDirection{ GridDirections::Rotate(direction, -1) };
+			const int secondDirection{ GridDirections::Rotate(direction, 1) };
+			const int firstCol{ col + GridDirections::GetDeltaCol(firstDirection) };
+			const int firstRow{ row + GridDirections::GetDeltaRow(firstDirection) };
+			const int secondCol{ col + GridDirections::GetDeltaCol(secondDirection) };
+			const int secondRow{ row + GridDirections::GetDeltaRow(secondDirection) };
+			if (!IsWithinBounds(firstCol, firstRow) || !IsWithinBounds(secondCol, secondRow))
+				continue;
+
+			const int firstIdx{ GetIndex(firstCol, firstRow) };
+			const int secondIdx{ GetIndex(secondCol, secondRow) };
+			const bool isConnected{ GetConnection(firstIdx, secondIdx) != nullptr };
+			const bool canConnect{ GetConnectionCost(firstIdx, secondIdx) < 100000 && !IsCuttingCorner(firstIdx, secondIdx) };
+			if (isConnected == canConnect)
+				continue;
+
+			//an undirected graph adds and removes the connection back by itself
+			if (canConnect)
+			{
+				AddConnectionToNeighbor(firstIdx, secondIdx);
+				if (m_IsDirectionalGraph)
+					AddConnectionToNeighbor(secondIdx, firstIdx);
 			}
+			else
+			{
+				RemoveConnection(firstIdx, secondIdx);
+				if (m_IsDirectionalGraph)
+					RemoveConnection(secondIdx, firstIdx);
+			}
+			m_ChangedNodes.push_back(firstIdx);
+			m_ChangedNodes.push_back(secondIdx);
 		}
 	}
 
+	template<class T_NodeType, class T_ConnectionType>
+	inline T_ConnectionType* GridGraph<T_NodeType, T_ConnectionType>::GetConnection(int from, int to) const
+	{
+		assert(from >= 0 && from < int(m_Nodes.size()) && to >= 0 && to < int(m_Nodes.size()) &&
+			"<GridGraph::GetConnection>: invalid index");
+
+		const int slotIdx{ GetSlotIndex(from, to) };
+		if (slotIdx == GridDirections::invalid_direction)
+			return IGraph::GetConnection(from, to);
+		return m_ConnectionSlots[slotIdx];
+	}
+
+	template<class T_NodeType, class T_ConnectionType>
+	inline void GridGraph<T_NodeType, T_ConnectionType>::OnConnectionAdded(T_ConnectionType* pConnection)
+	{
+		const int slotIdx{ GetSlotIndex(pConnection->GetFrom(), pConnection->GetTo()) };
+		if (slotIdx != GridDirections::invalid_direction)
+			m_ConnectionSlots[slotIdx] = pConnection;
+	}
+
+	template<class T_NodeType, class T_ConnectionType>
+	inline void GridGraph<T_NodeType, T_ConnectionType>::OnConnectionRemoved(T_ConnectionType* pConnection)
+	{
+		//only clear the slot when it still points to this connection
+		const int slotIdx{ GetSlotIndex(pConnection->GetFrom(), pConnection->GetTo()) };
+		if (slotIdx != GridDirections::invalid_direction && m_ConnectionSlots[slotIdx] == pConnection)
+			m_ConnectionSlots[slotIdx] = nullptr;
+	}
+
+	template<class T_NodeType, class T_ConnectionType>
+	inline int GridGraph<T_NodeType, T_ConnectionType>::GetSlotIndex(int fromIdx, int toIdx) const
+	{
+		const int deltaCol{ toIdx % m_NrOfColumns - fromIdx % m_NrOfColumns };
+		const int deltaRow{ toIdx / m_NrOfColumns - fromIdx / m_NrOfColumns };
+		if (deltaCol < -1 || deltaCol > 1 || deltaRow < -1 || deltaRow > 1 || fromIdx == toIdx)
+			return GridDirections::invalid_direction;
+
+		return fromIdx * GridDirections::nr_of_directions + GridDirections::GetDirection(deltaCol, deltaRow);
+	}
+
 	template<class T_NodeType, class T_ConnectionType>
 	inline float GridGraph<T_NodeType, T_ConnectionType>::GetConnectionCost(int fromIdx, int toIdx) const
 	{
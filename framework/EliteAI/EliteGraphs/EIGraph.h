@@ -9,6 +9,7 @@
 
 #include "EGraphNodeTypes.h"
 #include "EGraphConnectionTypes.h"
+#include "framework/EliteHelpers/EMemoryPool.h"
 #include <memory>
 
 namespace Elite
@@ -36,11 +37,18 @@ namespace Elite
 		const NodeVector& GetAllNodes() const { return m_Nodes; }
 		NodeVector GetAllActiveNodes() const;
 
-		T_ConnectionType* GetConnection(int from, int to) const;
+		// scans the connections of from, derived graphs that know where a connection can be stored look it up directly
+		virtual T_ConnectionType* GetConnection(int from, int to) const;
 		const ConnectionListVector& GetAllConnections() const { return m_Connections; }
 		const ConnectionList& GetNodeConnections(int idx) const;
 
 		int GetNextFreeNodeIndex() const { return m_NextNodeIndex; }
+		// nodes and connections made with these live in the pools of the graph, so adding and removing them doesn't hit the heap
+		// AddNode and AddConnection still take ones made with new, the graph deletes those one by one
+		template<class... T_Args>
+		T_NodeType* CreateNode(T_Args&&... args) { return m_NodePool.GetAvailableUnit(std::forward<T_Args>(args)...); }
+		template<class... T_Args>
+		T_ConnectionType* CreateConnection(T_Args&&... args) { return m_ConnectionPool.GetAvailableUnit(std::forward<T_Args>(args)...); }
 		int AddNode(T_NodeType* pNode);
 		void RemoveNode(int node);
 
@@ -49,7 +57,7 @@ namespace Elite
 		void RemoveConnection(T_ConnectionType* pConnection);
 
 		// Removes all connections to this pNode
-		void IsolateNode(int idx);
+		virtual void IsolateNode(int idx);
 
 		void SetConnectionCost(int from, int to, float cost);
 
@@ -83,11 +91,22 @@ namespace Elite
 		bool m_IsDirectionalGraph;
 
 		// protected functions
-		bool IsUniqueConnection(int from, int to) const;
+		virtual bool IsUniqueConnection(int from, int to) const;
+		// called for every connection that gets added to a list and for every connection that gets destroyed
+		// while the graph is alive, so derived graphs can keep an index of their connections up to date
+		virtual void OnConnectionAdded(T_ConnectionType* pConnection) {}
+		virtual void OnConnectionRemoved(T_ConnectionType* pConnection) {}
+		void ReserveStorage(unsigned int nrOfNodes, unsigned int nrOfConnections);
+		void DestroyNode(T_NodeType* pNode);
+		void DestroyConnection(T_ConnectionType* pConnection);
 
 	private:
 		int m_NextNodeIndex;
 
+		// chunks of nodes and connections that never move, removed connections go on a free list to be reused
+		EMemoryPool<T_NodeType> m_NodePool;
+		EMemoryPool<T_ConnectionType> m_ConnectionPool;
+
 		// private functions
 		void CullInvalidEdges();
 	};
@@ -97,28 +116,25 @@ namespace Elite
 		: m_NextNodeIndex(0)
 		, m_IsDirectionalGraph(isDirectionalGraph)
 	{
+		m_NodePool.InitializePool(64, true);
+		m_ConnectionPool.InitializePool(256, true);
 	}
 
 	template<class T_NodeType, class T_ConnectionType>
 	inline IGraph<T_NodeType, T_ConnectionType>::IGraph(const IGraph& other)
 	{
-		for (auto& n : m_Nodes)
-			SAFE_DELETE(n);
-
-		for (auto& connectionList : m_Connections)
-		{
-			for (auto& connection : connectionList)
-				SAFE_DELETE(connection);
-		};
+		m_NodePool.InitializePool(64, true);
+		m_ConnectionPool.InitializePool(256, true);
+		ReserveStorage(static_cast<unsigned int>(other.m_Nodes.size()), static_cast<unsigned int>(other.GetNrOfConnections()));
 
 		for (auto n : other.m_Nodes)
-			m_Nodes.push_back(new T_NodeType(*n));
+			m_Nodes.push_back(CreateNode(*n));
 
 		for (auto cList : other.m_Connections)
 		{
 			ConnectionList newList;
 			for (auto c : cList)
-				newList.push_back(new T_ConnectionType(*c));
+				newList.push_back(CreateConnection(*c));
 			m_Connections.push_back(newList);
 		}
 
@@ -129,13 +145,20 @@ namespace Elite
 	template<class T_NodeType, class T_ConnectionType>
 	inline IGraph<T_NodeType, T_ConnectionType>::~IGraph()
 	{
-		for(auto& n : m_Nodes)
-			SAFE_DELETE(n);
+		//the pools destroy their own units all at once when they go, only the ones made with new are deleted here
+		for (auto& n : m_Nodes)
+		{
+			if (!m_NodePool.IsUnitOfPool(n))
+				SAFE_DELETE(n);
+		}
 
-		for(auto& connectionList : m_Connections)
+		for (auto& connectionList : m_Connections)
 		{
 			for (auto& connection : connectionList)
-				SAFE_DELETE(connection);
+			{
+				if (!m_ConnectionPool.IsUnitOfPool(connection))
+					SAFE_DELETE(connection);
+			}
 		}
 	}
 
@@ -204,6 +227,7 @@ namespace Elite
 			assert(m_Nodes[pNode->GetIndex()]->GetIndex() == invalid_node_index &&
 				"<Graph::AddNode>: Attempting to add a node with a duplicate ID");
 
+			DestroyNode(m_Nodes[pNode->GetIndex()]);
 			m_Nodes[pNode->GetIndex()] = pNode;
 
 			return m_NextNodeIndex;
@@ -248,7 +272,7 @@ namespace Elite
 					{
 						auto conPtr = *currentEdgeOnToNode;
 						currentEdgeOnToNode = m_Connections[(*currentConnection)->GetTo()].erase(currentEdgeOnToNode);
-						SAFE_DELETE(conPtr);
+						DestroyConnection(conPtr);
 
 						break;
 					}
@@ -257,7 +281,7 @@ namespace Elite
 
 			//finally, clear this pNode's connections
 			for (auto& connection : m_Connections[node])
-					SAFE_DELETE(connection);
+				DestroyConnection(connection);
 			m_Connections[node].clear();
 		}
 	}
@@ -277,6 +301,7 @@ namespace Elite
 			assert(IsUniqueConnection(pConnection->GetFrom(), pConnection->GetTo()) && "Connection already exists on this graph");
 			
 			m_Connections[pConnection->GetFrom()].push_back(pConnection);
+			OnConnectionAdded(pConnection);
 
 			//if the graph is undirected we must add another pConnection in the opposite
 			//direction
@@ -285,13 +310,14 @@ namespace Elite
 				//check to make sure the pConnection is unique before adding
 				if (IsUniqueConnection(pConnection->GetTo(), pConnection->GetFrom()))
 				{
-					T_ConnectionType* oppositeDirEdge = new T_ConnectionType();
+					T_ConnectionType* oppositeDirEdge = CreateConnection();
 
 					oppositeDirEdge->SetCost(pConnection->GetCost());
 					oppositeDirEdge->SetTo(pConnection->GetFrom());
 					oppositeDirEdge->SetFrom(pConnection->GetTo());
 
 					m_Connections[pConnection->GetTo()].push_back(oppositeDirEdge);
+					OnConnectionAdded(oppositeDirEdge);
 				}
 			}
 		}
@@ -332,8 +358,11 @@ namespace Elite
 			}
 		}
 
-		SAFE_DELETE(conFromTo);
-		SAFE_DELETE(conToFrom);
+		if (conFromTo)
+			DestroyConnection(conFromTo);
+		//the opposite connection is only taken out of its list when the graph is undirected
+		if (conToFrom && !m_IsDirectionalGraph)
+			DestroyConnection(conToFrom);
 
 	}
 
@@ -346,22 +375,39 @@ namespace Elite
 	template<class T_NodeType, class T_ConnectionType>
 	inline void IGraph<T_NodeType, T_ConnectionType>::IsolateNode(int idx)
 	{
-		// remove and delete connections from this pNode
-		for (auto c : m_Connections[idx])
-			delete c;
-		m_Connections[idx].clear();
-
 		// remove and delete connections from other nodes to this pNode
 		auto isConnectionToThisNode = [idx](T_ConnectionType* pCon) { return pCon->GetTo() == idx; };
-		for (auto& c : m_Connections)
+		if (!m_IsDirectionalGraph)
 		{
-			list<T_ConnectionType*>::iterator foundIt;
-			while ((foundIt = std::find_if(c.begin(), c.end(), isConnectionToThisNode))	!= c.end())
+			// in an undirected graph only the nodes this pNode connects to connect back to it
+			for (auto c : m_Connections[idx])
 			{
-				delete *foundIt;
-				c.erase(foundIt);
+				auto& neighborConnections = m_Connections[c->GetTo()];
+				auto foundIt = std::find_if(neighborConnections.begin(), neighborConnections.end(), isConnectionToThisNode);
+				if (foundIt != neighborConnections.end())
+				{
+					DestroyConnection(*foundIt);
+					neighborConnections.erase(foundIt);
+				}
 			}
 		}
+		else
+		{
+			for (auto& c : m_Connections)
+			{
+				list<T_ConnectionType*>::iterator foundIt;
+				while ((foundIt = std::find_if(c.begin(), c.end(), isConnectionToThisNode))	!= c.end())
+				{
+					DestroyConnection(*foundIt);
+					c.erase(foundIt);
+				}
+			}
+		}
+
+		// remove and delete connections from this pNode
+		for (auto c : m_Connections[idx])
+			DestroyConnection(c);
+		m_Connections[idx].clear();
 	}
 
 	template<class T_NodeType, class T_ConnectionType>
@@ -414,6 +460,10 @@ namespace Elite
 	template<class T_NodeType, class T_ConnectionType>
 	inline void IGraph<T_NodeType, T_ConnectionType>::Clear()
 	{
+		RemoveConnections();
+		for (auto& n : m_Nodes)
+			DestroyNode(n);
+
 		m_NextNodeIndex = 0;
 		m_Nodes.clear();
 		m_Connections.clear();
@@ -423,7 +473,40 @@ namespace Elite
 	inline void IGraph<T_NodeType, T_ConnectionType>::RemoveConnections()
 	{
 		for (auto& connectionList : m_Connections)
+		{
+			for (auto& connection : connectionList)
+				DestroyConnection(connection);
 			connectionList.clear();
+		}
+	}
+
+	/// <summary>
+	/// Make room in the pools up front, so building a graph of a known size doesn't grow them step by step
+	/// </summary>
+	template<class T_NodeType, class T_ConnectionType>
+	inline void IGraph<T_NodeType, T_ConnectionType>::ReserveStorage(unsigned int nrOfNodes, unsigned int nrOfConnections)
+	{
+		m_NodePool.Reserve(nrOfNodes);
+		m_ConnectionPool.Reserve(nrOfConnections);
+	}
+
+	template<class T_NodeType, class T_ConnectionType>
+	inline void IGraph<T_NodeType, T_ConnectionType>::DestroyNode(T_NodeType* pNode)
+	{
+		if (m_NodePool.IsUnitOfPool(pNode))
+			m_NodePool.ReturnUnit(pNode);
+		else
+			delete pNode;
+	}
+
+	template<class T_NodeType, class T_ConnectionType>
+	inline void IGraph<T_NodeType, T_ConnectionType>::DestroyConnection(T_ConnectionType* pConnection)
+	{
+		OnConnectionRemoved(pConnection);
+		if (m_ConnectionPool.IsUnitOfPool(pConnection))
+			m_ConnectionPool.ReturnUnit(pConnection);
+		else
+			delete pConnection;
 	}
 
 	template<class T_NodeType, class T_ConnectionType>
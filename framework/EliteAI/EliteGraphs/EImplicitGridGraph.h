@@ -0,0 +1,236 @@
+#pragma once
+
+#include <climits>
+
+#include "EGraphEnums.h"
+#include "framework/EliteAI/EliteGraphs/EliteGraphUtilities/EGraphVisuals.h"
+#include "framework/EliteAI/EliteGraphs/EliteGraphUtilities/EGridDirections.h"
+
+namespace Elite
+{
+	// grid graph without node or connection objects: every cell is one terrain byte, the connections of a cell get worked out
+	// from its neighbors whenever they are asked for, with the same rules as GridGraph (water is blocked, corners may be cut
+	// unless that is turned off, a connection costs the default straight or diagonal cost times the average terrain of both cells)
+	// it offers the adjacency interface of CompressedGraph, so AStar, BFS and JPS can search it and EGraphRenderer can draw it
+	// connections always go both ways, there is no directional version
+	class ImplicitGridGraph final
+	{
+	public:
+		ImplicitGridGraph(int columns, int rows, int cellSize, bool isConnectedDiagonally, float costStraight = 1.f, float costDiagonal = 1.5f,
+			bool isCornerCuttingAllowed = true);
+		// works on terrain bytes it doesn't own (a mapped GridMapFile for example) without copying them
+		// they have to stay valid as long as the graph is used, SetTerrainType writes into them
+		ImplicitGridGraph(unsigned char* pTerrain, int columns, int rows, int cellSize, bool isConnectedDiagonally, float costStraight = 1.f, float costDiagonal = 1.5f,
+			bool isCornerCuttingAllowed = true);
+		~ImplicitGridGraph() = default;
+
+		// a copy would still point to the terrain of the original
+		ImplicitGridGraph(const ImplicitGridGraph&) = delete;
+		ImplicitGridGraph& operator=(const ImplicitGridGraph&) = delete;
+		ImplicitGridGraph(ImplicitGridGraph&&) = default;
+		ImplicitGridGraph& operator=(ImplicitGridGraph&&) = default;
+
+		// how a terrain type is stored in a byte: 0 is blocked (water and anything else over 200 000), otherwise the TerrainType value
+		static unsigned char ToTerrainByte(TerrainType terrain);
+		static TerrainType ToTerrainType(unsigned char terrainByte) { return terrainByte == blocked_terrain ? TerrainType::Water : static_cast<TerrainType>(terrainByte); }
+
+		TerrainType GetTerrainType(int idx) const;
+		void SetTerrainType(int idx, TerrainType terrain);
+		bool IsWalkable(int idx) const { return m_pTerrain[idx] != blocked_terrain; }
+
+		int GetRows() const { return m_NrOfRows; }
+		int GetColumns() const { return m_NrOfColumns; }
+		int GetCellSize() const { return m_CellSize; }
+		float GetDefaultCostStraight() const { return m_DefaultCostStraight; }
+		float GetDefaultCostDiagonal() const { return m_DefaultCostDiagonal; }
+		bool IsConnectedDiagonally() const { return m_NrOfDirections == GridDirections::nr_of_directions; }
+		bool IsCornerCuttingAllowed() const { return m_IsCornerCuttingAllowed; }
+
+		bool IsWithinBounds(int col, int row) const { return col >= 0 && col < m_NrOfColumns && row >= 0 && row < m_NrOfRows; }
+		int GetIndex(int col, int row) const { return row * m_NrOfColumns + col; }
+
+		// returns the actual world position of the cell
+		Vector2 GetNodeWorldPos(int idx) const;
+		int GetNodeFromWorldPos(Vector2 pos) const;
+		Color GetNodeColor(int idx) const;
+
+		// adjacency interface, see CompressedGraph
+		int GetNrOfNodes() const { return m_NrOfColumns * m_NrOfRows; }
+		bool HasConnections(int idx) const;
+		template<class T_Function>
+		bool ForEachConnection(int idx, T_Function function) const;
+		bool TryGetConnectionCost(int from, int to, float& cost) const;
+
+		// only counts the terrain the graph owns
+		size_t GetMemorySize() const { return m_Terrain.capacity() * sizeof(unsigned char); }
+		const unsigned char* GetTerrainData() const { return m_pTerrain; }
+
+	private:
+		// water (and anything else over 200 000) is stored as 0, walkable terrain as its TerrainType value
+		enum { blocked_terrain = 0 };
+
+		float GetConnectionCost(int fromIdx, int toIdx, int direction) const;
+		bool IsCuttingCorner(int idx, int direction) const;
+
+		// empty when the terrain belongs to someone else, m_pTerrain points to the terrain either way
+		std::vector<unsigned char> m_Terrain;
+		unsigned char* m_pTerrain;
+		int m_NrOfColumns;
+		int m_NrOfRows;
+		int m_CellSize;
+		float m_DefaultCostStraight;
+		float m_DefaultCostDiagonal;
+		bool m_IsCornerCuttingAllowed;
+
+		// 4 when only straight connections are allowed (the even directions), 8 otherwise
+		int m_NrOfDirections;
+		// index offset to the neighbor in every direction
+		int m_IndexOffsets[GridDirections::nr_of_directions];
+	};
+
+	inline ImplicitGridGraph::ImplicitGridGraph(int columns, int rows, int cellSize, bool isConnectedDiagonally, float costStraight, float costDiagonal,
+		bool isCornerCuttingAllowed)
+		: m_Terrain(size_t(columns) * rows, static_cast<unsigned char>(TerrainType::Ground))
+		, m_pTerrain{ m_Terrain.data() }
+		, m_NrOfColumns{ columns }
+		, m_NrOfRows{ rows }
+		, m_CellSize{ cellSize }
+		, m_DefaultCostStraight{ costStraight }
+		, m_DefaultCostDiagonal{ costDiagonal }
+		, m_IsCornerCuttingAllowed{ isCornerCuttingAllowed }
+		, m_NrOfDirections{ isConnectedDiagonally ? int(GridDirections::nr_of_directions) : int(GridDirections::nr_of_directions) / 2 }
+	{
+		for (int direction = 0; direction < GridDirections::nr_of_directions; ++direction)
+			m_IndexOffsets[direction] = GridDirections::GetDeltaRow(direction) * m_NrOfColumns + GridDirections::GetDeltaCol(direction);
+	}
+
+	inline ImplicitGridGraph::ImplicitGridGraph(unsigned char* pTerrain, int columns, int rows, int cellSize, bool isConnectedDiagonally, float costStraight, float costDiagonal,
+		bool isCornerCuttingAllowed)
+		: m_pTerrain{ pTerrain }
+		, m_NrOfColumns{ columns }
+		, m_NrOfRows{ rows }
+		, m_CellSize{ cellSize }
+		, m_DefaultCostStraight{ costStraight }
+		, m_DefaultCostDiagonal{ costDiagonal }
+		, m_IsCornerCuttingAllowed{ isCornerCuttingAllowed }
+		, m_NrOfDirections{ isConnectedDiagonally ? int(GridDirections::nr_of_directions) : int(GridDirections::nr_of_directions) / 2 }
+	{
+		for (int direction = 0; direction < GridDirections::nr_of_directions; ++direction)
+			m_IndexOffsets[direction] = GridDirections::GetDeltaRow(direction) * m_NrOfColumns + GridDirections::GetDeltaCol(direction);
+	}
+
+	inline unsigned char ImplicitGridGraph::ToTerrainByte(TerrainType terrain)
+	{
+		if (int(terrain) > 200000)
+			return blocked_terrain;
+
+		assert(int(terrain) > blocked_terrain && int(terrain) <= UCHAR_MAX && "<ImplicitGridGraph::ToTerrainByte>: terrain doesn't fit in a byte");
+		return static_cast<unsigned char>(terrain);
+	}
+
+	inline TerrainType ImplicitGridGraph::GetTerrainType(int idx) const
+	{
+		return ToTerrainType(m_pTerrain[idx]);
+	}
+
+	inline void ImplicitGridGraph::SetTerrainType(int idx, TerrainType terrain)
+	{
+		m_pTerrain[idx] = ToTerrainByte(terrain);
+	}
+
+	inline Vector2 ImplicitGridGraph::GetNodeWorldPos(int idx) const
+	{
+		const float halfCellSize{ m_CellSize / 2.f };
+		return Vector2{ float(idx % m_NrOfColumns * m_CellSize) + halfCellSize, float(idx / m_NrOfColumns * m_CellSize) + halfCellSize };
+	}
+
+	inline int ImplicitGridGraph::GetNodeFromWorldPos(Vector2 pos) const
+	{
+		if (pos.x < 0 || pos.y < 0)
+			return invalid_node_index;
+
+		const int col{ int(pos.x / m_CellSize) };
+		const int row{ int(pos.y / m_CellSize) };
+		return IsWithinBounds(col, row) ? GetIndex(col, row) : invalid_node_index;
+	}
+
+	inline Color ImplicitGridGraph::GetNodeColor(int idx) const
+	{
+		switch (GetTerrainType(idx))
+		{
+		case TerrainType::Mud:
+			return MUD_NODE_COLOR;
+		case TerrainType::Water:
+			return WATER_NODE_COLOR;
+		default:
+			return DEFAULT_NODE_COLOR;
+		}
+	}
+
+	/// <summary>
+	/// Check whether a cell has a connection, a walkable cell without walkable neighbors has none, just like in GridGraph
+	/// </summary>
+	inline bool ImplicitGridGraph::HasConnections(int idx) const
+	{
+		return !ForEachConnection(idx, [](int, float) { return false; });
+	}
+
+	/// <summary>
+	/// Call function(to, cost) for every walkable neighbor of a walkable cell, stops as soon as function returns false
+	/// </summary>
+	/// <returns>false when it was stopped</returns>
+	template<class T_Function>
+	inline bool ImplicitGridGraph::ForEachConnection(int idx, T_Function function) const
+	{
+		if (!IsWalkable(idx))
+			return true;
+
+		const int col{ idx % m_NrOfColumns };
+		const int row{ idx / m_NrOfColumns };
+		const int directionStep{ GridDirections::nr_of_directions / m_NrOfDirections };
+
+		//cells away from the border have all their neighbors inside the grid
+		const bool isInside{ col > 0 && col < m_NrOfColumns - 1 && row > 0 && row < m_NrOfRows - 1 };
+		for (int direction = 0; direction < GridDirections::nr_of_directions; direction += directionStep)
+		{
+			if (!isInside && !IsWithinBounds(col + GridDirections::GetDeltaCol(direction), row + GridDirections::GetDeltaRow(direction)))
+				continue;
+
+			const int neighborIdx{ idx + m_IndexOffsets[direction] };
+			if (IsWalkable(neighborIdx) && !IsCuttingCorner(idx, direction) && !function(neighborIdx, GetConnectionCost(idx, neighborIdx, direction)))
+				return false;
+		}
+		return true;
+	}
+
+	inline bool ImplicitGridGraph::TryGetConnectionCost(int from, int to, float& cost) const
+	{
+		const int deltaCol{ to % m_NrOfColumns - from % m_NrOfColumns };
+		const int deltaRow{ to / m_NrOfColumns - from / m_NrOfColumns };
+		if (deltaCol < -1 || deltaCol > 1 || deltaRow < -1 || deltaRow > 1 || from == to)
+			return false;
+
+		const int direction{ GridDirections::GetDirection(deltaCol, deltaRow) };
+		if ((GridDirections::IsDiagonal(direction) && !IsConnectedDiagonally()) || !IsWalkable(from) || !IsWalkable(to) || IsCuttingCorner(from, direction))
+			return false;
+
+		cost = GetConnectionCost(from, to, direction);
+		return true;
+	}
+
+	inline float ImplicitGridGraph::GetConnectionCost(int fromIdx, int toIdx, int direction) const
+	{
+		const float cost{ GridDirections::IsDiagonal(direction) ? m_DefaultCostDiagonal : m_DefaultCostStraight };
+		return cost * ((int(m_pTerrain[fromIdx]) + int(m_pTerrain[toIdx])) / 2.0f);
+	}
+
+	/// <summary>
+	/// Check whether the connection in a direction passes the corner of a blocked cell while corner cutting isn't allowed
+	/// the neighbor in that direction has to be inside the grid, the cells beside it are then too
+	/// </summary>
+	inline bool ImplicitGridGraph::IsCuttingCorner(int idx, int direction) const
+	{
+		return !m_IsCornerCuttingAllowed && GridDirections::IsDiagonal(direction)
+			&& (!IsWalkable(idx + m_IndexOffsets[GridDirections::Rotate(direction, -1)]) || !IsWalkable(idx + m_IndexOffsets[GridDirections::Rotate(direction, 1)]));
+	}
+}
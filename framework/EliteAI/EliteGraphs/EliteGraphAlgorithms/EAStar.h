@@ -1,49 +1,107 @@
 #pragma once
 
+#include "framework/EliteAI/EliteGraphs/EliteGraphUtilities/ESearchContext.h"
+#include "framework/EliteAI/EliteGraphs/EliteGraphUtilities/ESearchObservers.h"
+#include "framework/EliteAI/EliteGraphs/EliteGraphUtilities/ECompressedGraph.h"
+#include "framework/EliteAI/EliteGraphs/EliteGraphUtilities/EGraphAdjacency.h"
+#include "framework/EliteAI/EliteGraphs/EImplicitGridGraph.h"
+
 namespace Elite
 {
-	template <class T_NodeType, class T_ConnectionType>
+	template <class T_NodeType, class T_ConnectionType, class T_HeuristicPolicy = HeuristicPolicies::Function>
 	class AStar
 	{
 	public:
-		AStar(IGraph<T_NodeType, T_ConnectionType>* pGraph, Heuristic hFunction);
+		AStar(IGraph<T_NodeType, T_ConnectionType>* pGraph, T_HeuristicPolicy heuristic = T_HeuristicPolicy{});
+		// searches a grid without node objects, only the FindPath overload that takes node indices works then
+		AStar(const ImplicitGridGraph* pGraph, T_HeuristicPolicy heuristic = T_HeuristicPolicy{});
+
+		std::vector<T_NodeType*> FindPath(T_NodeType* pStartNode, T_NodeType* pDestinationNode);
+		bool FindPath(T_NodeType* pStartNode, T_NodeType* pDestinationNode, SearchContext& context);
+		bool FindPath(int startIdx, int destinationIdx, SearchContext& context);
+		// tells the observer about every node it generates and expands, see SearchObservers
+		template<class T_SearchObserver>
+		bool FindPath(int startIdx, int destinationIdx, SearchContext& context, T_SearchObserver& observer);
+
+		// one search for the path to whichever destination is the cheapest to reach, the path ends in that destination
+		std::vector<T_NodeType*> FindPath(T_NodeType* pStartNode, const std::vector<T_NodeType*>& destinationNodes);
+		bool FindPath(int startIdx, const std::vector<int>& destinationIndices, SearchContext& context);
+		template<class T_SearchObserver>
+		bool FindPath(int startIdx, const std::vector<int>& destinationIndices, SearchContext& context, T_SearchObserver& observer);
+
+		void SetHeuristicFunction(T_HeuristicPolicy heuristic) { m_Heuristic = heuristic; }
+		// search the compressed copy of the graph instead of its connection lists, nullptr to go back to the lists
+		// the copy has to be kept up to date with the graph by the caller
+		void SetCompressedGraph(const CompressedGraph* pCompressedGraph) { m_pCompressedGraph = pCompressedGraph; }
 
-		// stores the optimal connection to a node and its total costs related to the start and end node of the path
-		struct NodeRecord
+	private:
+		// up to this many destinations the heuristic is the lowest one to any of them, with more it's the one to their bounding box
+		enum { max_nr_of_destinations_to_compare = 8 };
+
+		// what the search heads for: IsGoal(idx) ends the search, GetHeuristicCost(idx) estimates the cost to get there
+		struct SingleGoal
 		{
-			T_NodeType* pNode = nullptr;
-			T_ConnectionType* pConnection = nullptr;
-			float costSoFar = 0.f; // accumulated g-costs of all the connections leading up to this one
-			float estimatedTotalCost = 0.f; // f-cost (= costSoFar + h-cost)
+			const AStar* pAStar;
+			int destinationIdx;
 
-			bool operator==(const NodeRecord& other) const
-			{
-				return pNode == other.pNode
-					&& pConnection == other.pConnection
-					&& costSoFar == other.costSoFar
-					&& estimatedTotalCost == other.estimatedTotalCost;
-			};
+			bool IsGoal(int idx) const { return idx == destinationIdx; }
+			float GetHeuristicCost(int idx) const { return pAStar->GetHeuristicCost(idx, destinationIdx); }
+		};
+		struct GoalSet
+		{
+			const AStar* pAStar;
+			const NodeBitset* pGoals;
+			const std::vector<int>* pDestinationIndices;
 
-			bool operator<(const NodeRecord& other) const
-			{
-				return estimatedTotalCost < other.estimatedTotalCost;
-			};
+			bool IsGoal(int idx) const { return pGoals->Test(idx); }
+			float GetHeuristicCost(int idx) const;
 		};
+		// the distance to the box can't be more than the distance to the closest destination in it, so it doesn't overestimate either
+		struct GoalBounds
+		{
+			const AStar* pAStar;
+			const NodeBitset* pGoals;
+			Vector2 minPosition;
+			Vector2 maxPosition;
 
-		std::vector<T_NodeType*> FindPath(T_NodeType* pStartNode, T_NodeType* pDestinationNode, std::vector<T_NodeType*>& openListRender, std::vector<T_NodeType*>& closedListRender);
+			bool IsGoal(int idx) const { return pGoals->Test(idx); }
+			float GetHeuristicCost(int idx) const;
+		};
 
-	private:
-		void GetNearestNodeToEnd(NodeRecord& nearestNodeToEnd, vector<NodeRecord>& closedList, T_NodeType* pDestinationNode) const;
-		float GetHeuristicCost(T_NodeType* pStartNode, T_NodeType* pEndNode) const;
+		template<class T_Adjacency, class T_SearchObserver>
+		bool Search(const T_Adjacency& adjacency, int startIdx, const std::vector<int>& destinationIndices, SearchContext& context, T_SearchObserver& observer) const;
+		template<class T_Adjacency, class T_Goal, class T_SearchObserver>
+		bool Search(const T_Adjacency& adjacency, int startIdx, const T_Goal& goal, SearchContext& context, T_SearchObserver& observer) const;
+		float GetHeuristicCost(int fromIdx, int toIdx) const;
+		// the column and row of a node on a grid, its position otherwise
+		Vector2 GetHeuristicPosition(int idx) const;
 
 		IGraph<T_NodeType, T_ConnectionType>* m_pGraph;
-		Heuristic m_HeuristicFunction;
+		const CompressedGraph* m_pCompressedGraph = nullptr;
+		const ImplicitGridGraph* m_pImplicitGraph = nullptr;
+		T_HeuristicPolicy m_Heuristic;
+		// the columns of the graph when it's a GridGraph, the positions of its nodes follow from their indices then, otherwise 0
+		int m_NrOfGridColumns;
+
+		// used by the FindPath overload that doesn't get a context
+		SearchContext m_Context;
 	};
 
-	template <class T_NodeType, class T_ConnectionType>
-	AStar<T_NodeType, T_ConnectionType>::AStar(IGraph<T_NodeType, T_ConnectionType>* pGraph, Heuristic hFunction)
+	template<class T_NodeType, class T_ConnectionType, class T_HeuristicPolicy>
+	AStar<T_NodeType, T_ConnectionType, T_HeuristicPolicy>::AStar(IGraph<T_NodeType, T_ConnectionType>* pGraph, T_HeuristicPolicy heuristic)
 		: m_pGraph{ pGraph }
-		, m_HeuristicFunction{ hFunction }
+		, m_Heuristic{ heuristic }
+	{
+		const GridGraph<T_NodeType, T_ConnectionType>* pGridGraph{ dynamic_cast<GridGraph<T_NodeType, T_ConnectionType>*>(pGraph) };
+		m_NrOfGridColumns = pGridGraph ? pGridGraph->GetColumns() : 0;
+	}
+
+	template<class T_NodeType, class T_ConnectionType, class T_HeuristicPolicy>
+	AStar<T_NodeType, T_ConnectionType, T_HeuristicPolicy>::AStar(const ImplicitGridGraph* pGraph, T_HeuristicPolicy heuristic)
+		: m_pGraph{ nullptr }
+		, m_pImplicitGraph{ pGraph }
+		, m_Heuristic{ heuristic }
+		, m_NrOfGridColumns{ pGraph->GetColumns() }
 	{
 	}
 
@@ -54,178 +112,317 @@ namespace Elite
 	/// <typeparam name="T_ConnectionType"><The type of connection used on the graph/typeparam>
 	/// <param name="pStartNode">The start node we want to find a path FROM</param>
 	/// <param name="pDestinationNode">The destination node we want to find a path TO</param>
-	/// <param name="openListRender">vector of nodes that gets filled up to visualize the open list in the renderer</param>
-	/// <param name="closedListRender">vector of nodes that gets filled up to visualize the closed list in the renderer</param>
 	/// <returns>returns the path between the 2 nodes</returns>
-	template<class T_NodeType, class T_ConnectionType>
-	inline std::vector<T_NodeType*> AStar<T_NodeType, T_ConnectionType>::FindPath(T_NodeType* pStartNode, T_NodeType* pDestinationNode, std::vector<T_NodeType*>& openListRender, std::vector<T_NodeType*>& closedListRender)
+	template<class T_NodeType, class T_ConnectionType, class T_HeuristicPolicy>
+	inline std::vector<T_NodeType*> AStar<T_NodeType, T_ConnectionType, T_HeuristicPolicy>::FindPath(T_NodeType* pStartNode, T_NodeType* pDestinationNode)
+	{
+		FindPath(pStartNode, pDestinationNode, m_Context);
+
+		vector<T_NodeType*> finalPath;
+		finalPath.reserve(m_Context.GetPath().size());
+		for (int idx : m_Context.GetPath())
+			finalPath.push_back(m_pGraph->GetNode(idx));
+
+		return finalPath;
+	}
+
+	/// <summary>
+	/// find a path from 2 given nodes on the graph, using the buffers of the given context so repeated queries don't allocate
+	/// </summary>
+	/// <typeparam name="T_NodeType">The type of node used on the graph</typeparam>
+	/// <typeparam name="T_ConnectionType"><The type of connection used on the graph/typeparam>
+	/// <param name="pStartNode">The start node we want to find a path FROM</param>
+	/// <param name="pDestinationNode">The destination node we want to find a path TO</param>
+	/// <param name="context">The scratch buffers to search with, the node indices of the path end up in context.GetPath()</param>
+	/// <returns>true if the destination was reached, otherwise the path leads to the node closest to the destination</returns>
+	template<class T_NodeType, class T_ConnectionType, class T_HeuristicPolicy>
+	inline bool AStar<T_NodeType, T_ConnectionType, T_HeuristicPolicy>::FindPath(T_NodeType* pStartNode, T_NodeType* pDestinationNode, SearchContext& context)
+	{
+		assert(m_pGraph && "<AStar::FindPath>: an implicit grid has no nodes, search it by node index");
+		return FindPath(pStartNode->GetIndex(), pDestinationNode->GetIndex(), context);
+	}
+
+	/// <summary>
+	/// find a path from 2 given node indices, the only way to search an implicit grid
+	/// </summary>
+	/// <param name="startIdx">The index of the node we want to find a path FROM</param>
+	/// <param name="destinationIdx">The index of the node we want to find a path TO</param>
+	/// <param name="context">The scratch buffers to search with, the node indices of the path end up in context.GetPath()</param>
+	/// <returns>true if the destination was reached, otherwise the path leads to the node closest to the destination</returns>
+	template<class T_NodeType, class T_ConnectionType, class T_HeuristicPolicy>
+	inline bool AStar<T_NodeType, T_ConnectionType, T_HeuristicPolicy>::FindPath(int startIdx, int destinationIdx, SearchContext& context)
+	{
+		SearchObservers::None observer{};
+		return FindPath(startIdx, destinationIdx, context, observer);
+	}
+
+	/// <summary>
+	/// find a path from 2 given node indices and report the search to an observer
+	/// </summary>
+	/// <typeparam name="T_SearchObserver">SearchObservers::Recorder to draw the open and closed list, SearchObservers::Statistics to count</typeparam>
+	/// <param name="observer">Gets OnNodeGenerated and OnNodeExpanded calls while searching</param>
+	/// <returns>true if the destination was reached, otherwise the path leads to the node closest to the destination</returns>
+	template<class T_NodeType, class T_ConnectionType, class T_HeuristicPolicy>
+	template<class T_SearchObserver>
+	inline bool AStar<T_NodeType, T_ConnectionType, T_HeuristicPolicy>::FindPath(int startIdx, int destinationIdx, SearchContext& context, T_SearchObserver& observer)
+	{
+		const SingleGoal goal{ this, destinationIdx };
+		if (m_pImplicitGraph)
+			return Search(*m_pImplicitGraph, startIdx, goal, context, observer);
+		if (m_pCompressedGraph)
+			return Search(*m_pCompressedGraph, startIdx, goal, context, observer);
+		return Search(GraphAdjacency<T_NodeType, T_ConnectionType>{ m_pGraph }, startIdx, goal, context, observer);
+	}
+
+	/// <summary>
+	/// find a path from a node to the cheapest to reach of a set of nodes on the graph
+	/// </summary>
+	/// <param name="pStartNode">The start node we want to find a path FROM</param>
+	/// <param name="destinationNodes">The nodes we want to find a path TO, any one of them will do</param>
+	/// <returns>returns the path to the destination that was the cheapest to reach</returns>
+	template<class T_NodeType, class T_ConnectionType, class T_HeuristicPolicy>
+	inline std::vector<T_NodeType*> AStar<T_NodeType, T_ConnectionType, T_HeuristicPolicy>::FindPath(T_NodeType* pStartNode, const std::vector<T_NodeType*>& destinationNodes)
+	{
+		assert(m_pGraph && "<AStar::FindPath>: an implicit grid has no nodes, search it by node index");
+
+		std::vector<int> destinationIndices;
+		destinationIndices.reserve(destinationNodes.size());
+		for (const T_NodeType* pDestinationNode : destinationNodes)
+			destinationIndices.push_back(pDestinationNode->GetIndex());
+		FindPath(pStartNode->GetIndex(), destinationIndices, m_Context);
+
+		vector<T_NodeType*> finalPath;
+		finalPath.reserve(m_Context.GetPath().size());
+		for (int idx : m_Context.GetPath())
+			finalPath.push_back(m_pGraph->GetNode(idx));
+
+		return finalPath;
+	}
+
+	/// <summary>
+	/// find a path from a node index to the cheapest to reach of a set of node indices, in one search instead of one per destination
+	/// </summary>
+	/// <param name="startIdx">The index of the node we want to find a path FROM</param>
+	/// <param name="destinationIndices">The indices of the nodes we want to find a path TO, any one of them will do</param>
+	/// <param name="context">The scratch buffers to search with, the path ends up in context.GetPath() and its last node is the destination it reached</param>
+	/// <returns>true if a destination was reached, otherwise the path leads to the node closest to the destinations</returns>
+	template<class T_NodeType, class T_ConnectionType, class T_HeuristicPolicy>
+	inline bool AStar<T_NodeType, T_ConnectionType, T_HeuristicPolicy>::FindPath(int startIdx, const std::vector<int>& destinationIndices, SearchContext& context)
+	{
+		SearchObservers::None observer{};
+		return FindPath(startIdx, destinationIndices, context, observer);
+	}
+
+	/// <summary>
+	/// find a path from a node index to the cheapest to reach of a set of node indices and report the search to an observer
+	/// </summary>
+	/// <typeparam name="T_SearchObserver">SearchObservers::Recorder to draw the open and closed list, SearchObservers::Statistics to count</typeparam>
+	/// <param name="observer">Gets OnNodeGenerated and OnNodeExpanded calls while searching</param>
+	/// <returns>true if a destination was reached, otherwise the path leads to the node closest to the destinations</returns>
+	template<class T_NodeType, class T_ConnectionType, class T_HeuristicPolicy>
+	template<class T_SearchObserver>
+	inline bool AStar<T_NodeType, T_ConnectionType, T_HeuristicPolicy>::FindPath(int startIdx, const std::vector<int>& destinationIndices, SearchContext& context, T_SearchObserver& observer)
+	{
+		assert(!destinationIndices.empty() && "<AStar::FindPath>: needs at least one destination");
+
+		if (m_pImplicitGraph)
+			return Search(*m_pImplicitGraph, startIdx, destinationIndices, context, observer);
+		if (m_pCompressedGraph)
+			return Search(*m_pCompressedGraph, startIdx, destinationIndices, context, observer);
+		return Search(GraphAdjacency<T_NodeType, T_ConnectionType>{ m_pGraph }, startIdx, destinationIndices, context, observer);
+	}
+
+	/// <summary>
+	/// Mark the destinations in the goal bits of the context and pick the heuristic that fits their amount
+	/// </summary>
+	template<class T_NodeType, class T_ConnectionType, class T_HeuristicPolicy>
+	template<class T_Adjacency, class T_SearchObserver>
+	inline bool AStar<T_NodeType, T_ConnectionType, T_HeuristicPolicy>::Search(const T_Adjacency& adjacency, int startIdx, const std::vector<int>& destinationIndices,
+		SearchContext& context, T_SearchObserver& observer) const
+	{
+		//the goal bits are cleared here, the search itself only starts the node states and the open list
+		context.ClearGoals(adjacency.GetNrOfNodes());
+		NodeBitset& goals = context.GetGoals();
+		for (int destinationIdx : destinationIndices)
+			goals.Set(destinationIdx);
+
+		if (int(destinationIndices.size()) <= max_nr_of_destinations_to_compare)
+			return Search(adjacency, startIdx, GoalSet{ this, &goals, &destinationIndices }, context, observer);
+
+		GoalBounds goal{ this, &goals, GetHeuristicPosition(destinationIndices.front()), GetHeuristicPosition(destinationIndices.front()) };
+		for (int destinationIdx : destinationIndices)
+		{
+			const Vector2 position{ GetHeuristicPosition(destinationIdx) };
+			goal.minPosition.x = std::min(goal.minPosition.x, position.x);
+			goal.minPosition.y = std::min(goal.minPosition.y, position.y);
+			goal.maxPosition.x = std::max(goal.maxPosition.x, position.x);
+			goal.maxPosition.y = std::max(goal.maxPosition.y, position.y);
+		}
+		return Search(adjacency, startIdx, goal, context, observer);
+	}
+
+	/// <summary>
+	/// The search itself, written once for the connection lists of the graph and for its compressed copy
+	/// </summary>
+	/// <typeparam name="T_Adjacency">GraphAdjacency, CompressedGraph or ImplicitGridGraph</typeparam>
+	/// <typeparam name="T_Goal">SingleGoal, GoalSet or GoalBounds</typeparam>
+	template<class T_NodeType, class T_ConnectionType, class T_HeuristicPolicy>
+	template<class T_Adjacency, class T_Goal, class T_SearchObserver>
+	inline bool AStar<T_NodeType, T_ConnectionType, T_HeuristicPolicy>::Search(const T_Adjacency& adjacency, int startIdx, const T_Goal& goal, SearchContext& context, T_SearchObserver& observer) const
 	{
 		//Here we will calculate our path using AStar
 		bool foundPath{ false };
-		vector<T_NodeType*> finalPath;
-		vector<NodeRecord> openList;
-		vector<NodeRecord> closedList;
-		NodeRecord currentRecord{};
-		NodeRecord startRecord{};
-		startRecord.pNode = pStartNode;
-		startRecord.pConnection = nullptr;
-		startRecord.estimatedTotalCost = GetHeuristicCost(pStartNode, pDestinationNode);
-		openList.push_back(startRecord);
-
-		while (!openList.empty())
+
+		//closed node closest to the destination, the path leads there when the destination can't be reached
+		int nearestIdx{ startIdx };
+		//the goal the search reached, the path ends there
+		int destinationIdx{ invalid_node_index };
+		float nearestHeuristicCost{ FLT_MAX };
+
+		//start a new search: every node becomes unvisited and the open list is emptied
+		context.BeginSearch(adjacency.GetNrOfNodes());
+		IndexedPriorityQueue<float>& openList = context.GetOpenList();
+		SearchStateTable& nodeStates = context.GetNodeStates();
+
+		SearchNodeState& startState = nodeStates.Visit(startIdx);
+		startState.estimatedTotalCost = goal.GetHeuristicCost(startIdx);
+		startState.status = SearchNodeStatus::Open;
+		openList.Push(startIdx, startState.estimatedTotalCost);
+
+		while (!openList.IsEmpty())
 		{
-			//sort the openlist by estimated total cost, then set the currentrecord to the first one(lowest cost)
-			std::sort(openList.begin(), openList.end());
-			currentRecord = openList.front();
+			//take the node with the lowest estimated total cost off the open list
+			const int currentIdx{ openList.Pop() };
+			SearchNodeState& currentState = nodeStates.GetState(currentIdx);
 
-			// if the currentrecord is the goal node we no longer have to keep searching for a path, so we can stop this while loop
-			if (currentRecord.pNode == pDestinationNode)
+			// if the current node is the goal node we no longer have to keep searching for a path, so we can stop this while loop
+			if (goal.IsGoal(currentIdx))
 			{
 				foundPath = true;
+				destinationIdx = currentIdx;
 				break;
 			}
+			context.CountExpandedNode();
 
-			//loop over all neighbors of the currentrecord
-			for (auto currentConnection : m_pGraph->GetNodeConnections(currentRecord.pNode->GetIndex()))
+			//loop over all neighbors of the current node
+			adjacency.ForEachConnection(currentIdx, [&](int neighborIdx, float connectionCost)
 			{
-				float costSoFar = currentRecord.costSoFar + currentConnection->GetCost();
-				auto neighbor{ m_pGraph->GetNode(currentConnection->GetTo()) };
-				bool cheaperFound{ false };
-				//find the neighbor in the closed list
-				for (std::vector<NodeRecord>::iterator it{ closedList.begin() }; it != closedList.end();)
-				{
-					NodeRecord& recordIterator = *it;
-					if (neighbor == recordIterator.pNode)
-					{
-						//switch the record in the closed list out with the neighbor if this record is cheaper
-						if (recordIterator.costSoFar > costSoFar)
-						{
-							std::iter_swap(it, closedList.end() - 1);
-							closedList.pop_back();
-						}
-						else
-						{
-							cheaperFound = true;
-							++it;
-						}
-						break;
-					}
-					else
-						++it;
-				}
-				//if there is a cheaper record found in the closed list, continue to the next successor
-				if (cheaperFound)
-				{
-					continue;
-				}
-				cheaperFound = false;
-				//find the neighbor in the closed list
-				for (std::vector<NodeRecord>::iterator it{ openList.begin() }; it != openList.end();)
+				float costSoFar = currentState.costSoFar + connectionCost;
+
+				//if the neighbor is already on the open or closed list, only continue when this path to it is cheaper
+				//a cheaper path to a closed neighbor reopens it
+				bool isOnOpenList{ false };
+				if (nodeStates.IsVisited(neighborIdx))
 				{
-					NodeRecord& recordIterator = *it;
-					if (neighbor == recordIterator.pNode)
+					const SearchNodeState& neighborState = nodeStates.GetState(neighborIdx);
+					if (neighborState.costSoFar <= costSoFar)
 					{
-						//switch the record in the open list out with the neighbor if this record is cheaper
-						if (recordIterator.costSoFar > costSoFar)
-						{
-							std::iter_swap(it, openList.end() - 1);
-							openList.pop_back();
-						}
-						else
-						{
-							++it;
-							cheaperFound = true;
-						}
-						break;
+						return true;
 					}
-					else
-						++it;
-				}
-				//if there is a cheaper record found in the open list, continue to the next neighbor
-				if (cheaperFound)
-				{
-					continue;
+					isOnOpenList = neighborState.status == SearchNodeStatus::Open;
+					if (!isOnOpenList)
+						context.CountReopenedNode();
 				}
-				//add the neighbor to the open list if it doesn't exist yet
-				NodeRecord newNode{};
-				newNode.pNode = neighbor;
-				newNode.pConnection = currentConnection;
-				newNode.costSoFar = costSoFar;
-				newNode.estimatedTotalCost = newNode.costSoFar + GetHeuristicCost(newNode.pNode, pDestinationNode);
-				openList.push_back(newNode);
-				openListRender.push_back(neighbor);
+
+				//add the neighbor to the open list if it isn't on it yet, otherwise lower its cost
+				SearchNodeState& neighborState = nodeStates.Visit(neighborIdx);
+				neighborState.costSoFar = costSoFar;
+				neighborState.estimatedTotalCost = costSoFar + goal.GetHeuristicCost(neighborIdx);
+				neighborState.parentIdx = currentIdx;
+				neighborState.status = SearchNodeStatus::Open;
+				if (isOnOpenList)
+					openList.DecreaseKey(neighborIdx, neighborState.estimatedTotalCost);
+				else
+					openList.Push(neighborIdx, neighborState.estimatedTotalCost);
+				context.CountGeneratedNode();
+				observer.OnNodeGenerated(neighborIdx);
+				return true;
+			});
+			//close the current node, it was already taken off the open list
+			currentState.status = SearchNodeStatus::Closed;
+			observer.OnNodeExpanded(currentIdx);
+
+			float heuristicCost{ currentState.estimatedTotalCost - currentState.costSoFar };
+			if (heuristicCost < nearestHeuristicCost)
+			{
+				nearestHeuristicCost = heuristicCost;
+				nearestIdx = currentIdx;
 			}
-			//add the current record to the closed list and remove it from the open list
-			closedList.push_back(currentRecord);
-			closedListRender.push_back(currentRecord.pNode);
-			openList.erase(openList.begin());
-		}
-		//if there is no path possible, set the current record to the nearest node to the end
-		if (!foundPath)
-		{
-			GetNearestNodeToEnd(currentRecord, closedList, pDestinationNode);
 		}
+		context.BeginReconstruction();
 
-		//loop over the closed list and create a path to the current node
-		while (currentRecord.pNode != pStartNode)
+		//if there is no path possible, lead the path to the nearest node to the end
+		//follow the parents back to the start (nodes get added in reverse order)
+		std::vector<int>& finalPath = context.GetPath();
+		for (int currentIdx = foundPath ? destinationIdx : nearestIdx; currentIdx != invalid_node_index; currentIdx = nodeStates.GetState(currentIdx).parentIdx)
 		{
-			finalPath.push_back(currentRecord.pNode);
-			for (std::vector<NodeRecord>::iterator it{ closedList.begin() }; it != closedList.end();)
-			{
-				NodeRecord& recordIterator = *it;
-				if (recordIterator.pNode == m_pGraph->GetNode(currentRecord.pConnection->GetFrom()))
-				{
-					currentRecord = recordIterator;
-					break;
-				}
-				else
-					++it;
-			}
+			finalPath.push_back(currentIdx);
 		}
-		//add the start node to the finalpath and reverse the path (nodes got added in reverse order)
-		finalPath.push_back(pStartNode);
 		std::reverse(finalPath.begin(), finalPath.end());
 
-		return finalPath;
+		context.EndSearch();
+		return foundPath;
 	}
 
 	/// <summary>
-	/// Find the node closest to the destination node on the closed list
+	/// Get the cost between 2 nodes on the graph using the heuristic function
 	/// </summary>
 	/// <typeparam name="T_NodeType">The type of node used on the graph</typeparam>
 	/// <typeparam name="T_ConnectionType"><The type of connection used on the graph/typeparam>
-	/// <param name="nearestNodeToEnd">noderecord to put the closest node into</param>
-	/// <param name="closedList">closedlist to loop over</param>
-	/// <param name="pDestinationNode">destination node of the path</param>
-	template<class T_NodeType, class T_ConnectionType>
-	inline void AStar<T_NodeType, T_ConnectionType>::GetNearestNodeToEnd(NodeRecord& nearestNodeToEnd, vector<NodeRecord>& closedList, T_NodeType* pDestinationNode) const
+	/// <param name="fromIdx">the start node</param>
+	/// <param name="toIdx">the endnode</param>
+	/// <returns>the cost between these nodes</returns>
+	template<class T_NodeType, class T_ConnectionType, class T_HeuristicPolicy>
+	inline float AStar<T_NodeType, T_ConnectionType, T_HeuristicPolicy>::GetHeuristicCost(int fromIdx, int toIdx) const
 	{
-		float lowestCost{ FLT_MAX };
-		for (vector<NodeRecord>::iterator it{ closedList.begin() }; it != closedList.end();)
+		//on a grid the column and row distance is enough, no need to ask the graph for positions
+		if (m_NrOfGridColumns > 0)
 		{
-			NodeRecord& recordIterator = *it;
-			float costNodeToGoal = GetHeuristicCost(recordIterator.pNode, pDestinationNode);
-			if (costNodeToGoal < lowestCost && recordIterator.pNode != pDestinationNode)
-			{
-				lowestCost = costNodeToGoal;
-				nearestNodeToEnd = recordIterator;
-			}
-			++it;
+			return m_Heuristic(abs(toIdx % m_NrOfGridColumns - fromIdx % m_NrOfGridColumns), abs(toIdx / m_NrOfGridColumns - fromIdx / m_NrOfGridColumns));
 		}
+
+		Vector2 toDestination = m_pGraph->GetNodePos(toIdx) - m_pGraph->GetNodePos(fromIdx);
+		return m_Heuristic(abs(toDestination.x), abs(toDestination.y));
 	}
 
 	/// <summary>
-	/// Get the cost between 2 nodes on the graph using the heuristic function
+	/// Get the position a heuristic measures from
 	/// </summary>
-	/// <typeparam name="T_NodeType">The type of node used on the graph</typeparam>
-	/// <typeparam name="T_ConnectionType"><The type of connection used on the graph/typeparam>
-	/// <param name="pStartNode">the start node</param>
-	/// <param name="pEndNode">the endnode</param>
-	/// <returns>the cost between these nodes</returns>
-	template<class T_NodeType, class T_ConnectionType>
-	inline float AStar<T_NodeType, T_ConnectionType>::GetHeuristicCost(T_NodeType* pStartNode, T_NodeType* pEndNode) const
+	/// <param name="idx">the node</param>
+	/// <returns>its column and row on a grid, its position in the world otherwise</returns>
+	template<class T_NodeType, class T_ConnectionType, class T_HeuristicPolicy>
+	inline Vector2 AStar<T_NodeType, T_ConnectionType, T_HeuristicPolicy>::GetHeuristicPosition(int idx) const
+	{
+		if (m_NrOfGridColumns > 0)
+			return Vector2{ float(idx % m_NrOfGridColumns), float(idx / m_NrOfGridColumns) };
+		return m_pGraph->GetNodePos(idx);
+	}
+
+	/// <summary>
+	/// Get the lowest heuristic cost from a node to any of the destinations
+	/// </summary>
+	/// <param name="idx">the node</param>
+	/// <returns>the estimated cost to the destination that looks closest</returns>
+	template<class T_NodeType, class T_ConnectionType, class T_HeuristicPolicy>
+	inline float AStar<T_NodeType, T_ConnectionType, T_HeuristicPolicy>::GoalSet::GetHeuristicCost(int idx) const
+	{
+		float lowestCost{ FLT_MAX };
+		for (int destinationIdx : *pDestinationIndices)
+			lowestCost = std::min(lowestCost, pAStar->GetHeuristicCost(idx, destinationIdx));
+		return lowestCost;
+	}
+
+	/// <summary>
+	/// Get the heuristic cost from a node to the bounding box of the destinations, 0 inside it
+	/// </summary>
+	/// <param name="idx">the node</param>
+	/// <returns>the estimated cost to the closest point of the box</returns>
+	template<class T_NodeType, class T_ConnectionType, class T_HeuristicPolicy>
+	inline float AStar<T_NodeType, T_ConnectionType, T_HeuristicPolicy>::GoalBounds::GetHeuristicCost(int idx) const
 	{
-		Vector2 toDestination = m_pGraph->GetNodePos(pEndNode) - m_pGraph->GetNodePos(pStartNode);
-		return m_HeuristicFunction(abs(toDestination.x), abs(toDestination.y));
+		const Vector2 position{ pAStar->GetHeuristicPosition(idx) };
+		const float distanceX{ std::max(0.f, std::max(minPosition.x - position.x, position.x - maxPosition.x)) };
+		const float distanceY{ std::max(0.f, std::max(minPosition.y - position.y, position.y - maxPosition.y)) };
+		return pAStar->m_Heuristic(distanceX, distanceY);
 	}
-}
\ No newline at end of file
+}
@@ -1,25 +1,54 @@
 #pragma once
 
+#include "framework/EliteAI/EliteGraphs/EliteGraphUtilities/ESearchContext.h"
+#include "framework/EliteAI/EliteGraphs/EliteGraphUtilities/ESearchObservers.h"
+#include "framework/EliteAI/EliteGraphs/EliteGraphUtilities/ECompressedGraph.h"
+#include "framework/EliteAI/EliteGraphs/EliteGraphUtilities/EGraphAdjacency.h"
+#include "framework/EliteAI/EliteGraphs/EImplicitGridGraph.h"
+
 namespace Elite 
 {
 	template <class T_NodeType, class T_ConnectionType>
 	class BFS
 	{
 	public:
-		BFS(IGraph<T_NodeType, T_ConnectionType>* pGraph, Heuristic hFunction);
+		BFS(IGraph<T_NodeType, T_ConnectionType>* pGraph);
+		// searches a grid without node objects, only the FindPath overload that takes node indices works then
+		BFS(const ImplicitGridGraph* pGraph);
+
+		std::vector<T_NodeType*> FindPath(T_NodeType* pStartNode, T_NodeType* pDestinationNode);
+		bool FindPath(T_NodeType* pStartNode, T_NodeType* pDestinationNode, SearchContext& context);
+		bool FindPath(int startIdx, int destinationIdx, SearchContext& context);
+		// tells the observer about every node it generates and expands, see SearchObservers
+		template<class T_SearchObserver>
+		bool FindPath(int startIdx, int destinationIdx, SearchContext& context, T_SearchObserver& observer);
+
+		// search the compressed copy of the graph instead of its connection lists, nullptr to go back to the lists
+		// the copy has to be kept up to date with the graph by the caller
+		void SetCompressedGraph(const CompressedGraph* pCompressedGraph) { m_pCompressedGraph = pCompressedGraph; }
 
-		std::vector<T_NodeType*> FindPath(T_NodeType* pStartNode, T_NodeType* pDestinationNode, std::vector<T_NodeType*>& openListRender, std::vector<T_NodeType*>& closedListRender);
 	private:
-		float GetHeuristicCost(T_NodeType* pStartNode, T_NodeType* pEndNode) const;
+		template<class T_Adjacency, class T_SearchObserver>
+		bool Search(const T_Adjacency& adjacency, int startIdx, int destinationIdx, SearchContext& context, T_SearchObserver& observer) const;
 
 		IGraph<T_NodeType, T_ConnectionType>* m_pGraph;
-		Heuristic m_HeuristicFunction;
+		const CompressedGraph* m_pCompressedGraph = nullptr;
+		const ImplicitGridGraph* m_pImplicitGraph = nullptr;
+
+		// used by the FindPath overload that doesn't get a context
+		SearchContext m_Context;
 	};
 
 	template<class T_NodeType, class T_ConnectionType>
-	inline BFS<T_NodeType, T_ConnectionType>::BFS(IGraph<T_NodeType, T_ConnectionType>* pGraph, Heuristic hFunction)
+	inline BFS<T_NodeType, T_ConnectionType>::BFS(IGraph<T_NodeType, T_ConnectionType>* pGraph)
 		: m_pGraph{ pGraph }
-		, m_HeuristicFunction{ hFunction }
+	{
+	}
+
+	template<class T_NodeType, class T_ConnectionType>
+	inline BFS<T_NodeType, T_ConnectionType>::BFS(const ImplicitGridGraph* pGraph)
+		: m_pGraph{ nullptr }
+		, m_pImplicitGraph{ pGraph }
 	{
 	}
 
@@ -30,81 +59,131 @@ namespace Elite
 	/// <typeparam name="T_ConnectionType"><The type of connection used on the graph/typeparam>
 	/// <param name="pStartNode">The start node we want to find a path FROM</param>
 	/// <param name="pDestinationNode">The destination node we want to find a path TO</param>
-	/// <param name="openListRender">vector of nodes that gets filled up to visualize the open list in the renderer</param>
-	/// <param name="closedListRender">vector of nodes that gets filled up to visualize the closed list in the renderer</param>
 	/// <returns>returns the path between the 2 nodes</returns>
 	template<class T_NodeType, class T_ConnectionType>
-	inline std::vector<T_NodeType*> BFS<T_NodeType, T_ConnectionType>::FindPath(T_NodeType* pStartNode, T_NodeType* pDestinationNode, std::vector<T_NodeType*>& openListRender, std::vector<T_NodeType*>& closedListRender)
+	inline std::vector<T_NodeType*> BFS<T_NodeType, T_ConnectionType>::FindPath(T_NodeType* pStartNode, T_NodeType* pDestinationNode)
+	{
+		FindPath(pStartNode, pDestinationNode, m_Context);
+
+		vector<T_NodeType*> path;
+		path.reserve(m_Context.GetPath().size());
+		for (int idx : m_Context.GetPath())
+			path.push_back(m_pGraph->GetNode(idx));
+
+		return path;
+	}
+
+	/// <summary>
+	/// find a path from 2 given nodes on the graph, using the buffers of the given context so repeated queries don't allocate
+	/// </summary>
+	/// <typeparam name="T_NodeType">The type of node used on the graph</typeparam>
+	/// <typeparam name="T_ConnectionType"><The type of connection used on the graph/typeparam>
+	/// <param name="pStartNode">The start node we want to find a path FROM</param>
+	/// <param name="pDestinationNode">The destination node we want to find a path TO</param>
+	/// <param name="context">The scratch buffers to search with, the node indices of the path end up in context.GetPath()</param>
+	/// <returns>true if the destination was reached, otherwise the path only holds the start node</returns>
+	template<class T_NodeType, class T_ConnectionType>
+	inline bool BFS<T_NodeType, T_ConnectionType>::FindPath(T_NodeType* pStartNode, T_NodeType* pDestinationNode, SearchContext& context)
+	{
+		assert(m_pGraph && "<BFS::FindPath>: an implicit grid has no nodes, search it by node index");
+		return FindPath(pStartNode->GetIndex(), pDestinationNode->GetIndex(), context);
+	}
+
+	/// <summary>
+	/// find a path from 2 given node indices, the only way to search an implicit grid
+	/// </summary>
+	/// <param name="startIdx">The index of the node we want to find a path FROM</param>
+	/// <param name="destinationIdx">The index of the node we want to find a path TO</param>
+	/// <param name="context">The scratch buffers to search with, the node indices of the path end up in context.GetPath()</param>
+	/// <returns>true if the destination was reached, otherwise the path only holds the start node</returns>
+	template<class T_NodeType, class T_ConnectionType>
+	inline bool BFS<T_NodeType, T_ConnectionType>::FindPath(int startIdx, int destinationIdx, SearchContext& context)
+	{
+		SearchObservers::None observer{};
+		return FindPath(startIdx, destinationIdx, context, observer);
+	}
+
+	/// <summary>
+	/// find a path from 2 given node indices and report the search to an observer
+	/// </summary>
+	/// <typeparam name="T_SearchObserver">SearchObservers::Recorder to draw the open and closed list, SearchObservers::Statistics to count</typeparam>
+	/// <param name="observer">Gets OnNodeGenerated and OnNodeExpanded calls while searching</param>
+	/// <returns>true if the destination was reached, otherwise the path only holds the start node</returns>
+	template<class T_NodeType, class T_ConnectionType>
+	template<class T_SearchObserver>
+	inline bool BFS<T_NodeType, T_ConnectionType>::FindPath(int startIdx, int destinationIdx, SearchContext& context, T_SearchObserver& observer)
+	{
+		if (m_pImplicitGraph)
+			return Search(*m_pImplicitGraph, startIdx, destinationIdx, context, observer);
+		if (m_pCompressedGraph)
+			return Search(*m_pCompressedGraph, startIdx, destinationIdx, context, observer);
+		return Search(GraphAdjacency<T_NodeType, T_ConnectionType>{ m_pGraph }, startIdx, destinationIdx, context, observer);
+	}
+
+	/// <summary>
+	/// The search itself, written once for the connection lists of the graph and for its compressed copy
+	/// </summary>
+	/// <typeparam name="T_Adjacency">GraphAdjacency, CompressedGraph or ImplicitGridGraph</typeparam>
+	template<class T_NodeType, class T_ConnectionType>
+	template<class T_Adjacency, class T_SearchObserver>
+	inline bool BFS<T_NodeType, T_ConnectionType>::Search(const T_Adjacency& adjacency, int startIdx, int destinationIdx, SearchContext& context, T_SearchObserver& observer) const
 	{
 		//Here we will calculate our path using BFS
 		bool foundPath{ false };
-		std::queue<T_NodeType*> openList;
-		std::map<T_NodeType*, T_NodeType*> closedList;
 
-		openList.push(pStartNode);
+		//every node gets enqueued at most once, so the frontier never has to grow during the search
+		//a node is marked visited when it is generated, its parent is only valid once that bit is set
+		context.BeginBreadthFirstSearch(adjacency.GetNrOfNodes());
+		RingBuffer<int>& openList = context.GetFrontier();
+		NodeBitset& visited = context.GetVisited();
+		std::vector<int>& parents = context.GetParents();
 
-		while (!openList.empty() && !foundPath)
-		{
-			T_NodeType* currentNode = openList.front();
-			openList.pop();
+		visited.Set(startIdx);
+		parents[startIdx] = invalid_node_index;
+		openList.Push(startIdx);
+		foundPath = startIdx == destinationIdx;
 
-			if (currentNode == pDestinationNode)
-			{
-				foundPath = true;
-				break;
-			}
+		while (!openList.IsEmpty() && !foundPath)
+		{
+			int currentIdx = openList.Pop();
+			context.CountExpandedNode();
+			observer.OnNodeExpanded(currentIdx);
 
-			for (auto con : m_pGraph->GetNodeConnections(currentNode->GetIndex()))
+			//stops early when the destination gets generated
+			foundPath = !adjacency.ForEachConnection(currentIdx, [&](int nextIdx, float)
 			{
-				T_NodeType* nextNode = m_pGraph->GetNode(con->GetTo());
-				if (closedList.find(nextNode) == closedList.end())
-				{
-					openList.push(nextNode);
-					openListRender.push_back(nextNode);
-					closedList[nextNode] = currentNode;
-					closedListRender.push_back(currentNode);
-				}
-			}
+				if (visited.TestAndSet(nextIdx))
+					return true;
+
+				parents[nextIdx] = currentIdx;
+				context.CountGeneratedNode();
+				observer.OnNodeGenerated(nextIdx);
+
+				//test for the goal when it's generated instead of when it's expanded, this skips the rest of its layer
+				if (nextIdx == destinationIdx)
+					return false;
+				openList.Push(nextIdx);
+				return true;
+			});
 		}
 
-		//Track back
-		vector<T_NodeType*> path;
+		context.BeginReconstruction();
 
-		T_NodeType* currentNode = nullptr;
+		//Track back, the parents lead straight back to the start
+		std::vector<int>& path = context.GetPath();
 		if (foundPath)
 		{
-			currentNode = pDestinationNode;
-		}
-		else
-		{
-			currentNode = pStartNode;
-		}
-
-		while (currentNode != pStartNode)
-		{
-			path.push_back(currentNode);
-			currentNode = closedList[currentNode];
+			for (int currentIdx = destinationIdx; currentIdx != startIdx; currentIdx = parents[currentIdx])
+			{
+				path.push_back(currentIdx);
+			}
 		}
 
-		path.push_back(pStartNode);
+		path.push_back(startIdx);
 		std::reverse(path.begin(), path.end());
 
-		return path;
-	}
-
-	/// <summary>
-	/// Get the cost between 2 nodes on the graph using the heuristic function
-	/// </summary>
-	/// <typeparam name="T_NodeType">The type of node used on the graph</typeparam>
-	/// <typeparam name="T_ConnectionType"><The type of connection used on the graph/typeparam>
-	/// <param name="pStartNode">the start node</param>
-	/// <param name="pEndNode">the endnode</param>
-	/// <returns>the cost between these nodes</returns>
-	template<class T_NodeType, class T_ConnectionType>
-	inline float BFS<T_NodeType, T_ConnectionType>::GetHeuristicCost(T_NodeType* pStartNode, T_NodeType* pEndNode) const
-	{
-		Vector2 toDestination = m_pGraph->GetNodePos(pEndNode) - m_pGraph->GetNodePos(pStartNode);
-		return m_HeuristicFunction(abs(toDestination.x), abs(toDestination.y));
+		context.EndSearch();
+		return foundPath;
 	}
 }
 
@@ -0,0 +1,358 @@
+#pragma once
+
+#include "framework/EliteAI/EliteGraphs/EliteGraphUtilities/ESearchContext.h"
+#include "framework/EliteAI/EliteGraphs/EliteGraphUtilities/ESearchObservers.h"
+#include "framework/EliteAI/EliteGraphs/EliteGraphUtilities/ECompressedGraph.h"
+#include "framework/EliteAI/EliteGraphs/EliteGraphUtilities/EGraphAdjacency.h"
+#include "framework/EliteAI/EliteGraphs/EImplicitGridGraph.h"
+
+namespace Elite
+{
+	// A* from both ends at once: one half searches forward from the start, the other backward from the destination
+	// every half aims its heuristic at the end the other half started from (front-to-end)
+	// when a half reaches a node the other half reached before, the path through that node is a candidate path
+	// the search stops once the lowest f-cost of either open list can't beat the best candidate anymore
+	// on a directed graph the backward half follows the connections the other way around, from a reversed copy of them
+	template <class T_NodeType, class T_ConnectionType, class T_HeuristicPolicy = HeuristicPolicies::Function>
+	class BidirectionalAStar
+	{
+	public:
+		BidirectionalAStar(IGraph<T_NodeType, T_ConnectionType>* pGraph, T_HeuristicPolicy heuristic = T_HeuristicPolicy{});
+		// searches a grid without node objects, only the FindPath overloads that take node indices work then
+		BidirectionalAStar(const ImplicitGridGraph* pGraph, T_HeuristicPolicy heuristic = T_HeuristicPolicy{});
+
+		std::vector<T_NodeType*> FindPath(T_NodeType* pStartNode, T_NodeType* pDestinationNode);
+		bool FindPath(T_NodeType* pStartNode, T_NodeType* pDestinationNode, SearchContext& context);
+		bool FindPath(int startIdx, int destinationIdx, SearchContext& context);
+		// tells the observer about every node it generates and expands, see SearchObservers
+		template<class T_SearchObserver>
+		bool FindPath(int startIdx, int destinationIdx, SearchContext& context, T_SearchObserver& observer);
+
+		void SetHeuristicFunction(T_HeuristicPolicy heuristic) { m_Heuristic = heuristic; }
+		// search the compressed copy of the graph instead of its connection lists, nullptr to go back to the lists
+		// the copy has to be kept up to date with the graph by the caller
+		void SetCompressedGraph(const CompressedGraph* pCompressedGraph) { m_pCompressedGraph = pCompressedGraph; }
+		// copies the connections of a directed graph the other way around again, call this after the graph was edited
+		void UpdateReverseGraph();
+
+	private:
+		template<class T_ForwardAdjacency, class T_BackwardAdjacency, class T_SearchObserver>
+		bool Search(const T_ForwardAdjacency& forwardAdjacency, const T_BackwardAdjacency& backwardAdjacency, int startIdx, int destinationIdx,
+			SearchContext& context, T_SearchObserver& observer) const;
+		template<class T_Adjacency, class T_SearchObserver>
+		void ExpandNode(const T_Adjacency& adjacency, IndexedPriorityQueue<float>& openList, SearchStateTable& nodeStates, const SearchStateTable& otherNodeStates,
+			int currentIdx, int targetIdx, float& bestCost, int& meetingIdx, SearchContext& context, T_SearchObserver& observer) const;
+		float GetHeuristicCost(int fromIdx, int toIdx) const;
+
+		IGraph<T_NodeType, T_ConnectionType>* m_pGraph;
+		const CompressedGraph* m_pCompressedGraph = nullptr;
+		const ImplicitGridGraph* m_pImplicitGraph = nullptr;
+		T_HeuristicPolicy m_Heuristic;
+		// the columns of the graph when it's a GridGraph, the positions of its nodes follow from their indices then, otherwise 0
+		int m_NrOfGridColumns;
+
+		// the connections leading to every node, only built for a directed graph
+		CompressedGraph m_ReverseGraph;
+
+		// used by the FindPath overload that doesn't get a context
+		SearchContext m_Context;
+	};
+
+	template<class T_NodeType, class T_ConnectionType, class T_HeuristicPolicy>
+	BidirectionalAStar<T_NodeType, T_ConnectionType, T_HeuristicPolicy>::BidirectionalAStar(IGraph<T_NodeType, T_ConnectionType>* pGraph, T_HeuristicPolicy heuristic)
+		: m_pGraph{ pGraph }
+		, m_Heuristic{ heuristic }
+	{
+		const GridGraph<T_NodeType, T_ConnectionType>* pGridGraph{ dynamic_cast<GridGraph<T_NodeType, T_ConnectionType>*>(pGraph) };
+		m_NrOfGridColumns = pGridGraph ? pGridGraph->GetColumns() : 0;
+		UpdateReverseGraph();
+	}
+
+	template<class T_NodeType, class T_ConnectionType, class T_HeuristicPolicy>
+	BidirectionalAStar<T_NodeType, T_ConnectionType, T_HeuristicPolicy>::BidirectionalAStar(const ImplicitGridGraph* pGraph, T_HeuristicPolicy heuristic)
+		: m_pGraph{ nullptr }
+		, m_pImplicitGraph{ pGraph }
+		, m_Heuristic{ heuristic }
+		, m_NrOfGridColumns{ pGraph->GetColumns() }
+	{
+	}
+
+	template<class T_NodeType, class T_ConnectionType, class T_HeuristicPolicy>
+	inline void BidirectionalAStar<T_NodeType, T_ConnectionType, T_HeuristicPolicy>::UpdateReverseGraph()
+	{
+		//an undirected graph has every connection both ways already, the backward half searches the graph itself
+		if (m_pGraph && m_pGraph->IsDirectionalGraph())
+			m_ReverseGraph.BuildReversed(m_pGraph);
+	}
+
+	/// <summary>
+	/// find a path from 2 given nodes on the graph
+	/// </summary>
+	/// <typeparam name="T_NodeType">The type of node used on the graph</typeparam>
+	/// <typeparam name="T_ConnectionType"><The type of connection used on the graph/typeparam>
+	/// <param name="pStartNode">The start node we want to find a path FROM</param>
+	/// <param name="pDestinationNode">The destination node we want to find a path TO</param>
+	/// <returns>returns the path between the 2 nodes</returns>
+	template<class T_NodeType, class T_ConnectionType, class T_HeuristicPolicy>
+	inline std::vector<T_NodeType*> BidirectionalAStar<T_NodeType, T_ConnectionType, T_HeuristicPolicy>::FindPath(T_NodeType* pStartNode, T_NodeType* pDestinationNode)
+	{
+		FindPath(pStartNode, pDestinationNode, m_Context);
+
+		vector<T_NodeType*> finalPath;
+		finalPath.reserve(m_Context.GetPath().size());
+		for (int idx : m_Context.GetPath())
+			finalPath.push_back(m_pGraph->GetNode(idx));
+
+		return finalPath;
+	}
+
+	/// <summary>
+	/// find a path from 2 given nodes on the graph, using the buffers of the given context so repeated queries don't allocate
+	/// </summary>
+	/// <typeparam name="T_NodeType">The type of node used on the graph</typeparam>
+	/// <typeparam name="T_ConnectionType"><The type of connection used on the graph/typeparam>
+	/// <param name="pStartNode">The start node we want to find a path FROM</param>
+	/// <param name="pDestinationNode">The destination node we want to find a path TO</param>
+	/// <param name="context">The scratch buffers to search with, the node indices of the path end up in context.GetPath()</param>
+	/// <returns>true if the destination was reached, otherwise the path leads to the node closest to the destination</returns>
+	template<class T_NodeType, class T_ConnectionType, class T_HeuristicPolicy>
+	inline bool BidirectionalAStar<T_NodeType, T_ConnectionType, T_HeuristicPolicy>::FindPath(T_NodeType* pStartNode, T_NodeType* pDestinationNode, SearchContext& context)
+	{
+		assert(m_pGraph && "<BidirectionalAStar::FindPath>: an implicit grid has no nodes, search it by node index");
+		return FindPath(pStartNode->GetIndex(), pDestinationNode->GetIndex(), context);
+	}
+
+	/// <summary>
+	/// find a path from 2 given node indices, the only way to search an implicit grid
+	/// </summary>
+	/// <param name="startIdx">The index of the node we want to find a path FROM</param>
+	/// <param name="destinationIdx">The index of the node we want to find a path TO</param>
+	/// <param name="context">The scratch buffers to search with, the node indices of the path end up in context.GetPath()</param>
+	/// <returns>true if the destination was reached, otherwise the path leads to the node closest to the destination</returns>
+	template<class T_NodeType, class T_ConnectionType, class T_HeuristicPolicy>
+	inline bool BidirectionalAStar<T_NodeType, T_ConnectionType, T_HeuristicPolicy>::FindPath(int startIdx, int destinationIdx, SearchContext& context)
+	{
+		SearchObservers::None observer{};
+		return FindPath(startIdx, destinationIdx, context, observer);
+	}
+
+	/// <summary>
+	/// find a path from 2 given node indices and report the search to an observer
+	/// </summary>
+	/// <typeparam name="T_SearchObserver">SearchObservers::Recorder to draw the open and closed list, SearchObservers::Statistics to count</typeparam>
+	/// <param name="observer">Gets OnNodeGenerated and OnNodeExpanded calls while searching, from both halves</param>
+	/// <returns>true if the destination was reached, otherwise the path leads to the node closest to the destination</returns>
+	template<class T_NodeType, class T_ConnectionType, class T_HeuristicPolicy>
+	template<class T_SearchObserver>
+	inline bool BidirectionalAStar<T_NodeType, T_ConnectionType, T_HeuristicPolicy>::FindPath(int startIdx, int destinationIdx, SearchContext& context, T_SearchObserver& observer)
+	{
+		if (m_pImplicitGraph)
+			return Search(*m_pImplicitGraph, *m_pImplicitGraph, startIdx, destinationIdx, context, observer);
+
+		const bool isDirectional{ m_pGraph->IsDirectionalGraph() };
+		assert((!isDirectional || m_ReverseGraph.GetNrOfNodes() == m_pGraph->GetNrOfNodes()) && "<BidirectionalAStar::FindPath>: the reverse graph is out of date, call UpdateReverseGraph");
+		if (m_pCompressedGraph)
+		{
+			if (isDirectional)
+				return Search(*m_pCompressedGraph, m_ReverseGraph, startIdx, destinationIdx, context, observer);
+			return Search(*m_pCompressedGraph, *m_pCompressedGraph, startIdx, destinationIdx, context, observer);
+		}
+
+		const GraphAdjacency<T_NodeType, T_ConnectionType> adjacency{ m_pGraph };
+		if (isDirectional)
+			return Search(adjacency, m_ReverseGraph, startIdx, destinationIdx, context, observer);
+		return Search(adjacency, adjacency, startIdx, destinationIdx, context, observer);
+	}
+
+	/// <summary>
+	/// The search itself, written once for every combination of the graph, its compressed copy and its reversed copy
+	/// </summary>
+	/// <typeparam name="T_ForwardAdjacency">GraphAdjacency, CompressedGraph or ImplicitGridGraph with the connections leaving every node</typeparam>
+	/// <typeparam name="T_BackwardAdjacency">The same for the connections leading to every node</typeparam>
+	template<class T_NodeType, class T_ConnectionType, class T_HeuristicPolicy>
+	template<class T_ForwardAdjacency, class T_BackwardAdjacency, class T_SearchObserver>
+	inline bool BidirectionalAStar<T_NodeType, T_ConnectionType, T_HeuristicPolicy>::Search(const T_ForwardAdjacency& forwardAdjacency, const T_BackwardAdjacency& backwardAdjacency,
+		int startIdx, int destinationIdx, SearchContext& context, T_SearchObserver& observer) const
+	{
+		//cost of the cheapest path found so far and the node both halves met in on it
+		float bestCost{ FLT_MAX };
+		int meetingIdx{ invalid_node_index };
+
+		//closed node of the forward half closest to the destination, the path leads there when the destination can't be reached
+		int nearestIdx{ startIdx };
+		float nearestHeuristicCost{ FLT_MAX };
+
+		//start a new search: every node becomes unvisited and both open lists are emptied
+		context.BeginBidirectionalSearch(forwardAdjacency.GetNrOfNodes());
+		IndexedPriorityQueue<float>& forwardOpenList = context.GetOpenList();
+		SearchStateTable& forwardNodeStates = context.GetNodeStates();
+		IndexedPriorityQueue<float>& backwardOpenList = context.GetReverseOpenList();
+		SearchStateTable& backwardNodeStates = context.GetReverseNodeStates();
+
+		SearchNodeState& startState = forwardNodeStates.Visit(startIdx);
+		startState.estimatedTotalCost = GetHeuristicCost(startIdx, destinationIdx);
+		startState.status = SearchNodeStatus::Open;
+		forwardOpenList.Push(startIdx, startState.estimatedTotalCost);
+
+		SearchNodeState& destinationState = backwardNodeStates.Visit(destinationIdx);
+		destinationState.estimatedTotalCost = GetHeuristicCost(startIdx, destinationIdx);
+		destinationState.status = SearchNodeStatus::Open;
+		backwardOpenList.Push(destinationIdx, destinationState.estimatedTotalCost);
+
+		if (startIdx == destinationIdx)
+		{
+			bestCost = 0.f;
+			meetingIdx = startIdx;
+		}
+
+		while (!forwardOpenList.IsEmpty() && !backwardOpenList.IsEmpty())
+		{
+			//the f-cost of an open node is a lower bound for every path through it (as long as the heuristic doesn't overestimate),
+			//once the lowest one of either half reaches the best path, no path left to find through that half can be cheaper
+			const float forwardLowestCost{ forwardOpenList.GetKey(forwardOpenList.Top()) };
+			const float backwardLowestCost{ backwardOpenList.GetKey(backwardOpenList.Top()) };
+			if (bestCost <= std::max(forwardLowestCost, backwardLowestCost))
+				break;
+
+			//expand the half with the smaller open list, so both halves grow about as fast
+			if (forwardOpenList.Size() <= backwardOpenList.Size())
+			{
+				const int currentIdx{ forwardOpenList.Pop() };
+				ExpandNode(forwardAdjacency, forwardOpenList, forwardNodeStates, backwardNodeStates, currentIdx, destinationIdx, bestCost, meetingIdx, context, observer);
+
+				const SearchNodeState& currentState = forwardNodeStates.GetState(currentIdx);
+				float heuristicCost{ currentState.estimatedTotalCost - currentState.costSoFar };
+				if (heuristicCost < nearestHeuristicCost)
+				{
+					nearestHeuristicCost = heuristicCost;
+					nearestIdx = currentIdx;
+				}
+			}
+			else
+			{
+				const int currentIdx{ backwardOpenList.Pop() };
+				ExpandNode(backwardAdjacency, backwardOpenList, backwardNodeStates, forwardNodeStates, currentIdx, startIdx, bestCost, meetingIdx, context, observer);
+			}
+		}
+		const bool foundPath{ meetingIdx != invalid_node_index };
+		context.BeginReconstruction();
+
+		//the forward parents lead from the meeting node back to the start (added in reverse order),
+		//the backward parents lead from it on to the destination
+		std::vector<int>& finalPath = context.GetPath();
+		for (int currentIdx = foundPath ? meetingIdx : nearestIdx; currentIdx != invalid_node_index; currentIdx = forwardNodeStates.GetState(currentIdx).parentIdx)
+		{
+			finalPath.push_back(currentIdx);
+		}
+		std::reverse(finalPath.begin(), finalPath.end());
+
+		if (foundPath)
+		{
+			for (int currentIdx = backwardNodeStates.GetState(meetingIdx).parentIdx; currentIdx != invalid_node_index; currentIdx = backwardNodeStates.GetState(currentIdx).parentIdx)
+			{
+				finalPath.push_back(currentIdx);
+			}
+		}
+
+		context.EndSearch();
+		return foundPath;
+	}
+
+	/// <summary>
+	/// Expand a node of one half of the search and look for a cheaper path where its neighbors meet the other half
+	/// </summary>
+	/// <param name="adjacency">The connections this half follows, leaving every node for the forward half and leading to it for the backward half</param>
+	/// <param name="openList">The open list of this half, the node was already taken off it</param>
+	/// <param name="nodeStates">The node states of this half</param>
+	/// <param name="otherNodeStates">The node states of the other half</param>
+	/// <param name="currentIdx">The node to expand</param>
+	/// <param name="targetIdx">Where this half is heading: the destination for the forward half, the start for the backward half</param>
+	/// <param name="bestCost">Cost of the cheapest path found so far, gets lowered when a cheaper one is found</param>
+	/// <param name="meetingIdx">The node both halves meet in on that path</param>
+	template<class T_NodeType, class T_ConnectionType, class T_HeuristicPolicy>
+	template<class T_Adjacency, class T_SearchObserver>
+	inline void BidirectionalAStar<T_NodeType, T_ConnectionType, T_HeuristicPolicy>::ExpandNode(const T_Adjacency& adjacency, IndexedPriorityQueue<float>& openList,
+		SearchStateTable& nodeStates, const SearchStateTable& otherNodeStates, int currentIdx, int targetIdx, float& bestCost, int& meetingIdx,
+		SearchContext& context, T_SearchObserver& observer) const
+	{
+		context.CountExpandedNode();
+		SearchNodeState& currentState = nodeStates.GetState(currentIdx);
+
+		adjacency.ForEachConnection(currentIdx, [&](int neighborIdx, float connectionCost)
+		{
+			float costSoFar = currentState.costSoFar + connectionCost;
+
+			//if the neighbor is already on the open or closed list of this half, only continue when this path to it is cheaper
+			//a cheaper path to a closed neighbor reopens it
+			bool isOnOpenList{ false };
+			bool isClosed{ false };
+			if (nodeStates.IsVisited(neighborIdx))
+			{
+				const SearchNodeState& neighborState = nodeStates.GetState(neighborIdx);
+				if (neighborState.costSoFar <= costSoFar)
+				{
+					return true;
+				}
+				isOnOpenList = neighborState.status == SearchNodeStatus::Open;
+				isClosed = neighborState.status == SearchNodeStatus::Closed;
+			}
+
+			SearchNodeState& neighborState = nodeStates.Visit(neighborIdx);
+			neighborState.costSoFar = costSoFar;
+			neighborState.estimatedTotalCost = costSoFar + GetHeuristicCost(neighborIdx, targetIdx);
+			neighborState.parentIdx = currentIdx;
+
+			//the other half got here as well, so there is a path through this neighbor
+			if (otherNodeStates.IsVisited(neighborIdx))
+			{
+				const float pathCost{ costSoFar + otherNodeStates.GetState(neighborIdx).costSoFar };
+				if (pathCost < bestCost)
+				{
+					bestCost = pathCost;
+					meetingIdx = neighborIdx;
+				}
+			}
+
+			//a neighbor that can't lead to a path cheaper than the best one doesn't go on the open list,
+			//it keeps its cost and parent so the path can still be followed through it
+			//(one that is on it already stays there, the search stops before it gets to it)
+			if (!isOnOpenList && neighborState.estimatedTotalCost >= bestCost)
+			{
+				return true;
+			}
+			if (isClosed)
+				context.CountReopenedNode();
+
+			neighborState.status = SearchNodeStatus::Open;
+			if (isOnOpenList)
+				openList.DecreaseKey(neighborIdx, neighborState.estimatedTotalCost);
+			else
+				openList.Push(neighborIdx, neighborState.estimatedTotalCost);
+			context.CountGeneratedNode();
+			observer.OnNodeGenerated(neighborIdx);
+			return true;
+		});
+		//close the current node, it was already taken off the open list
+		currentState.status = SearchNodeStatus::Closed;
+		observer.OnNodeExpanded(currentIdx);
+	}
+
+	/// <summary>
+	/// Get the cost between 2 nodes on the graph using the heuristic function
+	/// </summary>
+	/// <param name="fromIdx">the start node</param>
+	/// <param name="toIdx">the endnode</param>
+	/// <returns>the cost between these nodes</returns>
+	template<class T_NodeType, class T_ConnectionType, class T_HeuristicPolicy>
+	inline float BidirectionalAStar<T_NodeType, T_ConnectionType, T_HeuristicPolicy>::GetHeuristicCost(int fromIdx, int toIdx) const
+	{
+		//on a grid the column and row distance is enough, no need to ask the graph for positions
+		if (m_NrOfGridColumns > 0)
+		{
+			return m_Heuristic(abs(toIdx % m_NrOfGridColumns - fromIdx % m_NrOfGridColumns), abs(toIdx / m_NrOfGridColumns - fromIdx / m_NrOfGridColumns));
+		}
+
+		Vector2 toDestination = m_pGraph->GetNodePos(toIdx) - m_pGraph->GetNodePos(fromIdx);
+		return m_Heuristic(abs(toDestination.x), abs(toDestination.y));
+	}
+}
@@ -0,0 +1,484 @@
+#pragma once
+
+#include "framework/EliteAI/EliteGraphs/EliteGraphAlgorithms/EJPS.h"
+#include "framework/EliteAI/EliteGraphs/EliteGraphUtilities/EWalkabilityGrid.h"
+
+namespace Elite
+{
+	// Jump Point Search on a bit-packed copy of the grid: straight jumps read 64 cells of the current line and both lines next to it
+	// at once and find the first obstacle or forced neighbor with a single bit scan
+	// the bits only hold walkable or blocked, so this only runs on grids with uniform costs (no mud)
+	// other grids are handed to the regular JPS
+	template <class T_NodeType, class T_ConnectionType, class T_HeuristicPolicy = HeuristicPolicies::Function>
+	class BlockJPS
+	{
+	public:
+		BlockJPS(GridGraph<T_NodeType, T_ConnectionType>* pGraph, T_HeuristicPolicy heuristic = T_HeuristicPolicy{});
+
+		std::vector<T_NodeType*> FindPath(T_NodeType* pStartNode, T_NodeType* pDestinationNode);
+		bool FindPath(T_NodeType* pStartNode, T_NodeType* pDestinationNode, SearchContext& context);
+		bool FindPath(int startIdx, int destinationIdx, SearchContext& context);
+		// tells the observer about every node it generates and expands, see SearchObservers
+		template<class T_SearchObserver>
+		bool FindPath(int startIdx, int destinationIdx, SearchContext& context, T_SearchObserver& observer);
+
+		// reads the walkability bits from the graph again
+		void UpdateGrid();
+		// reads the bits around a batch of edited nodes again, big batches read the whole graph again
+		void UpdateNodes(const std::vector<int>& nodeIndices);
+		const WalkabilityGrid& GetGrid() const { return m_Grid; }
+
+		void SetHeuristicFunction(T_HeuristicPolicy heuristic);
+		// when set, FindPath returns every cell on the path instead of only the jump points
+		void SetExpandPath(bool expandPath);
+
+	private:
+		void IdentifySuccessors(int col, int row, int parentCol, int parentRow, int destinationCol, int destinationRow);
+		void AddSuccessor(int col, int row, int deltaCol, int deltaRow, int destinationCol, int destinationRow);
+		int JumpStraight(const WalkabilityGrid::BitPlane& plane, int line, int pos, int step, int destinationLine, int destinationPos);
+		bool JumpDiagonal(int& col, int& row, int deltaCol, int deltaRow, int destinationCol, int destinationRow);
+		float GetHeuristicCost(int fromIdx, int toIdx) const;
+
+		GridGraph<T_NodeType, T_ConnectionType>* m_pGraph;
+		T_HeuristicPolicy m_Heuristic;
+		bool m_ExpandPath = false;
+
+		WalkabilityGrid m_Grid;
+		JPS<T_NodeType, T_ConnectionType, T_HeuristicPolicy> m_FallbackJPS;
+
+		// jump points found by IdentifySuccessors, with the amount of steps it took to get there
+		struct Successor
+		{
+			int idx;
+			int nrOfSteps;
+			bool isDiagonal;
+		};
+		vector<Successor> m_Successors;
+		// diagonal steps and line reads of the current search, handed to the search statistics at the end
+		int m_NrOfJumpSteps = 0;
+
+		// used by the FindPath overload that doesn't get a context
+		SearchContext m_Context;
+	};
+
+	template<class T_NodeType, class T_ConnectionType, class T_HeuristicPolicy>
+	inline BlockJPS<T_NodeType, T_ConnectionType, T_HeuristicPolicy>::BlockJPS(GridGraph<T_NodeType, T_ConnectionType>* pGraph, T_HeuristicPolicy heuristic)
+		: m_pGraph{ pGraph }
+		, m_Heuristic{ heuristic }
+		, m_FallbackJPS{ pGraph, heuristic }
+	{
+		m_Successors.reserve(8);
+		UpdateGrid();
+	}
+
+	template<class T_NodeType, class T_ConnectionType, class T_HeuristicPolicy>
+	inline void BlockJPS<T_NodeType, T_ConnectionType, T_HeuristicPolicy>::UpdateGrid()
+	{
+		m_Grid.Build(m_pGraph);
+	}
+
+	template<class T_NodeType, class T_ConnectionType, class T_HeuristicPolicy>
+	inline void BlockJPS<T_NodeType, T_ConnectionType, T_HeuristicPolicy>::UpdateNodes(const std::vector<int>& nodeIndices)
+	{
+		//every changed cell checks a 5x5 area again, past a twentieth of the grid building it all again is cheaper
+		const int nrOfColumns{ m_pGraph->GetColumns() };
+		if (int(nodeIndices.size()) > nrOfColumns * m_pGraph->GetRows() / 20)
+		{
+			UpdateGrid();
+			return;
+		}
+
+		for (int idx : nodeIndices)
+		{
+			m_Grid.UpdateCell(m_pGraph, idx % nrOfColumns, idx / nrOfColumns);
+		}
+	}
+
+	template<class T_NodeType, class T_ConnectionType, class T_HeuristicPolicy>
+	inline void BlockJPS<T_NodeType, T_ConnectionType, T_HeuristicPolicy>::SetHeuristicFunction(T_HeuristicPolicy heuristic)
+	{
+		m_Heuristic = heuristic;
+		m_FallbackJPS.SetHeuristicFunction(heuristic);
+	}
+
+	template<class T_NodeType, class T_ConnectionType, class T_HeuristicPolicy>
+	inline void BlockJPS<T_NodeType, T_ConnectionType, T_HeuristicPolicy>::SetExpandPath(bool expandPath)
+	{
+		m_ExpandPath = expandPath;
+		m_FallbackJPS.SetExpandPath(expandPath);
+	}
+
+	/// <summary>
+	/// find a path from 2 given nodes on the graph
+	/// </summary>
+	/// <typeparam name="T_NodeType">The type of node used on the graph</typeparam>
+	/// <typeparam name="T_ConnectionType"><The type of connection used on the graph/typeparam>
+	/// <param name="pStartNode">The start node we want to find a path FROM</param>
+	/// <param name="pDestinationNode">The destination node we want to find a path TO</param>
+	/// <returns>returns the path between the 2 nodes</returns>
+	template<class T_NodeType, class T_ConnectionType, class T_HeuristicPolicy>
+	inline std::vector<T_NodeType*> BlockJPS<T_NodeType, T_ConnectionType, T_HeuristicPolicy>::FindPath(T_NodeType* pStartNode, T_NodeType* pDestinationNode)
+	{
+		FindPath(pStartNode, pDestinationNode, m_Context);
+
+		vector<T_NodeType*> finalPath;
+		finalPath.reserve(m_Context.GetPath().size());
+		for (int idx : m_Context.GetPath())
+			finalPath.push_back(m_pGraph->GetNode(idx));
+
+		return finalPath;
+	}
+
+	/// <summary>
+	/// find a path from 2 given nodes on the graph, using the buffers of the given context so repeated queries don't allocate
+	/// </summary>
+	/// <typeparam name="T_NodeType">The type of node used on the graph</typeparam>
+	/// <typeparam name="T_ConnectionType"><The type of connection used on the graph/typeparam>
+	/// <param name="pStartNode">The start node we want to find a path FROM</param>
+	/// <param name="pDestinationNode">The destination node we want to find a path TO</param>
+	/// <param name="context">The scratch buffers to search with, the node indices of the jump points (or of all cells, see SetExpandPath) on the path end up in context.GetPath()</param>
+	/// <returns>true if the destination was reached, otherwise the path leads to the node closest to the destination</returns>
+	template<class T_NodeType, class T_ConnectionType, class T_HeuristicPolicy>
+	inline bool BlockJPS<T_NodeType, T_ConnectionType, T_HeuristicPolicy>::FindPath(T_NodeType* pStartNode, T_NodeType* pDestinationNode, SearchContext& context)
+	{
+		return FindPath(pStartNode->GetIndex(), pDestinationNode->GetIndex(), context);
+	}
+
+	/// <summary>
+	/// find a path from 2 given node indices
+	/// </summary>
+	/// <param name="startIdx">The index of the node we want to find a path FROM</param>
+	/// <param name="destinationIdx">The index of the node we want to find a path TO</param>
+	/// <param name="context">The scratch buffers to search with, the node indices of the jump points (or of all cells, see SetExpandPath) on the path end up in context.GetPath()</param>
+	/// <returns>true if the destination was reached, otherwise the path leads to the node closest to the destination</returns>
+	template<class T_NodeType, class T_ConnectionType, class T_HeuristicPolicy>
+	inline bool BlockJPS<T_NodeType, T_ConnectionType, T_HeuristicPolicy>::FindPath(int startIdx, int destinationIdx, SearchContext& context)
+	{
+		SearchObservers::None observer{};
+		return FindPath(startIdx, destinationIdx, context, observer);
+	}
+
+	/// <summary>
+	/// find a path from 2 given node indices and report the search to an observer
+	/// </summary>
+	/// <typeparam name="T_SearchObserver">SearchObservers::Recorder to draw the open and closed list, SearchObservers::Statistics to count</typeparam>
+	/// <param name="observer">Gets OnNodeGenerated and OnNodeExpanded calls while searching, also when the search is handed to the regular JPS</param>
+	/// <returns>true if the destination was reached, otherwise the path leads to the node closest to the destination</returns>
+	template<class T_NodeType, class T_ConnectionType, class T_HeuristicPolicy>
+	template<class T_SearchObserver>
+	inline bool BlockJPS<T_NodeType, T_ConnectionType, T_HeuristicPolicy>::FindPath(int startIdx, int destinationIdx, SearchContext& context, T_SearchObserver& observer)
+	{
+		//the bits can't hold different costs, let the regular JPS handle those grids
+		if (!m_Grid.IsUniformCost())
+		{
+			return m_FallbackJPS.FindPath(startIdx, destinationIdx, context, observer);
+		}
+
+		bool foundPath{ false };
+		const int nrOfColumns{ m_Grid.GetColumns() };
+		const int destinationCol{ destinationIdx % nrOfColumns };
+		const int destinationRow{ destinationIdx / nrOfColumns };
+
+		//closed jump point closest to the destination, the path leads there when the destination can't be reached
+		int nearestIdx{ startIdx };
+		float nearestHeuristicCost{ FLT_MAX };
+
+		//start a new search: every node becomes unvisited and the open list is emptied
+		context.BeginSearch(m_pGraph->GetNrOfNodes());
+		IndexedPriorityQueue<float>& openList = context.GetOpenList();
+		SearchStateTable& nodeStates = context.GetNodeStates();
+		m_NrOfJumpSteps = 0;
+
+		SearchNodeState& startState = nodeStates.Visit(startIdx);
+		startState.estimatedTotalCost = GetHeuristicCost(startIdx, destinationIdx);
+		startState.status = SearchNodeStatus::Open;
+		openList.Push(startIdx, startState.estimatedTotalCost);
+
+		while (!openList.IsEmpty())
+		{
+			//take the jump point with the lowest estimated total cost off the open list
+			const int currentIdx{ openList.Pop() };
+			if (currentIdx == destinationIdx)
+			{
+				foundPath = true;
+				break;
+			}
+			context.CountExpandedNode();
+
+			SearchNodeState& currentState = nodeStates.GetState(currentIdx);
+			const int col{ currentIdx % nrOfColumns };
+			const int row{ currentIdx / nrOfColumns };
+			const int parentCol{ currentState.parentIdx != invalid_node_index ? currentState.parentIdx % nrOfColumns : col };
+			const int parentRow{ currentState.parentIdx != invalid_node_index ? currentState.parentIdx / nrOfColumns : row };
+
+			IdentifySuccessors(col, row, parentCol, parentRow, destinationCol, destinationRow);
+			for (const Successor& successor : m_Successors)
+			{
+				const float stepCost{ successor.isDiagonal ? m_Grid.GetCostDiagonal() : m_Grid.GetCostStraight() };
+				const float costSoFar{ currentState.costSoFar + successor.nrOfSteps * stepCost };
+
+				//if the successor is already on the open or closed list, only continue when this jump to it is cheaper
+				bool isOnOpenList{ false };
+				if (nodeStates.IsVisited(successor.idx))
+				{
+					const SearchNodeState& successorState = nodeStates.GetState(successor.idx);
+					if (successorState.costSoFar <= costSoFar)
+					{
+						continue;
+					}
+					isOnOpenList = successorState.status == SearchNodeStatus::Open;
+					if (!isOnOpenList)
+						context.CountReopenedNode();
+				}
+
+				SearchNodeState& successorState = nodeStates.Visit(successor.idx);
+				successorState.costSoFar = costSoFar;
+				successorState.estimatedTotalCost = costSoFar + GetHeuristicCost(successor.idx, destinationIdx);
+				successorState.parentIdx = currentIdx;
+				successorState.status = SearchNodeStatus::Open;
+				if (isOnOpenList)
+					openList.DecreaseKey(successor.idx, successorState.estimatedTotalCost);
+				else
+					openList.Push(successor.idx, successorState.estimatedTotalCost);
+				context.CountGeneratedNode();
+				observer.OnNodeGenerated(successor.idx);
+			}
+
+			currentState.status = SearchNodeStatus::Closed;
+			observer.OnNodeExpanded(currentIdx);
+
+			float heuristicCost{ currentState.estimatedTotalCost - currentState.costSoFar };
+			if (heuristicCost < nearestHeuristicCost)
+			{
+				nearestHeuristicCost = heuristicCost;
+				nearestIdx = currentIdx;
+			}
+		}
+		context.CountJumpSteps(m_NrOfJumpSteps);
+		context.BeginReconstruction();
+
+		//follow the jump parents back to the start (jump points get added in reverse order)
+		std::vector<int>& finalPath = context.GetPath();
+		for (int currentIdx = foundPath ? destinationIdx : nearestIdx; currentIdx != invalid_node_index; currentIdx = nodeStates.GetState(currentIdx).parentIdx)
+		{
+			finalPath.push_back(currentIdx);
+		}
+		std::reverse(finalPath.begin(), finalPath.end());
+
+		if (m_ExpandPath)
+		{
+			ExpandGridPath(finalPath, nrOfColumns);
+		}
+
+		context.EndSearch();
+		return foundPath;
+	}
+
+	/// <summary>
+	/// Fill m_Successors with the jump points reachable from a cell, only looking in the natural and forced directions
+	/// </summary>
+	/// <param name="col">column of the cell</param>
+	/// <param name="row">row of the cell</param>
+	/// <param name="parentCol">column of the jump point we came from (the cell itself for the start)</param>
+	/// <param name="parentRow">row of the jump point we came from (the cell itself for the start)</param>
+	/// <param name="destinationCol">column of the destination</param>
+	/// <param name="destinationRow">row of the destination</param>
+	template<class T_NodeType, class T_ConnectionType, class T_HeuristicPolicy>
+	inline void BlockJPS<T_NodeType, T_ConnectionType, T_HeuristicPolicy>::IdentifySuccessors(int col, int row, int parentCol, int parentRow, int destinationCol, int destinationRow)
+	{
+		m_Successors.clear();
+
+		const int deltaCol{ (col > parentCol) - (col < parentCol) };
+		const int deltaRow{ (row > parentRow) - (row < parentRow) };
+
+		//the start has no direction yet, every neighbor is a successor
+		if (deltaCol == 0 && deltaRow == 0)
+		{
+			for (int neighborDeltaRow = -1; neighborDeltaRow <= 1; ++neighborDeltaRow)
+			{
+				for (int neighborDeltaCol = -1; neighborDeltaCol <= 1; ++neighborDeltaCol)
+				{
+					if (neighborDeltaCol != 0 || neighborDeltaRow != 0)
+						AddSuccessor(col, row, neighborDeltaCol, neighborDeltaRow, destinationCol, destinationRow);
+				}
+			}
+			return;
+		}
+
+		//diagonal movement: continue diagonally and along both of its straight components
+		//a blocked cell behind us on one side forces the diagonal on that side
+		if (deltaCol != 0 && deltaRow != 0)
+		{
+			AddSuccessor(col, row, deltaCol, 0, destinationCol, destinationRow);
+			AddSuccessor(col, row, 0, deltaRow, destinationCol, destinationRow);
+			AddSuccessor(col, row, deltaCol, deltaRow, destinationCol, destinationRow);
+			if (!m_Grid.IsWalkable(col - deltaCol, row))
+				AddSuccessor(col, row, -deltaCol, deltaRow, destinationCol, destinationRow);
+			if (!m_Grid.IsWalkable(col, row - deltaRow))
+				AddSuccessor(col, row, deltaCol, -deltaRow, destinationCol, destinationRow);
+			return;
+		}
+
+		//straight movement: continue straight, a blocked cell to the side forces the diagonal past it
+		AddSuccessor(col, row, deltaCol, deltaRow, destinationCol, destinationRow);
+		if (deltaCol != 0)
+		{
+			if (!m_Grid.IsWalkable(col, row - 1))
+				AddSuccessor(col, row, deltaCol, -1, destinationCol, destinationRow);
+			if (!m_Grid.IsWalkable(col, row + 1))
+				AddSuccessor(col, row, deltaCol, 1, destinationCol, destinationRow);
+		}
+		else
+		{
+			if (!m_Grid.IsWalkable(col - 1, row))
+				AddSuccessor(col, row, -1, deltaRow, destinationCol, destinationRow);
+			if (!m_Grid.IsWalkable(col + 1, row))
+				AddSuccessor(col, row, 1, deltaRow, destinationCol, destinationRow);
+		}
+	}
+
+	/// <summary>
+	/// Jump from a cell in a direction and add the jump point to m_Successors if there is one
+	/// </summary>
+	template<class T_NodeType, class T_ConnectionType, class T_HeuristicPolicy>
+	inline void BlockJPS<T_NodeType, T_ConnectionType, T_HeuristicPolicy>::AddSuccessor(int col, int row, int deltaCol, int deltaRow, int destinationCol, int destinationRow)
+	{
+		if (!m_Grid.IsWalkable(col + deltaCol, row + deltaRow))
+			return;
+
+		int jumpCol{ col };
+		int jumpRow{ row };
+		if (deltaRow == 0)
+		{
+			jumpCol = JumpStraight(m_Grid.GetRowMajor(), row, col, deltaCol, destinationRow, destinationCol);
+			if (jumpCol < 0)
+				return;
+		}
+		else if (deltaCol == 0)
+		{
+			jumpRow = JumpStraight(m_Grid.GetColumnMajor(), col, row, deltaRow, destinationCol, destinationRow);
+			if (jumpRow < 0)
+				return;
+		}
+		else if (!JumpDiagonal(jumpCol, jumpRow, deltaCol, deltaRow, destinationCol, destinationRow))
+		{
+			return;
+		}
+
+		Successor successor;
+		successor.idx = m_pGraph->GetIndex(jumpCol, jumpRow);
+		successor.nrOfSteps = deltaCol != 0 ? abs(jumpCol - col) : abs(jumpRow - row);
+		successor.isDiagonal = deltaCol != 0 && deltaRow != 0;
+		m_Successors.push_back(successor);
+	}
+
+	/// <summary>
+	/// Jump along a line, 63 cells at a time
+	/// </summary>
+	/// <param name="plane">the copy of the grid the line lies in (rows for horizontal jumps, columns for vertical ones)</param>
+	/// <param name="line">the line to jump along</param>
+	/// <param name="pos">the cell to jump from</param>
+	/// <param name="step">1 to jump towards higher positions, -1 towards lower ones</param>
+	/// <param name="destinationLine">line of the destination</param>
+	/// <param name="destinationPos">position of the destination on its line</param>
+	/// <returns>the position of the jump point on the line, -1 when the jump runs into an obstacle first</returns>
+	template<class T_NodeType, class T_ConnectionType, class T_HeuristicPolicy>
+	inline int BlockJPS<T_NodeType, T_ConnectionType, T_HeuristicPolicy>::JumpStraight(const WalkabilityGrid::BitPlane& plane, int line, int pos, int step, int destinationLine, int destinationPos)
+	{
+		//a cell is a jump point when the cell beside it is blocked while the next cell on that side is walkable (forced neighbor)
+		//the 64th bit of a read can't see its next cell, so every read handles 63 cells
+		const bool isDestinationLine{ line == destinationLine };
+		if (step > 0)
+		{
+			//bit i is the cell at first + i
+			for (int first = pos + 1; ; first += 63)
+			{
+				const unsigned long long cells{ plane.GetBitsFrom(line, first) };
+				++m_NrOfJumpSteps;
+				const unsigned long long sideA{ plane.GetBitsFrom(line - 1, first) };
+				const unsigned long long sideB{ plane.GetBitsFrom(line + 1, first) };
+
+				unsigned long long jumpPoints{ ((~sideA & (sideA >> 1)) | (~sideB & (sideB >> 1))) & ~(1ull << 63) };
+				if (isDestinationLine && destinationPos >= first && destinationPos < first + 63)
+					jumpPoints |= 1ull << (destinationPos - first);
+
+				//only the jump points in front of the first obstacle count
+				const unsigned long long obstacles{ ~cells };
+				const int obstacle{ obstacles ? CountTrailingZeros(obstacles) : 64 };
+				if (obstacle < 64)
+					jumpPoints &= (1ull << obstacle) - 1;
+
+				if (jumpPoints)
+					return first + CountTrailingZeros(jumpPoints);
+				if (obstacle < 63)
+					return -1;
+			}
+		}
+		else
+		{
+			//bit 63 - i is the cell at first - i
+			for (int first = pos - 1; ; first -= 63)
+			{
+				const unsigned long long cells{ plane.GetBitsUntil(line, first) };
+				++m_NrOfJumpSteps;
+				const unsigned long long sideA{ plane.GetBitsUntil(line - 1, first) };
+				const unsigned long long sideB{ plane.GetBitsUntil(line + 1, first) };
+
+				unsigned long long jumpPoints{ ((~sideA & (sideA << 1)) | (~sideB & (sideB << 1))) & ~1ull };
+				if (isDestinationLine && destinationPos <= first && destinationPos > first - 63)
+					jumpPoints |= 1ull << (63 - (first - destinationPos));
+
+				const unsigned long long obstacles{ ~cells };
+				const int obstacle{ obstacles ? CountLeadingZeros(obstacles) : 64 };
+				if (obstacle < 64)
+					jumpPoints &= obstacle == 0 ? 0ull : ~0ull << (64 - obstacle);
+
+				if (jumpPoints)
+					return first - CountLeadingZeros(jumpPoints);
+				if (obstacle < 63)
+					return -1;
+			}
+		}
+	}
+
+	/// <summary>
+	/// Jump diagonally, every step scans both straight directions for a jump point
+	/// </summary>
+	/// <param name="col">column to jump from, gets set to the column of the jump point</param>
+	/// <param name="row">row to jump from, gets set to the row of the jump point</param>
+	/// <returns>whether a jump point was found</returns>
+	template<class T_NodeType, class T_ConnectionType, class T_HeuristicPolicy>
+	inline bool BlockJPS<T_NodeType, T_ConnectionType, T_HeuristicPolicy>::JumpDiagonal(int& col, int& row, int deltaCol, int deltaRow, int destinationCol, int destinationRow)
+	{
+		while (true)
+		{
+			col += deltaCol;
+			row += deltaRow;
+			++m_NrOfJumpSteps;
+			if (!m_Grid.IsWalkable(col, row))
+				return false;
+
+			if (col == destinationCol && row == destinationRow)
+				return true;
+
+			//forced neighbors: a blocked cell behind us on one side with a walkable cell diagonally past it
+			if ((!m_Grid.IsWalkable(col - deltaCol, row) && m_Grid.IsWalkable(col - deltaCol, row + deltaRow)) ||
+				(!m_Grid.IsWalkable(col, row - deltaRow) && m_Grid.IsWalkable(col + deltaCol, row - deltaRow)))
+				return true;
+
+			if (JumpStraight(m_Grid.GetRowMajor(), row, col, deltaCol, destinationRow, destinationCol) >= 0 ||
+				JumpStraight(m_Grid.GetColumnMajor(), col, row, deltaRow, destinationCol, destinationRow) >= 0)
+				return true;
+		}
+	}
+
+	/// <summary>
+	/// Get the cost between 2 cells using the heuristic function
+	/// </summary>
+	template<class T_NodeType, class T_ConnectionType, class T_HeuristicPolicy>
+	inline float BlockJPS<T_NodeType, T_ConnectionType, T_HeuristicPolicy>::GetHeuristicCost(int fromIdx, int toIdx) const
+	{
+		const int nrOfColumns{ m_Grid.GetColumns() };
+		return m_Heuristic(abs(toIdx % nrOfColumns - fromIdx % nrOfColumns), abs(toIdx / nrOfColumns - fromIdx / nrOfColumns));
+	}
+}
@@ -0,0 +1,189 @@
+#pragma once
+
+#include "framework/EliteAI/EliteGraphs/EliteGraphUtilities/ESearchContext.h"
+#include "framework/EliteAI/EliteGraphs/EliteGraphUtilities/ESearchObservers.h"
+#include "framework/EliteAI/EliteGraphs/EliteGraphUtilities/ECompressedGraph.h"
+#include "framework/EliteAI/EliteGraphs/EliteGraphUtilities/EGraphAdjacency.h"
+#include "framework/EliteAI/EliteGraphs/EImplicitGridGraph.h"
+
+namespace Elite
+{
+	// settles the nodes of a graph in order of their cost from one source, to get the cost to many targets out of one search
+	// the results stay in the context until its next search: context.GetDistances() and context.GetParents() hold the cost and the node before it
+	// for every node with its visited bit set, context.IsSettled(idx) tells whether that cost is final
+	template <class T_NodeType, class T_ConnectionType>
+	class Dijkstra
+	{
+	public:
+		Dijkstra(IGraph<T_NodeType, T_ConnectionType>* pGraph);
+		Dijkstra(const ImplicitGridGraph* pGraph);
+
+		// stops as soon as every target is settled, returns the amount of (different) targets that can be reached
+		// without targets it settles every node the source can reach
+		int Search(int sourceIdx, const std::vector<int>& targetIndices, SearchContext& context);
+		// tells the observer about every node it generates and expands, see SearchObservers
+		template<class T_SearchObserver>
+		int Search(int sourceIdx, const std::vector<int>& targetIndices, SearchContext& context, T_SearchObserver& observer);
+		void SearchAll(int sourceIdx, SearchContext& context) { Search(sourceIdx, std::vector<int>{}, context); }
+		// searches any adjacency instead of the graph, like a ClusterAdjacency to stay inside a part of a grid
+		template<class T_Adjacency, class T_SearchObserver>
+		int Search(const T_Adjacency& adjacency, int sourceIdx, const std::vector<int>& targetIndices, SearchContext& context, T_SearchObserver& observer) const;
+
+		// puts the path from the source of the last search to a settled node in context.GetPath()
+		bool GetPath(int targetIdx, SearchContext& context) const;
+
+		// search the compressed copy of the graph instead of its connection lists, nullptr to go back to the lists
+		// the copy has to be kept up to date with the graph by the caller
+		void SetCompressedGraph(const CompressedGraph* pCompressedGraph) { m_pCompressedGraph = pCompressedGraph; }
+
+	private:
+		IGraph<T_NodeType, T_ConnectionType>* m_pGraph;
+		const CompressedGraph* m_pCompressedGraph = nullptr;
+		const ImplicitGridGraph* m_pImplicitGraph = nullptr;
+	};
+
+	template<class T_NodeType, class T_ConnectionType>
+	inline Dijkstra<T_NodeType, T_ConnectionType>::Dijkstra(IGraph<T_NodeType, T_ConnectionType>* pGraph)
+		: m_pGraph{ pGraph }
+	{
+	}
+
+	template<class T_NodeType, class T_ConnectionType>
+	inline Dijkstra<T_NodeType, T_ConnectionType>::Dijkstra(const ImplicitGridGraph* pGraph)
+		: m_pGraph{ nullptr }
+		, m_pImplicitGraph{ pGraph }
+	{
+	}
+
+	/// <summary>
+	/// Find the cheapest cost from a node to every target in one search
+	/// </summary>
+	/// <param name="sourceIdx">The index of the node the costs are measured FROM</param>
+	/// <param name="targetIndices">The indices of the nodes the costs are wanted TO, empty to settle every node</param>
+	/// <param name="context">The scratch buffers to search with, the distances and parents end up in it</param>
+	/// <returns>the amount of targets that can be reached, the others stay unsettled</returns>
+	template<class T_NodeType, class T_ConnectionType>
+	inline int Dijkstra<T_NodeType, T_ConnectionType>::Search(int sourceIdx, const std::vector<int>& targetIndices, SearchContext& context)
+	{
+		SearchObservers::None observer{};
+		return Search(sourceIdx, targetIndices, context, observer);
+	}
+
+	/// <summary>
+	/// Find the cheapest cost from a node to every target in one search and report the search to an observer
+	/// </summary>
+	/// <typeparam name="T_SearchObserver">SearchObservers::Recorder to draw the open and closed list, SearchObservers::Statistics to count</typeparam>
+	/// <param name="observer">Gets OnNodeGenerated and OnNodeExpanded calls while searching</param>
+	/// <returns>the amount of targets that can be reached, the others stay unsettled</returns>
+	template<class T_NodeType, class T_ConnectionType>
+	template<class T_SearchObserver>
+	inline int Dijkstra<T_NodeType, T_ConnectionType>::Search(int sourceIdx, const std::vector<int>& targetIndices, SearchContext& context, T_SearchObserver& observer)
+	{
+		if (m_pImplicitGraph)
+			return Search(*m_pImplicitGraph, sourceIdx, targetIndices, context, observer);
+		if (m_pCompressedGraph)
+			return Search(*m_pCompressedGraph, sourceIdx, targetIndices, context, observer);
+		return Search(GraphAdjacency<T_NodeType, T_ConnectionType>{ m_pGraph }, sourceIdx, targetIndices, context, observer);
+	}
+
+	/// <summary>
+	/// The search itself, written once for the graph, its compressed copy, the implicit grid and any other adjacency
+	/// </summary>
+	/// <typeparam name="T_Adjacency">GraphAdjacency, CompressedGraph, ImplicitGridGraph or ClusterAdjacency</typeparam>
+	template<class T_NodeType, class T_ConnectionType>
+	template<class T_Adjacency, class T_SearchObserver>
+	inline int Dijkstra<T_NodeType, T_ConnectionType>::Search(const T_Adjacency& adjacency, int sourceIdx, const std::vector<int>& targetIndices,
+		SearchContext& context, T_SearchObserver& observer) const
+	{
+		//a node is marked visited when it is generated, its distance and parent are only valid once that bit is set
+		context.BeginOneToManySearch(adjacency.GetNrOfNodes());
+		IndexedPriorityQueue<float>& openList = context.GetOpenList();
+		NodeBitset& visited = context.GetVisited();
+		std::vector<int>& parents = context.GetParents();
+		std::vector<float>& distances = context.GetDistances();
+		NodeBitset& goals = context.GetGoals();
+
+		//the goal bits make the check for a target the same price for any amount of targets, a target that is listed twice only counts once
+		int nrOfTargetsLeft{ 0 };
+		for (int targetIdx : targetIndices)
+		{
+			if (!goals.TestAndSet(targetIdx))
+				++nrOfTargetsLeft;
+		}
+		int nrOfTargetsReached{ 0 };
+
+		visited.Set(sourceIdx);
+		parents[sourceIdx] = invalid_node_index;
+		distances[sourceIdx] = 0.f;
+		openList.Push(sourceIdx, 0.f);
+
+		while (!openList.IsEmpty())
+		{
+			const int currentIdx{ openList.Pop() };
+
+			//a node's distance is final once it's taken off the open list, stop when that was the last target
+			//without targets no goal bit is set, so the whole component gets settled
+			if (goals.Test(currentIdx))
+			{
+				++nrOfTargetsReached;
+				if (--nrOfTargetsLeft == 0)
+					break;
+			}
+			context.CountExpandedNode();
+
+			const float currentDistance{ distances[currentIdx] };
+			adjacency.ForEachConnection(currentIdx, [&](int neighborIdx, float connectionCost)
+			{
+				const float distance{ currentDistance + connectionCost };
+
+				//a settled neighbor can't get cheaper (there are no negative costs), one on the open list only moves up when this path is cheaper
+				if (visited.TestAndSet(neighborIdx))
+				{
+					if (distances[neighborIdx] <= distance)
+						return true;
+					distances[neighborIdx] = distance;
+					parents[neighborIdx] = currentIdx;
+					openList.DecreaseKey(neighborIdx, distance);
+				}
+				else
+				{
+					distances[neighborIdx] = distance;
+					parents[neighborIdx] = currentIdx;
+					openList.Push(neighborIdx, distance);
+				}
+				context.CountGeneratedNode();
+				observer.OnNodeGenerated(neighborIdx);
+				return true;
+			});
+			observer.OnNodeExpanded(currentIdx);
+		}
+
+		//there is no single path to put together, the distances and parents are the result
+		context.BeginReconstruction();
+		context.EndSearch();
+		return nrOfTargetsReached;
+	}
+
+	/// <summary>
+	/// Follow the parents of the last search back from a node, without searching again
+	/// </summary>
+	/// <param name="targetIdx">The index of the node we want the path TO, from the source of the last search</param>
+	/// <param name="context">The context the last search ran in, the path ends up in context.GetPath()</param>
+	/// <returns>false (and an empty path) when the last search didn't settle the node</returns>
+	template<class T_NodeType, class T_ConnectionType>
+	inline bool Dijkstra<T_NodeType, T_ConnectionType>::GetPath(int targetIdx, SearchContext& context) const
+	{
+		std::vector<int>& path = context.GetPath();
+		path.clear();
+		if (!context.IsSettled(targetIdx))
+			return false;
+
+		const std::vector<int>& parents = context.GetParents();
+		for (int currentIdx = targetIdx; currentIdx != invalid_node_index; currentIdx = parents[currentIdx])
+		{
+			path.push_back(currentIdx);
+		}
+		std::reverse(path.begin(), path.end());
+		return true;
+	}
+}
@@ -0,0 +1,769 @@
+#pragma once
+
+#include "framework/EliteAI/EliteGraphs/EliteGraphAlgorithms/EAStar.h"
+#include "framework/EliteAI/EliteGraphs/EliteGraphAlgorithms/EDijkstra.h"
+
+namespace Elite
+{
+	// hierarchical A* (HPA*): the grid is cut into square clusters, the cells where a path can cross from one cluster into the next
+	// (the transitions) become the nodes of a small abstract graph, connected to the other transitions of their cluster by the cost
+	// of the cheapest path between them inside the cluster
+	// a query searches the abstract graph and only searches the grid again inside the clusters the abstract path runs through
+	// the paths are close to the shortest ones, not always the shortest
+	// a terrain edit only rebuilds the clusters around the changed cells, see UpdateNodes
+	template <class T_NodeType, class T_ConnectionType, class T_HeuristicPolicy = HeuristicPolicies::Function>
+	class HPAStar
+	{
+	public:
+		HPAStar(GridGraph<T_NodeType, T_ConnectionType>* pGraph, int clusterSize = 16, T_HeuristicPolicy heuristic = T_HeuristicPolicy{});
+
+		std::vector<T_NodeType*> FindPath(T_NodeType* pStartNode, T_NodeType* pDestinationNode);
+		bool FindPath(T_NodeType* pStartNode, T_NodeType* pDestinationNode, SearchContext& context);
+		bool FindPath(int startIdx, int destinationIdx, SearchContext& context);
+		// tells the observer about every transition the abstract search generates and expands, see SearchObservers
+		template<class T_SearchObserver>
+		bool FindPath(int startIdx, int destinationIdx, SearchContext& context, T_SearchObserver& observer);
+
+		void SetHeuristicFunction(T_HeuristicPolicy heuristic);
+		// search and rebuild with the compressed copy of the graph instead of its connection lists, nullptr to go back to the lists
+		// the abstract graph stays as it is, the copy has the same connections; it has to be updated by the caller before UpdateNodes
+		void SetCompressedGraph(const CompressedGraph* pCompressedGraph);
+
+		// cuts the grid into clusters and builds the whole abstract graph again
+		void Build();
+		// only finds the transitions again on the borders the changed cells lie on and the paths inside the clusters around them
+		// call it with the cells the terrain changed callback of the grid gets, after one edit or a whole batch of them
+		void UpdateNodes(const std::vector<int>& changedNodes);
+
+		int GetClusterSize() const { return m_ClusterSize; }
+		int GetNrOfClusters() const { return m_NrOfClusterColumns * m_NrOfClusterRows; }
+		int GetNrOfAbstractNodes() const { return int(m_Nodes.size() - m_FreeNodes.size()); }
+		// amount of times the paths inside a cluster were searched again, Build counts every cluster
+		int GetNrOfClusterRebuilds() const { return m_NrOfClusterRebuilds; }
+		size_t GetMemorySize() const;
+
+	private:
+		// an entrance (a row of cells next to each other that can all cross the border) this wide or wider gets a transition at both ends,
+		// a narrower one gets one in its middle
+		enum { min_entrance_width_for_two_transitions = 6 };
+		// the borders a cluster owns, to the clusters after it, the other clusters own the borders to the ones before them
+		enum BorderSide { east, south, south_east, south_west, nr_of_border_sides };
+
+		struct AbstractEdge
+		{
+			int toIdx;
+			float cost;
+		};
+		// one side of a transition, the cell across the border is its partner
+		struct AbstractNode
+		{
+			int cellIdx = invalid_node_index; // invalid for a node on the free list
+			int clusterIdx = invalid_node_index;
+			int partnerIdx = invalid_node_index;
+			float partnerCost = 0.f;
+			std::vector<AbstractEdge> edges; // to the other nodes of the cluster
+		};
+
+		template<class T_Adjacency, class T_SearchObserver>
+		bool Search(const T_Adjacency& adjacency, int startIdx, int destinationIdx, SearchContext& context, T_SearchObserver& observer);
+		template<class T_Adjacency>
+		void Rebuild(const T_Adjacency& adjacency, const std::vector<int>& borderIndices, const std::vector<int>& clusterIndices);
+		template<class T_Adjacency>
+		void BuildBorder(const T_Adjacency& adjacency, int borderIdx);
+		template<class T_Adjacency>
+		void BuildClusterEdges(const T_Adjacency& adjacency, int clusterIdx);
+		// the cost from a cell to every node of its cluster, inside the cluster
+		template<class T_Adjacency>
+		void ConnectToCluster(const T_Adjacency& adjacency, int cellIdx, std::vector<AbstractEdge>& edges);
+		// appends the path inside a cluster from one cell to another to the path, without the first cell
+		template<class T_Adjacency>
+		bool AppendClusterPath(const T_Adjacency& adjacency, int clusterIdx, int fromIdx, int toIdx, std::vector<int>& path);
+
+		template<class T_Adjacency>
+		ClusterAdjacency<T_Adjacency> GetClusterAdjacency(const T_Adjacency& adjacency, int clusterIdx) const;
+		int GetClusterIndex(int cellIdx) const;
+		int GetBorderIndex(int clusterIdx, int otherClusterIdx) const;
+		int AddNode(int cellIdx, int clusterIdx);
+		void RemoveNode(int nodeIdx);
+		float GetHeuristicCost(int fromIdx, int toIdx) const;
+
+		GridGraph<T_NodeType, T_ConnectionType>* m_pGraph;
+		const CompressedGraph* m_pCompressedGraph = nullptr;
+		T_HeuristicPolicy m_Heuristic;
+		// searches queries inside one cluster, and the ones the abstract graph has no path for
+		AStar<T_NodeType, T_ConnectionType, T_HeuristicPolicy> m_AStar;
+		Dijkstra<T_NodeType, T_ConnectionType> m_Dijkstra;
+
+		int m_ClusterSize;
+		int m_NrOfClusterColumns = 0;
+		int m_NrOfClusterRows = 0;
+		int m_NrOfClusterRebuilds = 0;
+
+		// removed nodes go on the free list, so the indices of the other nodes stay the same
+		std::vector<AbstractNode> m_Nodes;
+		std::vector<int> m_FreeNodes;
+		std::vector<std::vector<int>> m_ClusterNodes;
+		// the nodes on the own side of the transitions of every border, nr_of_border_sides per cluster
+		std::vector<std::vector<int>> m_BorderNodes;
+
+		// scratch memory: the searches inside a cluster and the connections of the start and the destination to the nodes of their cluster
+		SearchContext m_ClusterContext;
+		std::vector<int> m_Targets;
+		std::vector<int> m_RefinementTargets; // the one target of AppendClusterPath, m_Targets holds the abstract path meanwhile
+		std::vector<AbstractEdge> m_StartEdges;
+		std::vector<AbstractEdge> m_DestinationEdges;
+		std::vector<int> m_IsDirty;
+		std::vector<int> m_DirtyBorders;
+		std::vector<int> m_DirtyClusters;
+
+		// used by the FindPath overload that doesn't get a context
+		SearchContext m_Context;
+	};
+
+	template<class T_NodeType, class T_ConnectionType, class T_HeuristicPolicy>
+	HPAStar<T_NodeType, T_ConnectionType, T_HeuristicPolicy>::HPAStar(GridGraph<T_NodeType, T_ConnectionType>* pGraph, int clusterSize, T_HeuristicPolicy heuristic)
+		: m_pGraph{ pGraph }
+		, m_Heuristic{ heuristic }
+		, m_AStar{ pGraph, heuristic }
+		, m_Dijkstra{ pGraph }
+		, m_ClusterSize{ clusterSize }
+	{
+		assert(!pGraph->IsDirectionalGraph() && "<HPAStar::HPAStar>: the paths inside a cluster are only searched one way, the graph can't be directional");
+		assert(clusterSize > 0 && "<HPAStar::HPAStar>: invalid cluster size");
+		Build();
+	}
+
+	template<class T_NodeType, class T_ConnectionType, class T_HeuristicPolicy>
+	inline void HPAStar<T_NodeType, T_ConnectionType, T_HeuristicPolicy>::SetHeuristicFunction(T_HeuristicPolicy heuristic)
+	{
+		m_Heuristic = heuristic;
+		m_AStar.SetHeuristicFunction(heuristic);
+	}
+
+	template<class T_NodeType, class T_ConnectionType, class T_HeuristicPolicy>
+	inline void HPAStar<T_NodeType, T_ConnectionType, T_HeuristicPolicy>::SetCompressedGraph(const CompressedGraph* pCompressedGraph)
+	{
+		m_pCompressedGraph = pCompressedGraph;
+		m_AStar.SetCompressedGraph(pCompressedGraph);
+	}
+
+	/// <summary>
+	/// find a path from 2 given nodes on the graph
+	/// </summary>
+	/// <typeparam name="T_NodeType">The type of node used on the graph</typeparam>
+	/// <typeparam name="T_ConnectionType"><The type of connection used on the graph/typeparam>
+	/// <param name="pStartNode">The start node we want to find a path FROM</param>
+	/// <param name="pDestinationNode">The destination node we want to find a path TO</param>
+	/// <returns>returns the path between the 2 nodes</returns>
+	template<class T_NodeType, class T_ConnectionType, class T_HeuristicPolicy>
+	inline std::vector<T_NodeType*> HPAStar<T_NodeType, T_ConnectionType, T_HeuristicPolicy>::FindPath(T_NodeType* pStartNode, T_NodeType* pDestinationNode)
+	{
+		FindPath(pStartNode, pDestinationNode, m_Context);
+
+		vector<T_NodeType*> finalPath;
+		finalPath.reserve(m_Context.GetPath().size());
+		for (int idx : m_Context.GetPath())
+			finalPath.push_back(m_pGraph->GetNode(idx));
+
+		return finalPath;
+	}
+
+	/// <summary>
+	/// find a path from 2 given nodes on the graph, using the buffers of the given context so repeated queries don't allocate
+	/// </summary>
+	/// <typeparam name="T_NodeType">The type of node used on the graph</typeparam>
+	/// <typeparam name="T_ConnectionType"><The type of connection used on the graph/typeparam>
+	/// <param name="pStartNode">The start node we want to find a path FROM</param>
+	/// <param name="pDestinationNode">The destination node we want to find a path TO</param>
+	/// <param name="context">The scratch buffers to search with, the node indices of the path end up in context.GetPath()</param>
+	/// <returns>true if the destination was reached, otherwise the path leads to the node closest to the destination</returns>
+	template<class T_NodeType, class T_ConnectionType, class T_HeuristicPolicy>
+	inline bool HPAStar<T_NodeType, T_ConnectionType, T_HeuristicPolicy>::FindPath(T_NodeType* pStartNode, T_NodeType* pDestinationNode, SearchContext& context)
+	{
+		return FindPath(pStartNode->GetIndex(), pDestinationNode->GetIndex(), context);
+	}
+
+	/// <summary>
+	/// find a path from 2 given node indices
+	/// </summary>
+	/// <param name="startIdx">The index of the node we want to find a path FROM</param>
+	/// <param name="destinationIdx">The index of the node we want to find a path TO</param>
+	/// <param name="context">The scratch buffers to search with, the node indices of the path end up in context.GetPath()</param>
+	/// <returns>true if the destination was reached, otherwise the path leads to the node closest to the destination</returns>
+	template<class T_NodeType, class T_ConnectionType, class T_HeuristicPolicy>
+	inline bool HPAStar<T_NodeType, T_ConnectionType, T_HeuristicPolicy>::FindPath(int startIdx, int destinationIdx, SearchContext& context)
+	{
+		SearchObservers::None observer{};
+		return FindPath(startIdx, destinationIdx, context, observer);
+	}
+
+	/// <summary>
+	/// find a path from 2 given node indices and report the search to an observer
+	/// </summary>
+	/// <typeparam name="T_SearchObserver">SearchObservers::Recorder to draw the open and closed list, SearchObservers::Statistics to count</typeparam>
+	/// <param name="observer">Gets OnNodeGenerated and OnNodeExpanded calls with the cells of the transitions while searching</param>
+	/// <returns>true if the destination was reached, otherwise the path leads to the node closest to the destination</returns>
+	template<class T_NodeType, class T_ConnectionType, class T_HeuristicPolicy>
+	template<class T_SearchObserver>
+	inline bool HPAStar<T_NodeType, T_ConnectionType, T_HeuristicPolicy>::FindPath(int startIdx, int destinationIdx, SearchContext& context, T_SearchObserver& observer)
+	{
+		if (m_pCompressedGraph)
+			return Search(*m_pCompressedGraph, startIdx, destinationIdx, context, observer);
+		return Search(GraphAdjacency<T_NodeType, T_ConnectionType>{ m_pGraph }, startIdx, destinationIdx, context, observer);
+	}
+
+	/// <summary>
+	/// Cut the grid into clusters, find the transitions on all their borders and the paths between the transitions of every cluster
+	/// </summary>
+	template<class T_NodeType, class T_ConnectionType, class T_HeuristicPolicy>
+	inline void HPAStar<T_NodeType, T_ConnectionType, T_HeuristicPolicy>::Build()
+	{
+		m_NrOfClusterColumns = (m_pGraph->GetColumns() + m_ClusterSize - 1) / m_ClusterSize;
+		m_NrOfClusterRows = (m_pGraph->GetRows() + m_ClusterSize - 1) / m_ClusterSize;
+		const int nrOfClusters{ GetNrOfClusters() };
+
+		m_Nodes.clear();
+		m_FreeNodes.clear();
+		m_ClusterNodes.assign(nrOfClusters, std::vector<int>{});
+		m_BorderNodes.assign(size_t(nrOfClusters) * nr_of_border_sides, std::vector<int>{});
+		m_IsDirty.assign(size_t(nrOfClusters) * nr_of_border_sides, 0);
+
+		m_DirtyBorders.clear();
+		m_DirtyClusters.clear();
+		for (int clusterIdx = 0; clusterIdx < nrOfClusters; ++clusterIdx)
+		{
+			for (int side = 0; side < nr_of_border_sides; ++side)
+				m_DirtyBorders.push_back(clusterIdx * nr_of_border_sides + side);
+			m_DirtyClusters.push_back(clusterIdx);
+		}
+
+		if (m_pCompressedGraph)
+			Rebuild(*m_pCompressedGraph, m_DirtyBorders, m_DirtyClusters);
+		else
+			Rebuild(GraphAdjacency<T_NodeType, T_ConnectionType>{ m_pGraph }, m_DirtyBorders, m_DirtyClusters);
+	}
+
+	/// <summary>
+	/// Rebuild the borders and clusters the changed cells affect: a cell's connections only lead to its neighbors,
+	/// so its cluster has to look for its paths again, and so does every border between it and a neighbor in another cluster
+	/// (together with the cluster on the other side, its transitions on that border changed)
+	/// </summary>
+	/// <param name="changedNodes">The cells whose terrain (and so their connections) changed</param>
+	template<class T_NodeType, class T_ConnectionType, class T_HeuristicPolicy>
+	inline void HPAStar<T_NodeType, T_ConnectionType, T_HeuristicPolicy>::UpdateNodes(const std::vector<int>& changedNodes)
+	{
+		//m_IsDirty has a flag per border, the lowest bit, and per cluster, the second bit of the flag of its first border
+		enum { dirty_border = 1, dirty_cluster = 2 };
+		m_DirtyBorders.clear();
+		m_DirtyClusters.clear();
+		auto markCluster = [this](int clusterIdx)
+		{
+			int& flags = m_IsDirty[size_t(clusterIdx) * nr_of_border_sides];
+			if (flags & dirty_cluster)
+				return;
+			flags |= dirty_cluster;
+			m_DirtyClusters.push_back(clusterIdx);
+		};
+
+		const int nrOfColumns{ m_pGraph->GetColumns() };
+		for (int cellIdx : changedNodes)
+		{
+			const int clusterIdx{ GetClusterIndex(cellIdx) };
+			markCluster(clusterIdx);
+
+			const int col{ cellIdx % nrOfColumns };
+			const int row{ cellIdx / nrOfColumns };
+			for (int deltaRow = -1; deltaRow <= 1; ++deltaRow)
+			{
+				for (int deltaCol = -1; deltaCol <= 1; ++deltaCol)
+				{
+					if (!m_pGraph->IsWithinBounds(col + deltaCol, row + deltaRow))
+						continue;
+
+					const int neighborClusterIdx{ GetClusterIndex(m_pGraph->GetIndex(col + deltaCol, row + deltaRow)) };
+					if (neighborClusterIdx == clusterIdx)
+						continue;
+
+					const int borderIdx{ GetBorderIndex(clusterIdx, neighborClusterIdx) };
+					if (!(m_IsDirty[borderIdx] & dirty_border))
+					{
+						m_IsDirty[borderIdx] |= dirty_border;
+						m_DirtyBorders.push_back(borderIdx);
+					}
+					markCluster(neighborClusterIdx);
+				}
+			}
+		}
+
+		for (int borderIdx : m_DirtyBorders)
+			m_IsDirty[borderIdx] &= ~dirty_border;
+		for (int clusterIdx : m_DirtyClusters)
+			m_IsDirty[size_t(clusterIdx) * nr_of_border_sides] &= ~dirty_cluster;
+
+		if (m_pCompressedGraph)
+			Rebuild(*m_pCompressedGraph, m_DirtyBorders, m_DirtyClusters);
+		else
+			Rebuild(GraphAdjacency<T_NodeType, T_ConnectionType>{ m_pGraph }, m_DirtyBorders, m_DirtyClusters);
+	}
+
+	/// <summary>
+	/// Find the transitions on the given borders again, then the paths inside the given clusters
+	/// </summary>
+	/// <param name="borderIndices">The borders to rebuild, every cluster on either side of one has to be in clusterIndices</param>
+	/// <param name="clusterIndices">The clusters to search the paths between the transitions again for</param>
+	template<class T_NodeType, class T_ConnectionType, class T_HeuristicPolicy>
+	template<class T_Adjacency>
+	inline void HPAStar<T_NodeType, T_ConnectionType, T_HeuristicPolicy>::Rebuild(const T_Adjacency& adjacency, const std::vector<int>& borderIndices, const std::vector<int>& clusterIndices)
+	{
+		for (int borderIdx : borderIndices)
+			BuildBorder(adjacency, borderIdx);
+		for (int clusterIdx : clusterIndices)
+			BuildClusterEdges(adjacency, clusterIdx);
+		m_NrOfClusterRebuilds += int(clusterIndices.size());
+	}
+
+	/// <summary>
+	/// Replace the transitions of a border: every row of cells along it that can all cross gets one or two transitions
+	/// </summary>
+	/// <param name="borderIdx">clusterIdx * nr_of_border_sides + the BorderSide</param>
+	template<class T_NodeType, class T_ConnectionType, class T_HeuristicPolicy>
+	template<class T_Adjacency>
+	inline void HPAStar<T_NodeType, T_ConnectionType, T_HeuristicPolicy>::BuildBorder(const T_Adjacency& adjacency, int borderIdx)
+	{
+		std::vector<int>& borderNodes = m_BorderNodes[borderIdx];
+		for (int nodeIdx : borderNodes)
+		{
+			RemoveNode(m_Nodes[nodeIdx].partnerIdx);
+			RemoveNode(nodeIdx);
+		}
+		borderNodes.clear();
+
+		const int clusterIdx{ borderIdx / nr_of_border_sides };
+		const int clusterCol{ clusterIdx % m_NrOfClusterColumns };
+		const int clusterRow{ clusterIdx / m_NrOfClusterColumns };
+		const int left{ clusterCol * m_ClusterSize };
+		const int top{ clusterRow * m_ClusterSize };
+		const int right{ std::min(left + m_ClusterSize, m_pGraph->GetColumns()) - 1 };
+		const int bottom{ std::min(top + m_ClusterSize, m_pGraph->GetRows()) - 1 };
+
+		//the cells on this side of the border, in the order they lie along it, and the cluster on the other side
+		int otherClusterCol{ clusterCol };
+		int firstCol{ left };
+		int firstRow{ top };
+		int deltaCol{ 0 };
+		int deltaRow{ 0 };
+		int nrOfCells{ 1 };
+		switch (BorderSide(borderIdx % nr_of_border_sides))
+		{
+		case east:
+			otherClusterCol = clusterCol + 1;
+			firstCol = right;
+			deltaRow = 1;
+			nrOfCells = bottom - top + 1;
+			break;
+		case south:
+			firstRow = bottom;
+			deltaCol = 1;
+			nrOfCells = right - left + 1;
+			break;
+		case south_east:
+			otherClusterCol = clusterCol + 1;
+			firstCol = right;
+			firstRow = bottom;
+			break;
+		case south_west:
+			otherClusterCol = clusterCol - 1;
+			firstRow = bottom;
+			break;
+		default:
+			break;
+		}
+		const int otherClusterRow{ borderIdx % nr_of_border_sides == east ? clusterRow : clusterRow + 1 };
+		if (otherClusterCol < 0 || otherClusterCol >= m_NrOfClusterColumns || otherClusterRow >= m_NrOfClusterRows)
+			return;
+		const int otherClusterIdx{ otherClusterRow * m_NrOfClusterColumns + otherClusterCol };
+
+		//the cheapest connection of a cell across the border, the cell can't cross when there is none
+		auto findCrossing = [&](int cellIdx, int& otherCellIdx, float& cost)
+		{
+			cost = FLT_MAX;
+			adjacency.ForEachConnection(cellIdx, [&](int toIdx, float connectionCost)
+			{
+				if (connectionCost < cost && GetClusterIndex(toIdx) == otherClusterIdx)
+				{
+					cost = connectionCost;
+					otherCellIdx = toIdx;
+				}
+				return true;
+			});
+			return cost != FLT_MAX;
+		};
+		auto addTransition = [&](int position)
+		{
+			const int cellIdx{ m_pGraph->GetIndex(firstCol + position * deltaCol, firstRow + position * deltaRow) };
+			int otherCellIdx{ invalid_node_index };
+			float cost{};
+			findCrossing(cellIdx, otherCellIdx, cost);
+
+			const int nodeIdx{ AddNode(cellIdx, clusterIdx) };
+			const int otherNodeIdx{ AddNode(otherCellIdx, otherClusterIdx) };
+			m_Nodes[nodeIdx].partnerIdx = otherNodeIdx;
+			m_Nodes[nodeIdx].partnerCost = cost;
+			m_Nodes[otherNodeIdx].partnerIdx = nodeIdx;
+			m_Nodes[otherNodeIdx].partnerCost = cost;
+			m_BorderNodes[borderIdx].push_back(nodeIdx);
+		};
+
+		//walk along the border, an entrance ends at the first cell that can't cross (or at the end of the border)
+		int entranceStart{ -1 };
+		for (int position = 0; position <= nrOfCells; ++position)
+		{
+			int otherCellIdx{};
+			float cost{};
+			const bool canCross{ position < nrOfCells
+				&& findCrossing(m_pGraph->GetIndex(firstCol + position * deltaCol, firstRow + position * deltaRow), otherCellIdx, cost) };
+			if (canCross)
+			{
+				if (entranceStart < 0)
+					entranceStart = position;
+				continue;
+			}
+			if (entranceStart < 0)
+				continue;
+
+			const int entranceEnd{ position - 1 };
+			if (entranceEnd - entranceStart + 1 >= min_entrance_width_for_two_transitions)
+			{
+				addTransition(entranceStart);
+				addTransition(entranceEnd);
+			}
+			else
+				addTransition((entranceStart + entranceEnd) / 2);
+			entranceStart = -1;
+		}
+	}
+
+	/// <summary>
+	/// Search the cheapest paths between the nodes of a cluster again, without leaving the cluster
+	/// </summary>
+	/// <param name="clusterIdx">The cluster to connect the nodes of</param>
+	template<class T_NodeType, class T_ConnectionType, class T_HeuristicPolicy>
+	template<class T_Adjacency>
+	inline void HPAStar<T_NodeType, T_ConnectionType, T_HeuristicPolicy>::BuildClusterEdges(const T_Adjacency& adjacency, int clusterIdx)
+	{
+		const ClusterAdjacency<T_Adjacency> clusterAdjacency{ GetClusterAdjacency(adjacency, clusterIdx) };
+		const std::vector<int>& clusterNodes = m_ClusterNodes[clusterIdx];
+
+		m_Targets.clear();
+		for (int nodeIdx : clusterNodes)
+			m_Targets.push_back(clusterAdjacency.ToLocalIndex(m_Nodes[nodeIdx].cellIdx));
+
+		//one search per node, the paths can't be shared because only the paths from the source are final when the search stops early
+		SearchObservers::None observer{};
+		for (int nodeIdx : clusterNodes)
+		{
+			AbstractNode& node = m_Nodes[nodeIdx];
+			node.edges.clear();
+			m_Dijkstra.Search(clusterAdjacency, clusterAdjacency.ToLocalIndex(node.cellIdx), m_Targets, m_ClusterContext, observer);
+
+			for (size_t i = 0; i < clusterNodes.size(); ++i)
+			{
+				if (clusterNodes[i] != nodeIdx && m_ClusterContext.IsSettled(m_Targets[i]))
+					node.edges.push_back(AbstractEdge{ clusterNodes[i], m_ClusterContext.GetDistances()[m_Targets[i]] });
+			}
+		}
+	}
+
+	/// <summary>
+	/// The search itself: connect the start and the destination to their clusters, search the abstract graph and
+	/// fill in the path inside every cluster it crosses
+	/// </summary>
+	/// <typeparam name="T_Adjacency">GraphAdjacency or CompressedGraph</typeparam>
+	template<class T_NodeType, class T_ConnectionType, class T_HeuristicPolicy>
+	template<class T_Adjacency, class T_SearchObserver>
+	inline bool HPAStar<T_NodeType, T_ConnectionType, T_HeuristicPolicy>::Search(const T_Adjacency& adjacency, int startIdx, int destinationIdx,
+		SearchContext& context, T_SearchObserver& observer)
+	{
+		//nothing to win when both lie in the same cluster, the path between them doesn't have to stay inside it either
+		const int startClusterIdx{ GetClusterIndex(startIdx) };
+		const int destinationClusterIdx{ GetClusterIndex(destinationIdx) };
+		if (startClusterIdx == destinationClusterIdx)
+			return m_AStar.FindPath(startIdx, destinationIdx, context, observer);
+
+		//the start and the destination join the abstract graph for this search only, with the indices after its nodes
+		ConnectToCluster(adjacency, startIdx, m_StartEdges);
+		ConnectToCluster(adjacency, destinationIdx, m_DestinationEdges);
+		const int startNodeIdx{ int(m_Nodes.size()) };
+		const int destinationNodeIdx{ startNodeIdx + 1 };
+		auto getCellIndex = [&](int nodeIdx) { return nodeIdx == startNodeIdx ? startIdx : nodeIdx == destinationNodeIdx ? destinationIdx : m_Nodes[nodeIdx].cellIdx; };
+
+		//the context searches the abstract graph, so its counters count transitions, the searches inside the clusters use buffers of their own
+		context.BeginSearch(std::max(m_pGraph->GetNrOfNodes(), destinationNodeIdx + 1));
+		IndexedPriorityQueue<float>& openList = context.GetOpenList();
+		SearchStateTable& nodeStates = context.GetNodeStates();
+
+		SearchNodeState& startState = nodeStates.Visit(startNodeIdx);
+		startState.estimatedTotalCost = GetHeuristicCost(startIdx, destinationIdx);
+		startState.status = SearchNodeStatus::Open;
+		openList.Push(startNodeIdx, startState.estimatedTotalCost);
+
+		bool foundPath{ false };
+		while (!openList.IsEmpty())
+		{
+			const int currentIdx{ openList.Pop() };
+			SearchNodeState& currentState = nodeStates.GetState(currentIdx);
+			if (currentIdx == destinationNodeIdx)
+			{
+				foundPath = true;
+				break;
+			}
+			context.CountExpandedNode();
+
+			auto visitNeighbor = [&](int neighborIdx, float edgeCost)
+			{
+				const float costSoFar{ currentState.costSoFar + edgeCost };
+
+				//the same as AStar: only go on when this path to the neighbor is cheaper, that reopens a closed neighbor
+				bool isOnOpenList{ false };
+				if (nodeStates.IsVisited(neighborIdx))
+				{
+					const SearchNodeState& neighborState = nodeStates.GetState(neighborIdx);
+					if (neighborState.costSoFar <= costSoFar)
+						return;
+					isOnOpenList = neighborState.status == SearchNodeStatus::Open;
+					if (!isOnOpenList)
+						context.CountReopenedNode();
+				}
+
+				SearchNodeState& neighborState = nodeStates.Visit(neighborIdx);
+				neighborState.costSoFar = costSoFar;
+				neighborState.estimatedTotalCost = costSoFar + GetHeuristicCost(getCellIndex(neighborIdx), destinationIdx);
+				neighborState.parentIdx = currentIdx;
+				neighborState.status = SearchNodeStatus::Open;
+				if (isOnOpenList)
+					openList.DecreaseKey(neighborIdx, neighborState.estimatedTotalCost);
+				else
+					openList.Push(neighborIdx, neighborState.estimatedTotalCost);
+				context.CountGeneratedNode();
+				observer.OnNodeGenerated(getCellIndex(neighborIdx));
+			};
+
+			if (currentIdx == startNodeIdx)
+			{
+				for (const AbstractEdge& edge : m_StartEdges)
+					visitNeighbor(edge.toIdx, edge.cost);
+			}
+			else
+			{
+				const AbstractNode& node = m_Nodes[currentIdx];
+				visitNeighbor(node.partnerIdx, node.partnerCost);
+				for (const AbstractEdge& edge : node.edges)
+					visitNeighbor(edge.toIdx, edge.cost);
+				if (node.clusterIdx == destinationClusterIdx)
+				{
+					for (const AbstractEdge& edge : m_DestinationEdges)
+					{
+						if (edge.toIdx == currentIdx)
+							visitNeighbor(destinationNodeIdx, edge.cost);
+					}
+				}
+			}
+			currentState.status = SearchNodeStatus::Closed;
+			observer.OnNodeExpanded(getCellIndex(currentIdx));
+		}
+
+		//the abstract graph only knows paths that cross the borders at a transition, when it has none the grid gets searched as a whole
+		if (!foundPath)
+			return m_AStar.FindPath(startIdx, destinationIdx, context, observer);
+		context.BeginReconstruction();
+
+		//follow the abstract path back to the start, then fill in every step of it from the start on
+		std::vector<int>& finalPath = context.GetPath();
+		for (int nodeIdx = destinationNodeIdx; nodeIdx != invalid_node_index; nodeIdx = nodeStates.GetState(nodeIdx).parentIdx)
+		{
+			finalPath.push_back(nodeIdx);
+		}
+		std::reverse(finalPath.begin(), finalPath.end());
+
+		m_Targets.swap(finalPath);
+		finalPath.clear();
+		finalPath.push_back(startIdx);
+		for (size_t i = 1; i < m_Targets.size(); ++i)
+		{
+			const int fromNodeIdx{ m_Targets[i - 1] };
+			const int toNodeIdx{ m_Targets[i] };
+			const int fromIdx{ getCellIndex(fromNodeIdx) };
+			const int toIdx{ getCellIndex(toNodeIdx) };
+
+			//crossing a border is a single step, the other steps stay inside one cluster
+			if (fromNodeIdx != startNodeIdx && m_Nodes[fromNodeIdx].partnerIdx == toNodeIdx)
+				finalPath.push_back(toIdx);
+			else if (fromIdx != toIdx && !AppendClusterPath(adjacency, GetClusterIndex(fromIdx), fromIdx, toIdx, finalPath))
+			{
+				//an edge of the abstract graph without a path inside its cluster, the abstract graph is out of date
+				finalPath.clear();
+				context.EndSearch();
+				return false;
+			}
+		}
+
+		context.EndSearch();
+		return true;
+	}
+
+	/// <summary>
+	/// Connect a cell to the nodes of its cluster, with the cost of the cheapest path to them inside the cluster
+	/// </summary>
+	/// <param name="cellIdx">The cell, the start or the destination of a query</param>
+	/// <param name="edges">Gets an edge to every node of the cluster the cell can reach</param>
+	template<class T_NodeType, class T_ConnectionType, class T_HeuristicPolicy>
+	template<class T_Adjacency>
+	inline void HPAStar<T_NodeType, T_ConnectionType, T_HeuristicPolicy>::ConnectToCluster(const T_Adjacency& adjacency, int cellIdx, std::vector<AbstractEdge>& edges)
+	{
+		const int clusterIdx{ GetClusterIndex(cellIdx) };
+		const ClusterAdjacency<T_Adjacency> clusterAdjacency{ GetClusterAdjacency(adjacency, clusterIdx) };
+		const std::vector<int>& clusterNodes = m_ClusterNodes[clusterIdx];
+
+		m_Targets.clear();
+		for (int nodeIdx : clusterNodes)
+			m_Targets.push_back(clusterAdjacency.ToLocalIndex(m_Nodes[nodeIdx].cellIdx));
+
+		SearchObservers::None observer{};
+		m_Dijkstra.Search(clusterAdjacency, clusterAdjacency.ToLocalIndex(cellIdx), m_Targets, m_ClusterContext, observer);
+
+		edges.clear();
+		for (size_t i = 0; i < clusterNodes.size(); ++i)
+		{
+			if (m_ClusterContext.IsSettled(m_Targets[i]))
+				edges.push_back(AbstractEdge{ clusterNodes[i], m_ClusterContext.GetDistances()[m_Targets[i]] });
+		}
+	}
+
+	/// <summary>
+	/// Search the path between 2 cells of a cluster again, it was only remembered by its cost
+	/// </summary>
+	/// <param name="clusterIdx">The cluster both cells lie in</param>
+	/// <param name="fromIdx">The cell the path is already at</param>
+	/// <param name="toIdx">The cell to go to</param>
+	/// <param name="path">Gets the cells after fromIdx up to and with toIdx</param>
+	/// <returns>false when the cells aren't connected inside the cluster</returns>
+	template<class T_NodeType, class T_ConnectionType, class T_HeuristicPolicy>
+	template<class T_Adjacency>
+	inline bool HPAStar<T_NodeType, T_ConnectionType, T_HeuristicPolicy>::AppendClusterPath(const T_Adjacency& adjacency, int clusterIdx, int fromIdx, int toIdx, std::vector<int>& path)
+	{
+		const ClusterAdjacency<T_Adjacency> clusterAdjacency{ GetClusterAdjacency(adjacency, clusterIdx) };
+
+		SearchObservers::None observer{};
+		m_RefinementTargets.assign(1, clusterAdjacency.ToLocalIndex(toIdx));
+		m_Dijkstra.Search(clusterAdjacency, clusterAdjacency.ToLocalIndex(fromIdx), m_RefinementTargets, m_ClusterContext, observer);
+		if (!m_Dijkstra.GetPath(m_RefinementTargets.front(), m_ClusterContext))
+			return false;
+
+		const std::vector<int>& clusterPath = m_ClusterContext.GetPath();
+		for (size_t i = 1; i < clusterPath.size(); ++i)
+			path.push_back(clusterAdjacency.ToGridIndex(clusterPath[i]));
+		return true;
+	}
+
+	template<class T_NodeType, class T_ConnectionType, class T_HeuristicPolicy>
+	template<class T_Adjacency>
+	inline ClusterAdjacency<T_Adjacency> HPAStar<T_NodeType, T_ConnectionType, T_HeuristicPolicy>::GetClusterAdjacency(const T_Adjacency& adjacency, int clusterIdx) const
+	{
+		const int left{ (clusterIdx % m_NrOfClusterColumns) * m_ClusterSize };
+		const int top{ (clusterIdx / m_NrOfClusterColumns) * m_ClusterSize };
+		return ClusterAdjacency<T_Adjacency>{ adjacency, m_pGraph->GetColumns(), left, top,
+			std::min(m_ClusterSize, m_pGraph->GetColumns() - left), std::min(m_ClusterSize, m_pGraph->GetRows() - top) };
+	}
+
+	template<class T_NodeType, class T_ConnectionType, class T_HeuristicPolicy>
+	inline int HPAStar<T_NodeType, T_ConnectionType, T_HeuristicPolicy>::GetClusterIndex(int cellIdx) const
+	{
+		const int nrOfColumns{ m_pGraph->GetColumns() };
+		return (cellIdx / nrOfColumns / m_ClusterSize) * m_NrOfClusterColumns + cellIdx % nrOfColumns / m_ClusterSize;
+	}
+
+	/// <summary>
+	/// Get the border between 2 clusters next to each other, the one with the lower index owns it
+	/// </summary>
+	/// <returns>the index of the border in m_BorderNodes</returns>
+	template<class T_NodeType, class T_ConnectionType, class T_HeuristicPolicy>
+	inline int HPAStar<T_NodeType, T_ConnectionType, T_HeuristicPolicy>::GetBorderIndex(int clusterIdx, int otherClusterIdx) const
+	{
+		const int ownerIdx{ std::min(clusterIdx, otherClusterIdx) };
+		const int deltaCol{ std::max(clusterIdx, otherClusterIdx) % m_NrOfClusterColumns - ownerIdx % m_NrOfClusterColumns };
+		const int deltaRow{ std::max(clusterIdx, otherClusterIdx) / m_NrOfClusterColumns - ownerIdx / m_NrOfClusterColumns };
+
+		BorderSide side{ east };
+		if (deltaRow == 1)
+			side = deltaCol == 0 ? south : deltaCol == 1 ? south_east : south_west;
+		return ownerIdx * nr_of_border_sides + side;
+	}
+
+	template<class T_NodeType, class T_ConnectionType, class T_HeuristicPolicy>
+	inline int HPAStar<T_NodeType, T_ConnectionType, T_HeuristicPolicy>::AddNode(int cellIdx, int clusterIdx)
+	{
+		int nodeIdx{ int(m_Nodes.size()) };
+		if (m_FreeNodes.empty())
+			m_Nodes.emplace_back();
+		else
+		{
+			nodeIdx = m_FreeNodes.back();
+			m_FreeNodes.pop_back();
+		}
+
+		AbstractNode& node = m_Nodes[nodeIdx];
+		node.cellIdx = cellIdx;
+		node.clusterIdx = clusterIdx;
+		m_ClusterNodes[clusterIdx].push_back(nodeIdx);
+		return nodeIdx;
+	}
+
+	/// <summary>
+	/// Put a node on the free list, the edges of the other nodes of its cluster still lead to it until the cluster gets rebuilt
+	/// </summary>
+	template<class T_NodeType, class T_ConnectionType, class T_HeuristicPolicy>
+	inline void HPAStar<T_NodeType, T_ConnectionType, T_HeuristicPolicy>::RemoveNode(int nodeIdx)
+	{
+		AbstractNode& node = m_Nodes[nodeIdx];
+		std::vector<int>& clusterNodes = m_ClusterNodes[node.clusterIdx];
+		clusterNodes.erase(std::find(clusterNodes.begin(), clusterNodes.end(), nodeIdx));
+
+		node.cellIdx = invalid_node_index;
+		node.clusterIdx = invalid_node_index;
+		node.partnerIdx = invalid_node_index;
+		node.edges.clear();
+		m_FreeNodes.push_back(nodeIdx);
+	}
+
+	/// <summary>
+	/// Get the amount of memory the abstract graph and the scratch buffers take
+	/// </summary>
+	/// <returns>the size in bytes</returns>
+	template<class T_NodeType, class T_ConnectionType, class T_HeuristicPolicy>
+	inline size_t HPAStar<T_NodeType, T_ConnectionType, T_HeuristicPolicy>::GetMemorySize() const
+	{
+		size_t memorySize{ m_Nodes.capacity() * sizeof(AbstractNode) + m_FreeNodes.capacity() * sizeof(int) };
+		for (const AbstractNode& node : m_Nodes)
+			memorySize += node.edges.capacity() * sizeof(AbstractEdge);
+		for (const std::vector<int>& clusterNodes : m_ClusterNodes)
+			memorySize += sizeof(clusterNodes) + clusterNodes.capacity() * sizeof(int);
+		for (const std::vector<int>& borderNodes : m_BorderNodes)
+			memorySize += sizeof(borderNodes) + borderNodes.capacity() * sizeof(int);
+		return memorySize
+			+ m_IsDirty.capacity() * sizeof(int)
+			+ m_ClusterContext.GetScratchMemorySize();
+	}
+
+	/// <summary>
+	/// Get the cost between 2 cells of the grid using the heuristic function
+	/// </summary>
+	/// <param name="fromIdx">the start cell</param>
+	/// <param name="toIdx">the end cell</param>
+	/// <returns>the cost between these cells</returns>
+	template<class T_NodeType, class T_ConnectionType, class T_HeuristicPolicy>
+	inline float HPAStar<T_NodeType, T_ConnectionType, T_HeuristicPolicy>::GetHeuristicCost(int fromIdx, int toIdx) const
+	{
+		const int nrOfColumns{ m_pGraph->GetColumns() };
+		return m_Heuristic(abs(toIdx % nrOfColumns - fromIdx % nrOfColumns), abs(toIdx / nrOfColumns - fromIdx / nrOfColumns));
+	}
+}
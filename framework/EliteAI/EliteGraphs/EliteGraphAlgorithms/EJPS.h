@@ -1,55 +1,109 @@
 #pragma once
 
+#include "framework/EliteAI/EliteGraphs/EliteGraphUtilities/ESearchContext.h"
+#include "framework/EliteAI/EliteGraphs/EliteGraphUtilities/ESearchObservers.h"
+#include "framework/EliteAI/EliteGraphs/EliteGraphUtilities/EGridPath.h"
+#include "framework/EliteAI/EliteGraphs/EliteGraphUtilities/EJPSNeighborTable.h"
+#include "framework/EliteAI/EliteGraphs/EliteGraphUtilities/ECompressedGraph.h"
+#include "framework/EliteAI/EliteGraphs/EliteGraphUtilities/EGraphAdjacency.h"
+#include "framework/EliteAI/EliteGraphs/EImplicitGridGraph.h"
+
 namespace Elite
 {
-	template <class T_NodeType, class T_ConnectionType>
+	template <class T_NodeType, class T_ConnectionType, class T_HeuristicPolicy = HeuristicPolicies::Function>
 	class JPS
 	{
 	public:
-		JPS(GridGraph<T_NodeType, T_ConnectionType>* pGraph, Heuristic hFunction);
-
-		// stores the optimal connection to a node and its total costs related to the start and end node of the path
-		struct NodeRecord
-		{
-			T_NodeType* pNode = nullptr;
-			T_NodeType* pNodeJumpedFrom = nullptr;
-			T_ConnectionType* pConnection = nullptr;
-			float costSoFar = 0.f; // accumulated g-costs of all the connections leading up to this one
-			float estimatedTotalCost = 0.f; // f-cost (= costSoFar + h-cost)
-
-			bool operator==(const NodeRecord& other) const
-			{
-				return pNode == other.pNode
-					&& pConnection == other.pConnection
-					&& costSoFar == other.costSoFar
-					&& estimatedTotalCost == other.estimatedTotalCost;
-			};
-
-			bool operator<(const NodeRecord& other) const
-			{
-				return estimatedTotalCost < other.estimatedTotalCost;
-			};
-		};
-
-		std::vector<T_NodeType*> FindPath(T_NodeType* pStartNode, T_NodeType* pDestinationNode, std::vector<T_NodeType*>& openListRender, std::vector<T_NodeType*>& closedListRender);
+		JPS(GridGraph<T_NodeType, T_ConnectionType>* pGraph, T_HeuristicPolicy heuristic = T_HeuristicPolicy{});
+		// searches a grid without node objects, only the FindPath overload that takes node indices works then
+		JPS(const ImplicitGridGraph* pGraph, T_HeuristicPolicy heuristic = T_HeuristicPolicy{});
+
+		std::vector<T_NodeType*> FindPath(T_NodeType* pStartNode, T_NodeType* pDestinationNode);
+		bool FindPath(T_NodeType* pStartNode, T_NodeType* pDestinationNode, SearchContext& context);
+		bool FindPath(int startIdx, int destinationIdx, SearchContext& context);
+		// tells the observer about every node it generates and expands, see SearchObservers
+		template<class T_SearchObserver>
+		bool FindPath(int startIdx, int destinationIdx, SearchContext& context, T_SearchObserver& observer);
+
+		void ExpandPath(std::vector<int>& path) const;
+
+		void SetHeuristicFunction(T_HeuristicPolicy heuristic) { m_Heuristic = heuristic; }
+		// when set, FindPath returns every cell on the path instead of only the jump points
+		void SetExpandPath(bool expandPath) { m_ExpandPath = expandPath; }
+		// search the compressed copy of the graph instead of its connection lists, nullptr to go back to the lists
+		// the copy has to be kept up to date with the graph by the caller
+		void SetCompressedGraph(const CompressedGraph* pCompressedGraph) { m_pCompressedGraph = pCompressedGraph; }
 
 	private:
-		void GetNearestNodeToEnd(NodeRecord& nearestNodeToEnd, vector<NodeRecord>& closedList, T_NodeType* pDestinationNode) const;
-		void IdentifySuccessors(NodeRecord currentRecord, T_NodeType* pStartNode, T_NodeType* pDestinationNode, std::vector<NodeRecord>& successors);
-		void PruneNeighbors(NodeRecord currentRecord, std::vector<NodeRecord>& prunedNeighbors, T_NodeType* pDestinationNode);
-		float GetCostNoCurrentRecord(std::list<T_ConnectionType*> connections, T_NodeType* neighbor, T_NodeType* parent) const;
-		float GetHeuristicCost(T_NodeType* pStartNode, T_NodeType* pDestinationNode) const;
-		T_NodeType* Jump(NodeRecord currentRecord, Elite::Vector2 direction, T_NodeType* pStartNode, T_NodeType* pDestinationNode, float& costSoFar);
+		template<class T_Adjacency, class T_SearchObserver>
+		bool Search(const T_Adjacency& adjacency, int startIdx, int destinationIdx, SearchContext& context, T_SearchObserver& observer);
+		template<class T_Adjacency>
+		void IdentifySuccessors(const T_Adjacency& adjacency, int currentIdx, int parentIdx, float costSoFar, int destinationIdx);
+		float GetHeuristicCost(int fromIdx, int toIdx) const;
+		template<class T_Adjacency>
+		int Jump(const T_Adjacency& adjacency, int col, int row, int deltaCol, int deltaRow, int destinationIdx, float& costSoFar);
+		template<class T_Adjacency>
+		int JumpStraight(const T_Adjacency& adjacency, int col, int row, int deltaCol, int deltaRow, int destinationIdx, float& costSoFar);
+		template<class T_Adjacency>
+		int JumpDiagonal(const T_Adjacency& adjacency, int col, int row, int deltaCol, int deltaRow, int destinationIdx, float& costSoFar);
+		template<class T_Adjacency>
+		bool IsWalkable(const T_Adjacency& adjacency, int col, int row) const;
+		bool IsWithinBounds(int col, int row) const { return col >= 0 && col < m_NrOfColumns && row >= 0 && row < m_NrOfRows; }
+		template<class T_Adjacency>
+		bool HasDefaultCosts(const T_Adjacency& adjacency, int idx) const;
 
 		GridGraph<T_NodeType, T_ConnectionType>* m_pGraph;
-		Heuristic m_HeuristicFunction;
+		const CompressedGraph* m_pCompressedGraph = nullptr;
+		const ImplicitGridGraph* m_pImplicitGraph = nullptr;
+		T_HeuristicPolicy m_Heuristic;
+
+		// the layout of the grid, copied out of the graph so both kinds of grid get searched the same way
+		int m_NrOfColumns;
+		int m_NrOfRows;
+		float m_DefaultCostStraight;
+		float m_DefaultCostDiagonal;
+		bool m_IsCornerCuttingAllowed;
+		bool m_ExpandPath = false;
+
+		// used by the FindPath overload that doesn't get a context
+		SearchContext m_Context;
+
+		// jump points found by IdentifySuccessors with the cost to get there, kept around so expanding a node doesn't allocate
+		struct Successor
+		{
+			int idx;
+			float costSoFar;
+		};
+		vector<Successor> m_Successors;
+		// cells the jumps of the current search stepped onto, handed to the search statistics at the end
+		int m_NrOfJumpSteps = 0;
 	};
 
-	template<class T_NodeType, class T_ConnectionType>
-	inline JPS<T_NodeType, T_ConnectionType>::JPS(GridGraph<T_NodeType, T_ConnectionType>* pGraph, Heuristic hFunction)
+	template<class T_NodeType, class T_ConnectionType, class T_HeuristicPolicy>
+	inline JPS<T_NodeType, T_ConnectionType, T_HeuristicPolicy>::JPS(GridGraph<T_NodeType, T_ConnectionType>* pGraph, T_HeuristicPolicy heuristic)
 		: m_pGraph{ pGraph }
-		, m_HeuristicFunction{ hFunction }
+		, m_Heuristic{ heuristic }
+		, m_NrOfColumns{ pGraph->GetColumns() }
+		, m_NrOfRows{ pGraph->GetRows() }
+		, m_DefaultCostStraight{ pGraph->GetDefaultCostStraight() }
+		, m_DefaultCostDiagonal{ pGraph->GetDefaultCostDiagonal() }
+		, m_IsCornerCuttingAllowed{ pGraph->IsCornerCuttingAllowed() }
 	{
+		m_Successors.reserve(GridDirections::nr_of_directions);
+	}
+
+	template<class T_NodeType, class T_ConnectionType, class T_HeuristicPolicy>
+	inline JPS<T_NodeType, T_ConnectionType, T_HeuristicPolicy>::JPS(const ImplicitGridGraph* pGraph, T_HeuristicPolicy heuristic)
+		: m_pGraph{ nullptr }
+		, m_pImplicitGraph{ pGraph }
+		, m_Heuristic{ heuristic }
+		, m_NrOfColumns{ pGraph->GetColumns() }
+		, m_NrOfRows{ pGraph->GetRows() }
+		, m_DefaultCostStraight{ pGraph->GetDefaultCostStraight() }
+		, m_DefaultCostDiagonal{ pGraph->GetDefaultCostDiagonal() }
+		, m_IsCornerCuttingAllowed{ pGraph->IsCornerCuttingAllowed() }
+	{
+		m_Successors.reserve(GridDirections::nr_of_directions);
 	}
 
 	/// <summary>
@@ -59,528 +113,381 @@ namespace Elite
 	/// <typeparam name="T_ConnectionType"><The type of connection used on the graph/typeparam>
 	/// <param name="pStartNode">The start node we want to find a path FROM</param>
 	/// <param name="pDestinationNode">The destination node we want to find a path TO</param>
-	/// <param name="openListRender">vector of nodes that gets filled up to visualize the open list in the renderer</param>
-	/// <param name="closedListRender">vector of nodes that gets filled up to visualize the closed list in the renderer</param>
 	/// <returns>returns the path between the 2 nodes</returns>
-	template<class T_NodeType, class T_ConnectionType>
-	inline std::vector<T_NodeType*> JPS<T_NodeType, T_ConnectionType>::FindPath(T_NodeType* pStartNode, T_NodeType* pDestinationNode, std::vector<T_NodeType*>& openListRender, std::vector<T_NodeType*>& closedListRender)
+	template<class T_NodeType, class T_ConnectionType, class T_HeuristicPolicy>
+	inline std::vector<T_NodeType*> JPS<T_NodeType, T_ConnectionType, T_HeuristicPolicy>::FindPath(T_NodeType* pStartNode, T_NodeType* pDestinationNode)
+	{
+		FindPath(pStartNode, pDestinationNode, m_Context);
+
+		vector<T_NodeType*> finalPath;
+		finalPath.reserve(m_Context.GetPath().size());
+		for (int idx : m_Context.GetPath())
+			finalPath.push_back(m_pGraph->GetNode(idx));
+
+		return finalPath;
+	}
+
+	/// <summary>
+	/// find a path from 2 given nodes on the graph, using the buffers of the given context so repeated queries don't allocate
+	/// </summary>
+	/// <typeparam name="T_NodeType">The type of node used on the graph</typeparam>
+	/// <typeparam name="T_ConnectionType"><The type of connection used on the graph/typeparam>
+	/// <param name="pStartNode">The start node we want to find a path FROM</param>
+	/// <param name="pDestinationNode">The destination node we want to find a path TO</param>
+	/// <param name="context">The scratch buffers to search with, the node indices of the jump points (or of all cells, see SetExpandPath) on the path end up in context.GetPath()</param>
+	/// <returns>true if the destination was reached, otherwise the path leads to the node closest to the destination</returns>
+	template<class T_NodeType, class T_ConnectionType, class T_HeuristicPolicy>
+	inline bool JPS<T_NodeType, T_ConnectionType, T_HeuristicPolicy>::FindPath(T_NodeType* pStartNode, T_NodeType* pDestinationNode, SearchContext& context)
+	{
+		assert(m_pGraph && "<JPS::FindPath>: an implicit grid has no nodes, search it by node index");
+		return FindPath(pStartNode->GetIndex(), pDestinationNode->GetIndex(), context);
+	}
+
+	/// <summary>
+	/// find a path from 2 given node indices, the only way to search an implicit grid
+	/// </summary>
+	/// <param name="startIdx">The index of the node we want to find a path FROM</param>
+	/// <param name="destinationIdx">The index of the node we want to find a path TO</param>
+	/// <param name="context">The scratch buffers to search with, the node indices of the jump points (or of all cells, see SetExpandPath) on the path end up in context.GetPath()</param>
+	/// <returns>true if the destination was reached, otherwise the path leads to the node closest to the destination</returns>
+	template<class T_NodeType, class T_ConnectionType, class T_HeuristicPolicy>
+	inline bool JPS<T_NodeType, T_ConnectionType, T_HeuristicPolicy>::FindPath(int startIdx, int destinationIdx, SearchContext& context)
+	{
+		SearchObservers::None observer{};
+		return FindPath(startIdx, destinationIdx, context, observer);
+	}
+
+	/// <summary>
+	/// find a path from 2 given node indices and report the search to an observer
+	/// </summary>
+	/// <typeparam name="T_SearchObserver">SearchObservers::Recorder to draw the open and closed list, SearchObservers::Statistics to count</typeparam>
+	/// <param name="observer">Gets OnNodeGenerated and OnNodeExpanded calls while searching</param>
+	/// <returns>true if the destination was reached, otherwise the path leads to the node closest to the destination</returns>
+	template<class T_NodeType, class T_ConnectionType, class T_HeuristicPolicy>
+	template<class T_SearchObserver>
+	inline bool JPS<T_NodeType, T_ConnectionType, T_HeuristicPolicy>::FindPath(int startIdx, int destinationIdx, SearchContext& context, T_SearchObserver& observer)
+	{
+		if (m_pImplicitGraph)
+			return Search(*m_pImplicitGraph, startIdx, destinationIdx, context, observer);
+		if (m_pCompressedGraph)
+			return Search(*m_pCompressedGraph, startIdx, destinationIdx, context, observer);
+		return Search(GraphAdjacency<T_NodeType, T_ConnectionType>{ m_pGraph }, startIdx, destinationIdx, context, observer);
+	}
+
+	/// <summary>
+	/// The search itself, written once for the connection lists of the graph and for its compressed copy
+	/// </summary>
+	/// <typeparam name="T_Adjacency">GraphAdjacency, CompressedGraph or ImplicitGridGraph</typeparam>
+	template<class T_NodeType, class T_ConnectionType, class T_HeuristicPolicy>
+	template<class T_Adjacency, class T_SearchObserver>
+	inline bool JPS<T_NodeType, T_ConnectionType, T_HeuristicPolicy>::Search(const T_Adjacency& adjacency, int startIdx, int destinationIdx, SearchContext& context, T_SearchObserver& observer)
 	{
 		//Here we will calculate our path using Jump Point Search
 		bool foundPath{ false };
-		vector<T_NodeType*> finalPath;
-		vector<NodeRecord> openList;
-		vector<NodeRecord> closedList;
-		NodeRecord currentRecord{};
-		NodeRecord startRecord{};
-		startRecord.pNode = pStartNode;
-		startRecord.pConnection = nullptr;
-		startRecord.estimatedTotalCost = GetHeuristicCost(pStartNode, pDestinationNode);
-		openList.push_back(startRecord);
-
-		while (!openList.empty())
+
+		//closed jump point closest to the destination, the path leads there when the destination can't be reached
+		int nearestIdx{ startIdx };
+		float nearestHeuristicCost{ FLT_MAX };
+
+		//start a new search: every node becomes unvisited and the open list is emptied
+		context.BeginSearch(adjacency.GetNrOfNodes());
+		IndexedPriorityQueue<float>& openList = context.GetOpenList();
+		SearchStateTable& nodeStates = context.GetNodeStates();
+		m_NrOfJumpSteps = 0;
+
+		SearchNodeState& startState = nodeStates.Visit(startIdx);
+		startState.estimatedTotalCost = GetHeuristicCost(startIdx, destinationIdx);
+		startState.status = SearchNodeStatus::Open;
+		openList.Push(startIdx, startState.estimatedTotalCost);
+
+		while (!openList.IsEmpty())
 		{
-			//sort the openlist by estimated total cost, then set the currentrecord to the first one(lowest cost)
-			std::sort(openList.begin(), openList.end());
-			currentRecord = openList.front();
+			//take the jump point with the lowest estimated total cost off the open list
+			const int currentIdx{ openList.Pop() };
 
-			// if the currentrecord is the goal node we no longer have to keep searching for a path, so we can stop this while loop
-			if (currentRecord.pNode == pDestinationNode)
+			// if the current jump point is the goal node we no longer have to keep searching for a path, so we can stop this while loop
+			if (currentIdx == destinationIdx)
 			{
 				foundPath = true;
 				break;
 			}
+			context.CountExpandedNode();
 
 			//find all successors to jump to and loop over them
-			std::vector<NodeRecord> successors;
-			IdentifySuccessors(currentRecord, pStartNode, pDestinationNode, successors);
-			for (auto successor : successors)
+			SearchNodeState& currentState = nodeStates.GetState(currentIdx);
+			IdentifySuccessors(adjacency, currentIdx, currentState.parentIdx, currentState.costSoFar, destinationIdx);
+			for (const Successor& successor : m_Successors)
 			{
-				float costSoFar = successor.costSoFar;
-				bool cheaperFound{ false };
-				//find the successor in the closed list
-				for (std::vector<NodeRecord>::iterator it{ closedList.begin() }; it != closedList.end();)
+				//if the successor is already on the open or closed list, only continue when this jump to it is cheaper
+				//a cheaper jump to a closed successor reopens it
+				bool isOnOpenList{ false };
+				if (nodeStates.IsVisited(successor.idx))
 				{
-					NodeRecord& recordIterator = *it;
-					if (successor.pNode == recordIterator.pNode)
+					const SearchNodeState& successorState = nodeStates.GetState(successor.idx);
+					if (successorState.costSoFar <= successor.costSoFar)
 					{
-						//switch the record in the closed list out with the successor if this record is cheaper
-						if (recordIterator.costSoFar > costSoFar)
-						{
-							std::iter_swap(it, closedList.end() - 1);
-							closedList.pop_back();
-						}
-						else
-						{
-							cheaperFound = true;
-							++it;
-						}
-						break;
-					}
-					else
-						++it;
-				}
-				//if there is a cheaper record found in the closed list, continue to the next successor
-				if (cheaperFound)
-				{
-					continue;
-				}
-				cheaperFound = false;
-				//find the successor in the closed list
-				for (std::vector<NodeRecord>::iterator it{ openList.begin() }; it != openList.end();)
-				{
-					NodeRecord& recordIterator = *it;
-					if (successor.pNode == recordIterator.pNode)
-					{
-						//switch the record in the open list out with the successor if this record is cheaper
-						if (recordIterator.costSoFar > costSoFar)
-						{
-							std::iter_swap(it, openList.end() - 1);
-							openList.pop_back();
-						}
-						else
-						{
-							++it;
-							cheaperFound = true;
-						}
-						break;
+						continue;
 					}
-					else
-						++it;
-				}
-				//if there is a cheaper record found in the open list, continue to the next successor
-				if (cheaperFound)
-				{
-					continue;
+					isOnOpenList = successorState.status == SearchNodeStatus::Open;
+					if (!isOnOpenList)
+						context.CountReopenedNode();
 				}
-				//add the successor to the open list if it doesn't exist yet
-				NodeRecord newNode{};
-				newNode.pNode = successor.pNode;
-				newNode.pNodeJumpedFrom = successor.pNodeJumpedFrom;
-				newNode.pConnection = successor.pConnection;
-				newNode.costSoFar = costSoFar;
-				newNode.estimatedTotalCost = newNode.costSoFar + GetHeuristicCost(newNode.pNode, pDestinationNode);
-				openList.push_back(newNode);
-				openListRender.push_back(successor.pNode);
+
+				//add the successor to the open list if it isn't on it yet, otherwise lower its cost
+				SearchNodeState& successorState = nodeStates.Visit(successor.idx);
+				successorState.costSoFar = successor.costSoFar;
+				successorState.estimatedTotalCost = successor.costSoFar + GetHeuristicCost(successor.idx, destinationIdx);
+				successorState.parentIdx = currentIdx;
+				successorState.status = SearchNodeStatus::Open;
+				if (isOnOpenList)
+					openList.DecreaseKey(successor.idx, successorState.estimatedTotalCost);
+				else
+					openList.Push(successor.idx, successorState.estimatedTotalCost);
+				context.CountGeneratedNode();
+				observer.OnNodeGenerated(successor.idx);
+			}
+			//close the current jump point, it was already taken off the open list
+			currentState.status = SearchNodeStatus::Closed;
+			observer.OnNodeExpanded(currentIdx);
+
+			float heuristicCost{ currentState.estimatedTotalCost - currentState.costSoFar };
+			if (heuristicCost < nearestHeuristicCost)
+			{
+				nearestHeuristicCost = heuristicCost;
+				nearestIdx = currentIdx;
 			}
-			//add the current record to the closed list and remove it from the open list
-			closedList.push_back(currentRecord);
-			closedListRender.push_back(currentRecord.pNode);
-			openList.erase(openList.begin());
 		}
+		context.CountJumpSteps(m_NrOfJumpSteps);
+		context.BeginReconstruction();
 
-		//if there is no path possible, set the current record to the nearest node to the end
-		if (!foundPath)
+		//if there is no path possible, lead the path to the nearest jump point to the end
+		//follow the jump parents back to the start (jump points get added in reverse order)
+		std::vector<int>& finalPath = context.GetPath();
+		for (int currentIdx = foundPath ? destinationIdx : nearestIdx; currentIdx != invalid_node_index; currentIdx = nodeStates.GetState(currentIdx).parentIdx)
 		{
-			GetNearestNodeToEnd(currentRecord, closedList, pDestinationNode);
+			finalPath.push_back(currentIdx);
 		}
+		std::reverse(finalPath.begin(), finalPath.end());
 
-		//loop over the closed list and create a path to the current node
-		while (currentRecord.pNode != pStartNode)
+		if (m_ExpandPath)
 		{
-			finalPath.push_back(currentRecord.pNode);
-			for (std::vector<NodeRecord>::iterator it{ closedList.begin() }; it != closedList.end();)
-			{
-				NodeRecord& recordIterator = *it;
-				if (recordIterator.pNode == currentRecord.pNodeJumpedFrom)
-				{
-					currentRecord = recordIterator;
-					break;
-				}
-				else
-					++it;
-			}
+			ExpandPath(finalPath);
 		}
-		//add the start node to the finalpath and reverse the path (nodes got added in reverse order)
-		finalPath.push_back(pStartNode);
-		std::reverse(finalPath.begin(), finalPath.end());
 
-		return finalPath;
+		context.EndSearch();
+		return foundPath;
 	}
 
 	/// <summary>
-	/// Find the node closest to the destination node on the closed list
+	/// Fill in the cells between the jump points of a path
 	/// </summary>
 	/// <typeparam name="T_NodeType">The type of node used on the graph</typeparam>
 	/// <typeparam name="T_ConnectionType"><The type of connection used on the graph/typeparam>
-	/// <param name="nearestNodeToEnd">noderecord to put the closest node into</param>
-	/// <param name="closedList">closedlist to loop over</param>
-	/// <param name="pDestinationNode">destination node of the path</param>
-	template<class T_NodeType, class T_ConnectionType>
-	inline void JPS<T_NodeType, T_ConnectionType>::GetNearestNodeToEnd(NodeRecord& nearestNodeToEnd, vector<NodeRecord>& closedList, T_NodeType* pDestinationNode) const
+	/// <param name="path">node indices of the jump points on the path, gets replaced by the indices of every cell on the path</param>
+	template<class T_NodeType, class T_ConnectionType, class T_HeuristicPolicy>
+	inline void JPS<T_NodeType, T_ConnectionType, T_HeuristicPolicy>::ExpandPath(std::vector<int>& path) const
 	{
-		float lowestCost{ FLT_MAX };
-		for (vector<NodeRecord>::iterator it{ closedList.begin() }; it != closedList.end();)
-		{
-			NodeRecord& recordIterator = *it;
-			float costNodeToGoal = GetHeuristicCost(recordIterator.pNode, pDestinationNode);
-			if (costNodeToGoal < lowestCost && recordIterator.pNode != pDestinationNode)
-			{
-				lowestCost = costNodeToGoal;
-				nearestNodeToEnd = recordIterator;
-			}
-			++it;
-		}
+		ExpandGridPath(path, m_NrOfColumns);
 	}
 
 	/// <summary>
-	/// find the potential successors of the current record
+	/// find the successors of a jump point: jump in the directions the pruning table keeps and store the jump points that were found in m_Successors
 	/// </summary>
 	/// <typeparam name="T_NodeType">The type of node used on the graph</typeparam>
 	/// <typeparam name="T_ConnectionType"><The type of connection used on the graph/typeparam>
-	/// <param name="currentRecord">the record we want to get the successors of</param>
-	/// <param name="pStartNode">The start node on the graph</param>
-	/// <param name="pDestinationNode">The end node on the graph</param>
-	/// <param name="successors">returns the successors of the current record</param>
-	template<class T_NodeType, class T_ConnectionType>
-	inline void JPS<T_NodeType, T_ConnectionType>::IdentifySuccessors(NodeRecord currentRecord, T_NodeType* pStartNode, T_NodeType* pDestinationNode, std::vector<NodeRecord>& successors)
+	/// <param name="currentIdx">the jump point we want to get the successors of</param>
+	/// <param name="parentIdx">the jump point we jumped from to get here, invalid_node_index for the start node</param>
+	/// <param name="costSoFar">the cost to get to the current jump point</param>
+	/// <param name="destinationIdx">The end node on the graph</param>
+	template<class T_NodeType, class T_ConnectionType, class T_HeuristicPolicy>
+	template<class T_Adjacency>
+	inline void JPS<T_NodeType, T_ConnectionType, T_HeuristicPolicy>::IdentifySuccessors(const T_Adjacency& adjacency, int currentIdx, int parentIdx, float costSoFar, int destinationIdx)
 	{
-		//Get all relevant neighbors of the current record
-		std::vector<NodeRecord> neighbors;
-		PruneNeighbors(currentRecord, neighbors, pDestinationNode);
+		m_Successors.clear();
 
-		//loop over the neighbors
-		for (auto neighbor : neighbors)
-		{
-			float costSoFar = currentRecord.costSoFar;
-
-			//Direction the neighbor is in relation with the current record
-			float directionX{ m_pGraph->GetNodePos(neighbor.pNode).x - m_pGraph->GetNodePos(currentRecord.pNode).x };
-			float directionY{ m_pGraph->GetNodePos(neighbor.pNode).y - m_pGraph->GetNodePos(currentRecord.pNode).y };
-			Elite::Vector2 directionVector{ directionX, directionY };
-		
-			//Jump in the direction of this neighbor until we can't find a node anymore to find the jump point
-			T_NodeType* jumpNode = Jump(currentRecord, directionVector, pStartNode, pDestinationNode, costSoFar);
-			//if there is a jump node found, add it to the successors
-			if (jumpNode)
-			{
-				Elite::Vector2 previousNodePos{ jumpNode->GetPosition() - directionVector };
-				auto previousNodePosGraph{ m_pGraph->GetNodeWorldPos(int(previousNodePos.x), int(previousNodePos.y)) };
-				auto previousNodeIdx = m_pGraph->GetNodeFromWorldPos(previousNodePosGraph);
-				auto connectionToParent = m_pGraph->GetConnection(previousNodeIdx, jumpNode->GetIndex());
-				NodeRecord successor;
-				successor.pNode = jumpNode;
-				successor.pNodeJumpedFrom = currentRecord.pNode;
-				successor.costSoFar = costSoFar;
-				successor.pConnection = connectionToParent;
-				successors.push_back(successor);
-			}
-		}
-	}
+		const int col{ currentIdx % m_NrOfColumns };
+		const int row{ currentIdx / m_NrOfColumns };
 
-	/// <summary>
-	/// Prune the neighbors to only get the ones relevant for the jump point search algorithm
-	/// </summary>
-	/// <typeparam name="T_NodeType">The type of node used on the graph</typeparam>
-	/// <typeparam name="T_ConnectionType"><The type of connection used on the graph/typeparam>
-	/// <param name="currentRecord">The record of which the neighbors get evaluated</param>
-	/// <param name="prunedNeighbors">The vector where the neighbors get added to</param>
-	/// <param name="pDestinationNode">The destination node on the graph that we want to get to</param>
-	template<class T_NodeType, class T_ConnectionType>
-	inline void JPS<T_NodeType, T_ConnectionType>::PruneNeighbors(NodeRecord currentRecord, std::vector<NodeRecord>& prunedNeighbors, T_NodeType* pDestinationNode)
-	{
-		//if the current record has no connection to a parent (the start node), add all his neighbors to the vector
-		if (currentRecord.pConnection== nullptr)
+		//every neighbor we have a connection to can be walked on, the others are blocked
+		unsigned int walkableNeighbors{ 0 };
+		adjacency.ForEachConnection(currentIdx, [&](int neighborIdx, float)
 		{
-			for (auto currentConnection : m_pGraph->GetNodeConnections(currentRecord.pNode->GetIndex()))
-			{
-				auto neighbor{ m_pGraph->GetNode(currentConnection->GetTo()) };
-				NodeRecord neighBorRecord;
-				neighBorRecord.pNode = neighbor;
-				neighBorRecord.pConnection = currentConnection;
-				neighBorRecord.costSoFar = currentRecord.costSoFar + currentConnection->GetCost();
-				neighBorRecord.estimatedTotalCost = neighBorRecord.costSoFar + GetHeuristicCost(neighBorRecord.pNode, pDestinationNode);
-				prunedNeighbors.push_back(neighBorRecord);
-			}
-			return;
-		}
-		//get the parent of the record to find the direction it's in relation with this record
-		int parentIndex{ currentRecord.pConnection->GetFrom() };
-		auto parent = m_pGraph->GetNode(parentIndex);
-		auto parentConnections = m_pGraph->GetNodeConnections(parent->GetIndex());
-		Elite::Vector2 orientationVectorParent{ Clamp(m_pGraph->GetNodePos(currentRecord.pNode).x - m_pGraph->GetNodePos(parent).x  , -1.f, 1.f) ,
-												Clamp(m_pGraph->GetNodePos(currentRecord.pNode).y - m_pGraph->GetNodePos(parent).y  , -1.f, 1.f) };
-		//loop over all connections of the record
-		for (auto currentConnection : m_pGraph->GetNodeConnections(currentRecord.pNode->GetIndex()))
+			walkableNeighbors |= 1u << GridDirections::GetDirection(neighborIdx % m_NrOfColumns - col, neighborIdx / m_NrOfColumns - row);
+			return true;
+		});
+
+		//the start node has no direction yet and other terrain around a node breaks the symmetry the pruning relies on,
+		//jump to every neighbor from those
+		unsigned int directions{ walkableNeighbors };
+		if (parentIdx != invalid_node_index && HasDefaultCosts(adjacency, currentIdx))
 		{
-			auto neighbor = m_pGraph->GetNode(currentConnection->GetTo());
-			//if the current evalued neighbor is the parent, ignore this neighbor
-			if (neighbor == parent)
-			{
-				continue;
-			}
-			//if the current evalued neighbor is also a neighbor of the parent, ignore this neighbor
-			auto it = std::find_if(parentConnections.begin(), parentConnections.end(), [&neighbor](T_ConnectionType* c)
-				{
-					return c->GetTo() == neighbor->GetIndex();
-				});
-			if (it != parentConnections.end())
-			{
-				continue;
-			}
+			const int parentCol{ parentIdx % m_NrOfColumns };
+			const int parentRow{ parentIdx / m_NrOfColumns };
+			const int direction{ GridDirections::GetDirection((col > parentCol) - (col < parentCol), (row > parentRow) - (row < parentRow)) };
+			directions = JPSNeighborTable::GetDirectionsToExplore(direction, static_cast<unsigned char>(~walkableNeighbors), m_IsCornerCuttingAllowed);
+		}
 
-			//if the currently evalued neighbor is in the same direction as the record is from the parent, add it to the pruned neighbors
-			Elite::Vector2 orientationVectorNeighbor{ Clamp(m_pGraph->GetNodePos(neighbor).x - m_pGraph->GetNodePos(currentRecord.pNode).x, -1.f, 1.f) ,
-													  Clamp(m_pGraph->GetNodePos(neighbor).y - m_pGraph->GetNodePos(currentRecord.pNode).y, -1.f, 1.f) };
-			if (orientationVectorNeighbor == orientationVectorParent)
-			{
-				NodeRecord neighBorRecord;
-				neighBorRecord.pNode = neighbor;
-				neighBorRecord.pConnection = currentConnection;
-				neighBorRecord.costSoFar = currentRecord.costSoFar + currentConnection->GetCost();
-				neighBorRecord.estimatedTotalCost = neighBorRecord.costSoFar + GetHeuristicCost(neighBorRecord.pNode, pDestinationNode);
-				prunedNeighbors.push_back(neighBorRecord);
-				continue;
-			}
-			float costToNeighbor{ currentRecord.pConnection->GetCost() + currentConnection->GetCost() };
-			//diagonal movement
-			if (orientationVectorParent.x != 0 && orientationVectorParent.y != 0)
-			{
-				//if the cost to get to te currently evalued neighbor is (strictly) lower without going through the current record than with, ignore it (prune)
-				//otherwise add it to the neighbors
-				float costToNeighborNoCurrentRecord{ GetCostNoCurrentRecord(m_pGraph->GetNodeConnections(currentRecord.pNode->GetIndex()), neighbor, parent) };
-				if (costToNeighborNoCurrentRecord < costToNeighbor)
-				{
-					continue;
-				}
-				NodeRecord neighBorRecord;
-				neighBorRecord.pNode = neighbor;
-				neighBorRecord.pConnection = currentConnection;
-				neighBorRecord.costSoFar = currentRecord.costSoFar + currentConnection->GetCost();
-				neighBorRecord.estimatedTotalCost = neighBorRecord.costSoFar + GetHeuristicCost(neighBorRecord.pNode, pDestinationNode);
-				prunedNeighbors.push_back(neighBorRecord);
-				continue;
-			}
-			//horizontal and vertical movement
-			else
-			{
-				//if the cost to get to te currently evalued neighbor is lower or equal without going through the current record than with, ignore it (prune)
-				//otherwise add it to the neighbors
-				float costToNeighborNoCurrentRecord{ GetCostNoCurrentRecord(m_pGraph->GetNodeConnections(currentRecord.pNode->GetIndex()), neighbor, parent) };
-				if (costToNeighborNoCurrentRecord <= costToNeighbor)
-				{
-					continue;
-				}
-				NodeRecord neighBorRecord;
-				neighBorRecord.pNode = neighbor;
-				neighBorRecord.pConnection = currentConnection;
-				neighBorRecord.costSoFar = currentRecord.costSoFar + currentConnection->GetCost();
-				neighBorRecord.estimatedTotalCost = neighBorRecord.costSoFar + GetHeuristicCost(neighBorRecord.pNode, pDestinationNode);
-				prunedNeighbors.push_back(neighBorRecord);
+		//Jump in the direction of every remaining neighbor to find the jump points
+		for (int direction = 0; direction < GridDirections::nr_of_directions; ++direction)
+		{
+			if ((directions & (1u << direction)) == 0)
 				continue;
-			}
 
-			//forced neighbors
-			NodeRecord neighBorRecord;
-			neighBorRecord.pNode = neighbor;
-			neighBorRecord.pConnection = currentConnection;
-			neighBorRecord.costSoFar = currentRecord.costSoFar + currentConnection->GetCost();
-			neighBorRecord.estimatedTotalCost = neighBorRecord.costSoFar + GetHeuristicCost(neighBorRecord.pNode, pDestinationNode);
-			prunedNeighbors.push_back(neighBorRecord);
+			Successor successor;
+			successor.costSoFar = costSoFar;
+			successor.idx = Jump(adjacency, col, row, GridDirections::GetDeltaCol(direction), GridDirections::GetDeltaRow(direction), destinationIdx, successor.costSoFar);
+			if (successor.idx != invalid_node_index)
+				m_Successors.push_back(successor);
 		}
 	}
 
 	/// <summary>
-	/// Gets the cost to get to a neighbor, without going through the current record
+	/// Get the cost between 2 nodes on the graph using the heuristic function
 	/// </summary>
 	/// <typeparam name="T_NodeType">The type of node used on the graph</typeparam>
 	/// <typeparam name="T_ConnectionType"><The type of connection used on the graph/typeparam>
-	/// <param name="connections">all the connections of the current record</param>
-	/// <param name="neighbor">evalued neighbor</param>
-	/// <param name="parent">parent of the current record</param>
-	/// <returns>returns the cost to the neighbor without going through the current record (if possible)</returns>
-	template<class T_NodeType, class T_ConnectionType>
-	inline float JPS<T_NodeType, T_ConnectionType>::GetCostNoCurrentRecord(std::list<T_ConnectionType*> connections, T_NodeType* neighbor, T_NodeType* parent) const
+	/// <param name="fromIdx">the start node</param>
+	/// <param name="toIdx">the endnode</param>
+	/// <returns>the cost between these nodes</returns>
+	template<class T_NodeType, class T_ConnectionType, class T_HeuristicPolicy>
+	inline float JPS<T_NodeType, T_ConnectionType, T_HeuristicPolicy>::GetHeuristicCost(int fromIdx, int toIdx) const
 	{
-		//loop over the connections of the parent
-		for (auto currentConnectionParent : m_pGraph->GetNodeConnections(parent->GetIndex()))
-		{
-			float costToNeighbor{ 0.f };
-			//neighbor of the parent at the end of this connection
-			auto neighborParent{ m_pGraph->GetNode(currentConnectionParent->GetTo()) };
-
-			//check if this neighbor is in the connections list of the current record
-			auto connectionIt = std::find_if(connections.begin(), connections.end(),[&neighborParent, this](T_ConnectionType* c)
-				{
-					return neighborParent == this->m_pGraph->GetNode(c->GetTo());
-				});
-
-			if (connectionIt != connections.end())
-			{
-				costToNeighbor += currentConnectionParent->GetCost();
-				//check if this neighbor has a connection with the goal node.
-				std::list<T_ConnectionType*> connectionsOfConnection = m_pGraph->GetNodeConnections((*connectionIt)->GetTo());
-				auto goalIt = std::find_if(connectionsOfConnection.begin(), connectionsOfConnection.end(), [&neighbor, this](T_ConnectionType* c)
-					{
-						return neighbor == this->m_pGraph->GetNode(c->GetTo());
-					});
-				if (goalIt != connectionsOfConnection.end())
-				{
-					costToNeighbor += (*goalIt)->GetCost();
-					return costToNeighbor;
-				}
-			}
-		}
-		//return 0 if there is no possible (low enough) path from the parent to this neighbor
-		return 0.0f;
+		return m_Heuristic(abs(toIdx % m_NrOfColumns - fromIdx % m_NrOfColumns), abs(toIdx / m_NrOfColumns - fromIdx / m_NrOfColumns));
 	}
 
 	/// <summary>
-	/// Get the cost between 2 nodes on the graph using the heuristic function
+	/// Jump in a certain direction until a jump point is found or it is no longer possible to continue
 	/// </summary>
 	/// <typeparam name="T_NodeType">The type of node used on the graph</typeparam>
 	/// <typeparam name="T_ConnectionType"><The type of connection used on the graph/typeparam>
-	/// <param name="pStartNode">the start node</param>
-	/// <param name="pEndNode">the endnode</param>
-	/// <returns>the cost between these nodes</returns>
-	template<class T_NodeType, class T_ConnectionType>
-	inline float JPS<T_NodeType, T_ConnectionType>::GetHeuristicCost(T_NodeType* pStartNode, T_NodeType* pEndNode) const
+	/// <param name="col">The column of the cell to jump from</param>
+	/// <param name="row">The row of the cell to jump from</param>
+	/// <param name="deltaCol">The column step of the direction to jump into (-1, 0 or 1)</param>
+	/// <param name="deltaRow">The row step of the direction to jump into (-1, 0 or 1)</param>
+	/// <param name="destinationIdx">The index of the destination node of the path to find</param>
+	/// <param name="costSoFar">Cost before the jump, the cost of every step of the jump gets added to it when a jump point is found</param>
+	/// <returns>The index of the found node to jump to, invalid_node_index if there is none</returns>
+	template<class T_NodeType, class T_ConnectionType, class T_HeuristicPolicy>
+	template<class T_Adjacency>
+	inline int JPS<T_NodeType, T_ConnectionType, T_HeuristicPolicy>::Jump(const T_Adjacency& adjacency, int col, int row, int deltaCol, int deltaRow, int destinationIdx, float& costSoFar)
 	{
-		Vector2 toDestination = m_pGraph->GetNodePos(pEndNode) - m_pGraph->GetNodePos(pStartNode);
-		return m_HeuristicFunction(abs(toDestination.x), abs(toDestination.y));
+		if (deltaCol != 0 && deltaRow != 0)
+			return JumpDiagonal(adjacency, col, row, deltaCol, deltaRow, destinationIdx, costSoFar);
+		return JumpStraight(adjacency, col, row, deltaCol, deltaRow, destinationIdx, costSoFar);
 	}
 
 	/// <summary>
-	/// Jump in a certain direction until it is no longer possible to continue
+	/// Walk a horizontal or vertical line one cell at a time until a jump point is found
+	/// a cell is a jump point when it is the destination, when its costs differ from the defaults (other terrain around it)
+	/// or when a blocked cell beside it has a walkable cell after it (a forced neighbor),
+	/// without corner cutting when a walkable cell beside it had a blocked cell before it
 	/// </summary>
-	/// <typeparam name="T_NodeType">The type of node used on the graph</typeparam>
-	/// <typeparam name="T_ConnectionType"><The type of connection used on the graph/typeparam>
-	/// <param name="currentRecord">The record to jump from</param>
-	/// <param name="direction">The direction to jump into</param>
-	/// <param name="pStartNode">The start node of the path to find</param>
-	/// <param name="pEndNode">The destination node of the path to find</param>
-	/// <param name="costSoFar">Cost of the jump</param>
-	/// <returns>The found node to jump to</returns>
-	template<class T_NodeType, class T_ConnectionType>
-	inline T_NodeType* JPS<T_NodeType, T_ConnectionType>::Jump(NodeRecord currentRecord, Elite::Vector2 direction, T_NodeType* pStartNode, T_NodeType* pDestinationNode, float& costSoFar)
+	template<class T_NodeType, class T_ConnectionType, class T_HeuristicPolicy>
+	template<class T_Adjacency>
+	inline int JPS<T_NodeType, T_ConnectionType, T_HeuristicPolicy>::JumpStraight(const T_Adjacency& adjacency, int col, int row, int deltaCol, int deltaRow, int destinationIdx, float& costSoFar)
 	{
-		Elite::Vector2 nextNodePos{ currentRecord.pNode->GetPosition() + direction };
-		auto nextNodePosGraph{ m_pGraph->GetNodeWorldPos(int(nextNodePos.x), int(nextNodePos.y)) };
-		auto nextNodeIdx = m_pGraph->GetNodeFromWorldPos(nextNodePosGraph);
-		//if there is no node to jump to, return nullptr
-		if (nextNodeIdx < 0)
-		{
-			return nullptr;
-		}
-		
-		//if there is a node, but no way to jump to it (no connection), return nullptr
-		auto connection = m_pGraph->GetConnection(currentRecord.pNode->GetIndex(), nextNodeIdx);
-		if (connection == nullptr)
-		{
-			return nullptr;
-		}
-		NodeRecord nextNode;
-		nextNode.pNode = m_pGraph->GetNode(nextNodeIdx);
+		const int step{ deltaRow * m_NrOfColumns + deltaCol };
+		int idx{ row * m_NrOfColumns + col };
+		float cost{ costSoFar };
 
-		//if the node to jump to is the destination node, return it
-		if (nextNode.pNode == pDestinationNode)
+		while (IsWithinBounds(col + deltaCol, row + deltaRow))
 		{
-			return nextNode.pNode;
+			//if there is a node, but no way to jump to it (no connection), there is no jump point on this line
+			float stepCost;
+			if (!adjacency.TryGetConnectionCost(idx, idx + step, stepCost))
+				return invalid_node_index;
+
+			cost += stepCost;
+			col += deltaCol;
+			row += deltaRow;
+			idx += step;
+			++m_NrOfJumpSteps;
+
+			//the cells beside the line are the ones across the direction, (deltaRow, deltaCol) points to one side
+			const bool isForced{ m_IsCornerCuttingAllowed
+				? (!IsWalkable(adjacency, col + deltaRow, row + deltaCol) && IsWalkable(adjacency, col + deltaCol + deltaRow, row + deltaRow + deltaCol)) ||
+					(!IsWalkable(adjacency, col - deltaRow, row - deltaCol) && IsWalkable(adjacency, col + deltaCol - deltaRow, row + deltaRow - deltaCol))
+				: (IsWalkable(adjacency, col + deltaRow, row + deltaCol) && !IsWalkable(adjacency, col - deltaCol + deltaRow, row - deltaRow + deltaCol)) ||
+					(IsWalkable(adjacency, col - deltaRow, row - deltaCol) && !IsWalkable(adjacency, col - deltaCol - deltaRow, row - deltaRow - deltaCol)) };
+			if (idx == destinationIdx || isForced || !HasDefaultCosts(adjacency, idx))
+			{
+				costSoFar = cost;
+				return idx;
+			}
 		}
+		return invalid_node_index;
+	}
 
-		auto connectionsNextNode = m_pGraph->GetConnections(nextNodeIdx);
+	/// <summary>
+	/// Walk a diagonal line one cell at a time until a jump point is found
+	/// besides the rules of a straight line, a cell is a jump point when a straight jump along one of the components of the diagonal finds one
+	/// without corner cutting a diagonal can't pass a blocked cell, so only the straight jumps find its jump points
+	/// </summary>
+	template<class T_NodeType, class T_ConnectionType, class T_HeuristicPolicy>
+	template<class T_Adjacency>
+	inline int JPS<T_NodeType, T_ConnectionType, T_HeuristicPolicy>::JumpDiagonal(const T_Adjacency& adjacency, int col, int row, int deltaCol, int deltaRow, int destinationIdx, float& costSoFar)
+	{
+		const int step{ deltaRow * m_NrOfColumns + deltaCol };
+		int idx{ row * m_NrOfColumns + col };
+		float cost{ costSoFar };
 
-		//diagonal direction
-		if (direction.x != 0 && direction.y != 0)
+		while (IsWithinBounds(col + deltaCol, row + deltaRow))
 		{
-			//check for diagonal forced neighbors
-			for (auto connection : connectionsNextNode)
+			float stepCost;
+			if (!adjacency.TryGetConnectionCost(idx, idx + step, stepCost))
+				return invalid_node_index;
+
+			cost += stepCost;
+			col += deltaCol;
+			row += deltaRow;
+			idx += step;
+			++m_NrOfJumpSteps;
+
+			//a blocked cell behind on one side with a walkable cell diagonally past it
+			const bool isForced{ m_IsCornerCuttingAllowed &&
+				((!IsWalkable(adjacency, col - deltaCol, row) && IsWalkable(adjacency, col - deltaCol, row + deltaRow)) ||
+				(!IsWalkable(adjacency, col, row - deltaRow) && IsWalkable(adjacency, col + deltaCol, row - deltaRow))) };
+			if (idx == destinationIdx || isForced || !HasDefaultCosts(adjacency, idx))
 			{
-				auto neighbor = m_pGraph->GetNode(connection->GetTo());
-
-				//if the neighbor to check is the original node, go to the next connection
-				if(neighbor == currentRecord.pNode)
-				{
-					continue;
-				}
-
-				//if the neighbor is diagonal, check if it's forced
-				Elite::Vector2 directionToNeighbor{ Clamp(m_pGraph->GetNodePos(neighbor).x - m_pGraph->GetNodePos(nextNode.pNode).x  , -1.f, 1.f) ,
-													Clamp(m_pGraph->GetNodePos(neighbor).y - m_pGraph->GetNodePos(nextNode.pNode).y  , -1.f, 1.f) };
-				if (directionToNeighbor.x != 0 && directionToNeighbor.y != 0)
-				{
-					float costToNeighborNoCurrentRecord{ GetCostNoCurrentRecord(m_pGraph->GetNodeConnections(nextNodeIdx), neighbor, currentRecord.pNode) };
-					float costToNeighbor{ m_pGraph->GetConnection(nextNodeIdx, currentRecord.pNode->GetIndex())->GetCost() + connection->GetCost() };
-					if (costToNeighborNoCurrentRecord < costToNeighbor&&
-						costToNeighborNoCurrentRecord > 0.f)
-					{
-						continue;
-					}
-					return nextNode.pNode;
-				}
+				costSoFar = cost;
+				return idx;
 			}
 
-			//check for horizontal and vertical forced neighbors
-			if (Jump(nextNode, Elite::Vector2(direction.x, 0.f), pStartNode, pDestinationNode, costSoFar) != nullptr ||
-				Jump(nextNode, Elite::Vector2(0.f, direction.y), pStartNode, pDestinationNode, costSoFar) != nullptr)
+			//the straight scans only have to find out whether there is a jump point, the second one is skipped when the first finds one
+			float straightCost{ 0.f };
+			if (JumpStraight(adjacency, col, row, deltaCol, 0, destinationIdx, straightCost) != invalid_node_index ||
+				JumpStraight(adjacency, col, row, 0, deltaRow, destinationIdx, straightCost) != invalid_node_index)
 			{
-				return nextNode.pNode;
+				costSoFar = cost;
+				return idx;
 			}
 		}
-		else
-		{
-			//horizontal direction
-			if (direction.x != 0)
-			{
-				//check for horizontal forced neighbors
-				for (auto connection : connectionsNextNode)
-				{
-					auto neighbor = m_pGraph->GetNode(connection->GetTo());
-
-					//if the neighbor to check is the original node, go to the next connection
-					if (neighbor == currentRecord.pNode)
-					{
-						continue;
-					}
-
-					//if the neighbor is horizontal, check if it's forced
-					Elite::Vector2 directionToNeighbor{ Clamp(m_pGraph->GetNodePos(neighbor).x - m_pGraph->GetNodePos(nextNode.pNode).x  , -1.f, 1.f) ,
-														Clamp(m_pGraph->GetNodePos(neighbor).y - m_pGraph->GetNodePos(nextNode.pNode).y  , -1.f, 1.f) };
-					if (directionToNeighbor.x != 0 && directionToNeighbor.y == 0)
-					{
-						float costToNeighborNoCurrentRecord{ GetCostNoCurrentRecord(m_pGraph->GetNodeConnections(nextNodeIdx), neighbor, currentRecord.pNode) };
-						float costToNeighbor{ m_pGraph->GetConnection(nextNodeIdx, currentRecord.pNode->GetIndex())->GetCost() + connection->GetCost() };
-						if (costToNeighborNoCurrentRecord <= costToNeighbor &&
-							costToNeighborNoCurrentRecord > 0.f)
-						{
-							continue;
-						}
-						return nextNode.pNode;
-					}
-				}
-			}
-			//vertical direction
-			else
-			{
-				//check for vertical forced neighbors
-				for (auto connection : connectionsNextNode)
-				{
-					auto neighbor = m_pGraph->GetNode(connection->GetTo());
+		return invalid_node_index;
+	}
 
-					//if the neighbor to check is the original node, go to the next connection
-					if (neighbor == currentRecord.pNode)
-					{
-						continue;
-					}
+	/// <summary>
+	/// Check whether a cell can be walked on, cells outside the grid and cells without connections (water) can't
+	/// </summary>
+	template<class T_NodeType, class T_ConnectionType, class T_HeuristicPolicy>
+	template<class T_Adjacency>
+	inline bool JPS<T_NodeType, T_ConnectionType, T_HeuristicPolicy>::IsWalkable(const T_Adjacency& adjacency, int col, int row) const
+	{
+		return IsWithinBounds(col, row) && adjacency.HasConnections(row * m_NrOfColumns + col);
+	}
 
-					//if the neighbor is vertical, check if it's forced
-					Elite::Vector2 directionToNeighbor{ Clamp(m_pGraph->GetNodePos(neighbor).x - m_pGraph->GetNodePos(nextNode.pNode).x  , -1.f, 1.f) ,
-														Clamp(m_pGraph->GetNodePos(neighbor).y - m_pGraph->GetNodePos(nextNode.pNode).y  , -1.f, 1.f) };
-					if (directionToNeighbor.x == 0 && directionToNeighbor.y != 0)
-					{
-						float costToNeighborNoCurrentRecord{ GetCostNoCurrentRecord(m_pGraph->GetNodeConnections(nextNodeIdx), neighbor, currentRecord.pNode) };
-						float costToNeighbor{ m_pGraph->GetConnection(nextNodeIdx, currentRecord.pNode->GetIndex())->GetCost() + connection->GetCost() };
-						if (costToNeighborNoCurrentRecord <= costToNeighbor &&
-							costToNeighborNoCurrentRecord > 0.f)
-						{
-							continue;
-						}
-						return nextNode.pNode;
-					}
-				}
-			}
-		}
-		//increment the cost of the jump with the cost of the current connection and jump to the next node
-		costSoFar += connection->GetCost();
-		return Jump(nextNode, direction, pStartNode, pDestinationNode, costSoFar);
+	/// <summary>
+	/// Check whether all connections of a cell have the default straight or diagonal cost of the grid
+	/// jumps only skip over such cells, taking another route around them never changes the cost
+	/// </summary>
+	template<class T_NodeType, class T_ConnectionType, class T_HeuristicPolicy>
+	template<class T_Adjacency>
+	inline bool JPS<T_NodeType, T_ConnectionType, T_HeuristicPolicy>::HasDefaultCosts(const T_Adjacency& adjacency, int idx) const
+	{
+		return adjacency.ForEachConnection(idx, [&](int neighborIdx, float cost)
+		{
+			const int offset{ neighborIdx - idx };
+			const bool isStraight{ offset == 1 || offset == -1 || offset == m_NrOfColumns || offset == -m_NrOfColumns };
+			return cost == (isStraight ? m_DefaultCostStraight : m_DefaultCostDiagonal);
+		});
 	}
-}
\ No newline at end of file
+}
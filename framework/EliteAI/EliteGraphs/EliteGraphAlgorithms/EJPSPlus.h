@@ -0,0 +1,409 @@
+#pragma once
+
+#include "framework/EliteAI/EliteGraphs/EliteGraphAlgorithms/EJPS.h"
+#include "framework/EliteAI/EliteGraphs/EliteGraphUtilities/EJumpDistanceTable.h"
+
+namespace Elite
+{
+	// JPS+: the distance of every jump from every cell is precomputed (JumpDistanceTable), so searching never scans the grid
+	// meant for maps that rarely change, an edit repairs the table around the edited cell
+	// like BlockJPS this only runs on grids with uniform costs (no mud), other grids are handed to the regular JPS
+	template <class T_NodeType, class T_ConnectionType, class T_HeuristicPolicy = HeuristicPolicies::Function>
+	class JPSPlus
+	{
+	public:
+		JPSPlus(GridGraph<T_NodeType, T_ConnectionType>* pGraph, T_HeuristicPolicy heuristic = T_HeuristicPolicy{});
+
+		std::vector<T_NodeType*> FindPath(T_NodeType* pStartNode, T_NodeType* pDestinationNode);
+		bool FindPath(T_NodeType* pStartNode, T_NodeType* pDestinationNode, SearchContext& context);
+		bool FindPath(int startIdx, int destinationIdx, SearchContext& context);
+		// tells the observer about every node it generates and expands, see SearchObservers
+		template<class T_SearchObserver>
+		bool FindPath(int startIdx, int destinationIdx, SearchContext& context, T_SearchObserver& observer);
+
+		// reads the whole graph again and recomputes the table
+		void UpdateGrid();
+		// reads the connections around an edited node again and repairs the table around it
+		void UpdateNode(int idx);
+		// repairs the table around a batch of edited nodes at once, big batches build everything again
+		void UpdateNodes(const std::vector<int>& nodeIndices);
+		const WalkabilityGrid& GetGrid() const { return m_Grid; }
+		const JumpDistanceTable& GetJumpDistances() const { return m_JumpDistances; }
+
+		void SetHeuristicFunction(T_HeuristicPolicy heuristic);
+		// when set, FindPath returns every cell on the path instead of only the jump points
+		void SetExpandPath(bool expandPath);
+
+	private:
+		void IdentifySuccessors(int col, int row, int parentCol, int parentRow, int destinationCol, int destinationRow);
+		void AddSuccessor(int col, int row, int deltaCol, int deltaRow, int destinationCol, int destinationRow);
+		float GetHeuristicCost(int fromIdx, int toIdx) const;
+
+		GridGraph<T_NodeType, T_ConnectionType>* m_pGraph;
+		T_HeuristicPolicy m_Heuristic;
+		bool m_ExpandPath = false;
+
+		WalkabilityGrid m_Grid;
+		JumpDistanceTable m_JumpDistances;
+		std::vector<int> m_ChangedCells;
+		JPS<T_NodeType, T_ConnectionType, T_HeuristicPolicy> m_FallbackJPS;
+
+		// jump points found by IdentifySuccessors, with the amount of steps it took to get there
+		struct Successor
+		{
+			int idx;
+			int nrOfSteps;
+			bool isDiagonal;
+		};
+		vector<Successor> m_Successors;
+		// table lookups of the current search, handed to the search statistics at the end
+		int m_NrOfJumpSteps = 0;
+
+		// used by the FindPath overload that doesn't get a context
+		SearchContext m_Context;
+	};
+
+	template<class T_NodeType, class T_ConnectionType, class T_HeuristicPolicy>
+	inline JPSPlus<T_NodeType, T_ConnectionType, T_HeuristicPolicy>::JPSPlus(GridGraph<T_NodeType, T_ConnectionType>* pGraph, T_HeuristicPolicy heuristic)
+		: m_pGraph{ pGraph }
+		, m_Heuristic{ heuristic }
+		, m_FallbackJPS{ pGraph, heuristic }
+	{
+		m_Successors.reserve(8);
+		UpdateGrid();
+	}
+
+	template<class T_NodeType, class T_ConnectionType, class T_HeuristicPolicy>
+	inline void JPSPlus<T_NodeType, T_ConnectionType, T_HeuristicPolicy>::UpdateGrid()
+	{
+		m_Grid.Build(m_pGraph);
+		m_JumpDistances.Build(m_Grid);
+	}
+
+	template<class T_NodeType, class T_ConnectionType, class T_HeuristicPolicy>
+	inline void JPSPlus<T_NodeType, T_ConnectionType, T_HeuristicPolicy>::UpdateNode(int idx)
+	{
+		const int nrOfColumns{ m_pGraph->GetColumns() };
+		m_ChangedCells.clear();
+		m_Grid.UpdateCell(m_pGraph, idx % nrOfColumns, idx / nrOfColumns, &m_ChangedCells);
+		m_JumpDistances.Repair(m_Grid, m_ChangedCells);
+	}
+
+	template<class T_NodeType, class T_ConnectionType, class T_HeuristicPolicy>
+	inline void JPSPlus<T_NodeType, T_ConnectionType, T_HeuristicPolicy>::UpdateNodes(const std::vector<int>& nodeIndices)
+	{
+		//every changed cell gets a 5x5 area repaired in 8 directions, past an eighth of the grid building it all again is cheaper
+		const int nrOfColumns{ m_pGraph->GetColumns() };
+		if (int(nodeIndices.size()) > nrOfColumns * m_pGraph->GetRows() / 8)
+		{
+			UpdateGrid();
+			return;
+		}
+
+		m_ChangedCells.clear();
+		for (int idx : nodeIndices)
+		{
+			m_Grid.UpdateCell(m_pGraph, idx % nrOfColumns, idx / nrOfColumns, &m_ChangedCells);
+		}
+		m_JumpDistances.Repair(m_Grid, m_ChangedCells);
+	}
+
+	template<class T_NodeType, class T_ConnectionType, class T_HeuristicPolicy>
+	inline void JPSPlus<T_NodeType, T_ConnectionType, T_HeuristicPolicy>::SetHeuristicFunction(T_HeuristicPolicy heuristic)
+	{
+		m_Heuristic = heuristic;
+		m_FallbackJPS.SetHeuristicFunction(heuristic);
+	}
+
+	template<class T_NodeType, class T_ConnectionType, class T_HeuristicPolicy>
+	inline void JPSPlus<T_NodeType, T_ConnectionType, T_HeuristicPolicy>::SetExpandPath(bool expandPath)
+	{
+		m_ExpandPath = expandPath;
+		m_FallbackJPS.SetExpandPath(expandPath);
+	}
+
+	/// <summary>
+	/// find a path from 2 given nodes on the graph
+	/// </summary>
+	/// <typeparam name="T_NodeType">The type of node used on the graph</typeparam>
+	/// <typeparam name="T_ConnectionType"><The type of connection used on the graph/typeparam>
+	/// <param name="pStartNode">The start node we want to find a path FROM</param>
+	/// <param name="pDestinationNode">The destination node we want to find a path TO</param>
+	/// <returns>returns the path between the 2 nodes</returns>
+	template<class T_NodeType, class T_ConnectionType, class T_HeuristicPolicy>
+	inline std::vector<T_NodeType*> JPSPlus<T_NodeType, T_ConnectionType, T_HeuristicPolicy>::FindPath(T_NodeType* pStartNode, T_NodeType* pDestinationNode)
+	{
+		FindPath(pStartNode, pDestinationNode, m_Context);
+
+		vector<T_NodeType*> finalPath;
+		finalPath.reserve(m_Context.GetPath().size());
+		for (int idx : m_Context.GetPath())
+			finalPath.push_back(m_pGraph->GetNode(idx));
+
+		return finalPath;
+	}
+
+	/// <summary>
+	/// find a path from 2 given nodes on the graph, using the buffers of the given context so repeated queries don't allocate
+	/// </summary>
+	/// <typeparam name="T_NodeType">The type of node used on the graph</typeparam>
+	/// <typeparam name="T_ConnectionType"><The type of connection used on the graph/typeparam>
+	/// <param name="pStartNode">The start node we want to find a path FROM</param>
+	/// <param name="pDestinationNode">The destination node we want to find a path TO</param>
+	/// <param name="context">The scratch buffers to search with, the node indices of the jump points (or of all cells, see SetExpandPath) on the path end up in context.GetPath()</param>
+	/// <returns>true if the destination was reached, otherwise the path leads to the node closest to the destination</returns>
+	template<class T_NodeType, class T_ConnectionType, class T_HeuristicPolicy>
+	inline bool JPSPlus<T_NodeType, T_ConnectionType, T_HeuristicPolicy>::FindPath(T_NodeType* pStartNode, T_NodeType* pDestinationNode, SearchContext& context)
+	{
+		return FindPath(pStartNode->GetIndex(), pDestinationNode->GetIndex(), context);
+	}
+
+	/// <summary>
+	/// find a path from 2 given node indices
+	/// </summary>
+	/// <param name="startIdx">The index of the node we want to find a path FROM</param>
+	/// <param name="destinationIdx">The index of the node we want to find a path TO</param>
+	/// <param name="context">The scratch buffers to search with, the node indices of the jump points (or of all cells, see SetExpandPath) on the path end up in context.GetPath()</param>
+	/// <returns>true if the destination was reached, otherwise the path leads to the node closest to the destination</returns>
+	template<class T_NodeType, class T_ConnectionType, class T_HeuristicPolicy>
+	inline bool JPSPlus<T_NodeType, T_ConnectionType, T_HeuristicPolicy>::FindPath(int startIdx, int destinationIdx, SearchContext& context)
+	{
+		SearchObservers::None observer{};
+		return FindPath(startIdx, destinationIdx, context, observer);
+	}
+
+	/// <summary>
+	/// find a path from 2 given node indices and report the search to an observer
+	/// </summary>
+	/// <typeparam name="T_SearchObserver">SearchObservers::Recorder to draw the open and closed list, SearchObservers::Statistics to count</typeparam>
+	/// <param name="observer">Gets OnNodeGenerated and OnNodeExpanded calls while searching, also when the search is handed to the regular JPS</param>
+	/// <returns>true if the destination was reached, otherwise the path leads to the node closest to the destination</returns>
+	template<class T_NodeType, class T_ConnectionType, class T_HeuristicPolicy>
+	template<class T_SearchObserver>
+	inline bool JPSPlus<T_NodeType, T_ConnectionType, T_HeuristicPolicy>::FindPath(int startIdx, int destinationIdx, SearchContext& context, T_SearchObserver& observer)
+	{
+		//the bits can't hold different costs, let the regular JPS handle those grids
+		if (!m_Grid.IsUniformCost())
+		{
+			return m_FallbackJPS.FindPath(startIdx, destinationIdx, context, observer);
+		}
+
+		bool foundPath{ false };
+		const int nrOfColumns{ m_Grid.GetColumns() };
+		const int destinationCol{ destinationIdx % nrOfColumns };
+		const int destinationRow{ destinationIdx / nrOfColumns };
+
+		//closed jump point closest to the destination, the path leads there when the destination can't be reached
+		int nearestIdx{ startIdx };
+		float nearestHeuristicCost{ FLT_MAX };
+
+		//start a new search: every node becomes unvisited and the open list is emptied
+		context.BeginSearch(m_pGraph->GetNrOfNodes());
+		IndexedPriorityQueue<float>& openList = context.GetOpenList();
+		SearchStateTable& nodeStates = context.GetNodeStates();
+		m_NrOfJumpSteps = 0;
+
+		SearchNodeState& startState = nodeStates.Visit(startIdx);
+		startState.estimatedTotalCost = GetHeuristicCost(startIdx, destinationIdx);
+		startState.status = SearchNodeStatus::Open;
+		openList.Push(startIdx, startState.estimatedTotalCost);
+
+		while (!openList.IsEmpty())
+		{
+			//take the jump point with the lowest estimated total cost off the open list
+			const int currentIdx{ openList.Pop() };
+			if (currentIdx == destinationIdx)
+			{
+				foundPath = true;
+				break;
+			}
+			context.CountExpandedNode();
+
+			SearchNodeState& currentState = nodeStates.GetState(currentIdx);
+			const int col{ currentIdx % nrOfColumns };
+			const int row{ currentIdx / nrOfColumns };
+			const int parentCol{ currentState.parentIdx != invalid_node_index ? currentState.parentIdx % nrOfColumns : col };
+			const int parentRow{ currentState.parentIdx != invalid_node_index ? currentState.parentIdx / nrOfColumns : row };
+
+			IdentifySuccessors(col, row, parentCol, parentRow, destinationCol, destinationRow);
+			for (const Successor& successor : m_Successors)
+			{
+				const float stepCost{ successor.isDiagonal ? m_Grid.GetCostDiagonal() : m_Grid.GetCostStraight() };
+				const float costSoFar{ currentState.costSoFar + successor.nrOfSteps * stepCost };
+
+				//if the successor is already on the open or closed list, only continue when this jump to it is cheaper
+				bool isOnOpenList{ false };
+				if (nodeStates.IsVisited(successor.idx))
+				{
+					const SearchNodeState& successorState = nodeStates.GetState(successor.idx);
+					if (successorState.costSoFar <= costSoFar)
+					{
+						continue;
+					}
+					isOnOpenList = successorState.status == SearchNodeStatus::Open;
+					if (!isOnOpenList)
+						context.CountReopenedNode();
+				}
+
+				SearchNodeState& successorState = nodeStates.Visit(successor.idx);
+				successorState.costSoFar = costSoFar;
+				successorState.estimatedTotalCost = costSoFar + GetHeuristicCost(successor.idx, destinationIdx);
+				successorState.parentIdx = currentIdx;
+				successorState.status = SearchNodeStatus::Open;
+				if (isOnOpenList)
+					openList.DecreaseKey(successor.idx, successorState.estimatedTotalCost);
+				else
+					openList.Push(successor.idx, successorState.estimatedTotalCost);
+				context.CountGeneratedNode();
+				observer.OnNodeGenerated(successor.idx);
+			}
+
+			currentState.status = SearchNodeStatus::Closed;
+			observer.OnNodeExpanded(currentIdx);
+
+			float heuristicCost{ currentState.estimatedTotalCost - currentState.costSoFar };
+			if (heuristicCost < nearestHeuristicCost)
+			{
+				nearestHeuristicCost = heuristicCost;
+				nearestIdx = currentIdx;
+			}
+		}
+		context.CountJumpSteps(m_NrOfJumpSteps);
+		context.BeginReconstruction();
+
+		//follow the jump parents back to the start (jump points get added in reverse order)
+		std::vector<int>& finalPath = context.GetPath();
+		for (int currentIdx = foundPath ? destinationIdx : nearestIdx; currentIdx != invalid_node_index; currentIdx = nodeStates.GetState(currentIdx).parentIdx)
+		{
+			finalPath.push_back(currentIdx);
+		}
+		std::reverse(finalPath.begin(), finalPath.end());
+
+		if (m_ExpandPath)
+		{
+			ExpandGridPath(finalPath, nrOfColumns);
+		}
+
+		context.EndSearch();
+		return foundPath;
+	}
+
+	/// <summary>
+	/// Fill m_Successors with the jump points reachable from a cell, only looking in the natural and forced directions
+	/// </summary>
+	/// <param name="col">column of the cell</param>
+	/// <param name="row">row of the cell</param>
+	/// <param name="parentCol">column of the jump point we came from (the cell itself for the start)</param>
+	/// <param name="parentRow">row of the jump point we came from (the cell itself for the start)</param>
+	/// <param name="destinationCol">column of the destination</param>
+	/// <param name="destinationRow">row of the destination</param>
+	template<class T_NodeType, class T_ConnectionType, class T_HeuristicPolicy>
+	inline void JPSPlus<T_NodeType, T_ConnectionType, T_HeuristicPolicy>::IdentifySuccessors(int col, int row, int parentCol, int parentRow, int destinationCol, int destinationRow)
+	{
+		m_Successors.clear();
+
+		const int deltaCol{ (col > parentCol) - (col < parentCol) };
+		const int deltaRow{ (row > parentRow) - (row < parentRow) };
+
+		//the start has no direction yet, every neighbor is a successor
+		if (deltaCol == 0 && deltaRow == 0)
+		{
+			for (int neighborDeltaRow = -1; neighborDeltaRow <= 1; ++neighborDeltaRow)
+			{
+				for (int neighborDeltaCol = -1; neighborDeltaCol <= 1; ++neighborDeltaCol)
+				{
+					if (neighborDeltaCol != 0 || neighborDeltaRow != 0)
+						AddSuccessor(col, row, neighborDeltaCol, neighborDeltaRow, destinationCol, destinationRow);
+				}
+			}
+			return;
+		}
+
+		//diagonal movement: continue diagonally and along both of its straight components
+		//a blocked cell behind us on one side forces the diagonal on that side
+		if (deltaCol != 0 && deltaRow != 0)
+		{
+			AddSuccessor(col, row, deltaCol, 0, destinationCol, destinationRow);
+			AddSuccessor(col, row, 0, deltaRow, destinationCol, destinationRow);
+			AddSuccessor(col, row, deltaCol, deltaRow, destinationCol, destinationRow);
+			if (!m_Grid.IsWalkable(col - deltaCol, row))
+				AddSuccessor(col, row, -deltaCol, deltaRow, destinationCol, destinationRow);
+			if (!m_Grid.IsWalkable(col, row - deltaRow))
+				AddSuccessor(col, row, deltaCol, -deltaRow, destinationCol, destinationRow);
+			return;
+		}
+
+		//straight movement: continue straight, a blocked cell to the side forces the diagonal past it
+		AddSuccessor(col, row, deltaCol, deltaRow, destinationCol, destinationRow);
+		if (deltaCol != 0)
+		{
+			if (!m_Grid.IsWalkable(col, row - 1))
+				AddSuccessor(col, row, deltaCol, -1, destinationCol, destinationRow);
+			if (!m_Grid.IsWalkable(col, row + 1))
+				AddSuccessor(col, row, deltaCol, 1, destinationCol, destinationRow);
+		}
+		else
+		{
+			if (!m_Grid.IsWalkable(col - 1, row))
+				AddSuccessor(col, row, -1, deltaRow, destinationCol, destinationRow);
+			if (!m_Grid.IsWalkable(col + 1, row))
+				AddSuccessor(col, row, 1, deltaRow, destinationCol, destinationRow);
+		}
+	}
+
+	/// <summary>
+	/// Look up the jump from a cell in a direction and add the jump point to m_Successors if there is one
+	/// </summary>
+	template<class T_NodeType, class T_ConnectionType, class T_HeuristicPolicy>
+	inline void JPSPlus<T_NodeType, T_ConnectionType, T_HeuristicPolicy>::AddSuccessor(int col, int row, int deltaCol, int deltaRow, int destinationCol, int destinationRow)
+	{
+		const int direction{ GridDirections::GetDirection(deltaCol, deltaRow) };
+		const int distance{ m_JumpDistances.GetDistance(m_pGraph->GetIndex(col, row), direction) };
+		++m_NrOfJumpSteps;
+		const int nrOfFreeSteps{ distance > 0 ? distance : -distance };
+
+		//the destination isn't in the table: stop on it when the jump passes it or, diagonally, when the jump passes its row or column
+		int nrOfSteps{ 0 };
+		const int stepsToDestinationCol{ (destinationCol - col) * deltaCol };
+		const int stepsToDestinationRow{ (destinationRow - row) * deltaRow };
+		if (deltaRow == 0)
+		{
+			if (destinationRow == row && stepsToDestinationCol > 0 && stepsToDestinationCol <= nrOfFreeSteps)
+				nrOfSteps = stepsToDestinationCol;
+		}
+		else if (deltaCol == 0)
+		{
+			if (destinationCol == col && stepsToDestinationRow > 0 && stepsToDestinationRow <= nrOfFreeSteps)
+				nrOfSteps = stepsToDestinationRow;
+		}
+		else if (stepsToDestinationCol > 0 && stepsToDestinationRow > 0)
+		{
+			const int stepsToDestinationLine{ stepsToDestinationCol < stepsToDestinationRow ? stepsToDestinationCol : stepsToDestinationRow };
+			if (stepsToDestinationLine <= nrOfFreeSteps)
+				nrOfSteps = stepsToDestinationLine;
+		}
+
+		if (nrOfSteps == 0)
+		{
+			if (distance <= 0)
+				return;
+			nrOfSteps = distance;
+		}
+
+		Successor successor;
+		successor.idx = m_pGraph->GetIndex(col + nrOfSteps * deltaCol, row + nrOfSteps * deltaRow);
+		successor.nrOfSteps = nrOfSteps;
+		successor.isDiagonal = deltaCol != 0 && deltaRow != 0;
+		m_Successors.push_back(successor);
+	}
+
+	/// <summary>
+	/// Get the cost between 2 cells using the heuristic function
+	/// </summary>
+	template<class T_NodeType, class T_ConnectionType, class T_HeuristicPolicy>
+	inline float JPSPlus<T_NodeType, T_ConnectionType, T_HeuristicPolicy>::GetHeuristicCost(int fromIdx, int toIdx) const
+	{
+		const int nrOfColumns{ m_Grid.GetColumns() };
+		return m_Heuristic(abs(toIdx % nrOfColumns - fromIdx % nrOfColumns), abs(toIdx / nrOfColumns - fromIdx / nrOfColumns));
+	}
+}
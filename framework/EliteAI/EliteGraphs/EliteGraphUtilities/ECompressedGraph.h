@@ -0,0 +1,265 @@
+#pragma once
+
+namespace Elite
+{
+	// compressed sparse row copy of the connections of a graph: the connections of node idx are the entries
+	// m_Offsets[idx] up to m_Offsets[idx] + m_NrOfConnections[idx] of m_To and m_Costs, so walking them doesn't follow any pointers
+	// it doesn't follow edits of the graph by itself, call UpdateNode(s) for the edited nodes or Build again
+	class CompressedGraph final
+	{
+	public:
+		CompressedGraph() = default;
+		~CompressedGraph() = default;
+
+		// every node gets room for at least nrOfSlotsPerNode connections, UpdateNode can patch a node in place as long as its connections fit
+		template<class T_NodeType, class T_ConnectionType>
+		void Build(const IGraph<T_NodeType, T_ConnectionType>* pGraph, int nrOfSlotsPerNode = 0);
+		// copies every connection turned around, the connections of a node are the ones that lead to it (to search back over a directed graph)
+		// UpdateNode(s) can't patch this copy, build it again after an edit
+		template<class T_NodeType, class T_ConnectionType>
+		void BuildReversed(const IGraph<T_NodeType, T_ConnectionType>* pGraph);
+		// reads the connections of a node and of every node connected to it (before or after the edit) again, made for undirected graphs
+		template<class T_NodeType, class T_ConnectionType>
+		void UpdateNode(const IGraph<T_NodeType, T_ConnectionType>* pGraph, int idx);
+		// the same for a batch of nodes edited together, nodes connected to several of them are read once
+		template<class T_NodeType, class T_ConnectionType>
+		void UpdateNodes(const IGraph<T_NodeType, T_ConnectionType>* pGraph, const std::vector<int>& nodeIndices);
+
+		int GetNrOfNodes() const { return int(m_NrOfConnections.size()); }
+		int GetNrOfConnections() const { return m_NrOfUsedSlots; }
+		bool HasConnections(int idx) const { return m_NrOfConnections[idx] != 0; }
+
+		// calls function(to, cost) for every connection of the node, stops as soon as function returns false
+		// returns false when it was stopped
+		template<class T_Function>
+		bool ForEachConnection(int idx, T_Function function) const;
+		bool TryGetConnectionCost(int from, int to, float& cost) const;
+
+		size_t GetMemorySize() const;
+		int GetNrOfRebuilds() const { return m_NrOfRebuilds; }
+
+	private:
+		template<class T_NodeType, class T_ConnectionType>
+		bool ReadConnections(const IGraph<T_NodeType, T_ConnectionType>* pGraph, int idx);
+		template<class T_NodeType, class T_ConnectionType>
+		void AddNodesToUpdate(const IGraph<T_NodeType, T_ConnectionType>* pGraph, int idx);
+		template<class T_NodeType, class T_ConnectionType>
+		void ReadNodesToUpdate(const IGraph<T_NodeType, T_ConnectionType>* pGraph);
+
+		std::vector<int> m_Offsets;
+		std::vector<int> m_NrOfConnections;
+		std::vector<int> m_To;
+		std::vector<float> m_Costs;
+		int m_NrOfUsedSlots = 0;
+		int m_NrOfSlotsPerNode = 0;
+		int m_NrOfRebuilds = 0;
+		bool m_IsReversed = false;
+
+		// nodes UpdateNode has to read again
+		std::vector<int> m_NodesToUpdate;
+	};
+
+	/// <summary>
+	/// Copy the connections of every node of a graph
+	/// </summary>
+	/// <param name="pGraph">The graph to copy the connections of</param>
+	/// <param name="nrOfSlotsPerNode">The minimum amount of connections every node gets room for</param>
+	template<class T_NodeType, class T_ConnectionType>
+	inline void CompressedGraph::Build(const IGraph<T_NodeType, T_ConnectionType>* pGraph, int nrOfSlotsPerNode)
+	{
+		const int nrOfNodes{ pGraph->GetNrOfNodes() };
+		m_NrOfSlotsPerNode = nrOfSlotsPerNode;
+		m_IsReversed = false;
+		++m_NrOfRebuilds;
+
+		m_Offsets.resize(size_t(nrOfNodes) + 1);
+		m_NrOfConnections.assign(nrOfNodes, 0);
+		int nrOfSlots{ 0 };
+		for (int idx = 0; idx < nrOfNodes; ++idx)
+		{
+			const int nrOfConnections{ int(pGraph->GetNodeConnections(idx).size()) };
+			m_Offsets[idx] = nrOfSlots;
+			nrOfSlots += nrOfConnections > nrOfSlotsPerNode ? nrOfConnections : nrOfSlotsPerNode;
+		}
+		m_Offsets[nrOfNodes] = nrOfSlots;
+
+		m_To.assign(nrOfSlots, invalid_node_index);
+		m_Costs.assign(nrOfSlots, 0.f);
+		m_NrOfUsedSlots = 0;
+		for (int idx = 0; idx < nrOfNodes; ++idx)
+		{
+			ReadConnections(pGraph, idx);
+		}
+	}
+
+	/// <summary>
+	/// Copy the connections of every node of a graph in the other direction, packed without free slots
+	/// </summary>
+	/// <param name="pGraph">The graph to copy the connections of</param>
+	template<class T_NodeType, class T_ConnectionType>
+	inline void CompressedGraph::BuildReversed(const IGraph<T_NodeType, T_ConnectionType>* pGraph)
+	{
+		const int nrOfNodes{ pGraph->GetNrOfNodes() };
+		m_NrOfSlotsPerNode = 0;
+		m_IsReversed = true;
+		++m_NrOfRebuilds;
+
+		//count the connections that lead to every node first, so they can be written straight into their slots
+		m_NrOfConnections.assign(nrOfNodes, 0);
+		for (int idx = 0; idx < nrOfNodes; ++idx)
+		{
+			for (const T_ConnectionType* pConnection : pGraph->GetNodeConnections(idx))
+				++m_NrOfConnections[pConnection->GetTo()];
+		}
+
+		m_Offsets.resize(size_t(nrOfNodes) + 1);
+		int nrOfSlots{ 0 };
+		for (int idx = 0; idx < nrOfNodes; ++idx)
+		{
+			m_Offsets[idx] = nrOfSlots;
+			nrOfSlots += m_NrOfConnections[idx];
+		}
+		m_Offsets[nrOfNodes] = nrOfSlots;
+
+		m_To.assign(nrOfSlots, invalid_node_index);
+		m_Costs.assign(nrOfSlots, 0.f);
+		m_NrOfUsedSlots = nrOfSlots;
+		std::fill(m_NrOfConnections.begin(), m_NrOfConnections.end(), 0);
+		for (int idx = 0; idx < nrOfNodes; ++idx)
+		{
+			for (const T_ConnectionType* pConnection : pGraph->GetNodeConnections(idx))
+			{
+				const int to{ pConnection->GetTo() };
+				const int slot{ m_Offsets[to] + m_NrOfConnections[to]++ };
+				m_To[slot] = idx;
+				m_Costs[slot] = pConnection->GetCost();
+			}
+		}
+	}
+
+	/// <summary>
+	/// Patch the connections around an edited node, everything gets built again when they don't fit in their slots anymore
+	/// </summary>
+	/// <param name="pGraph">The edited graph</param>
+	/// <param name="idx">The node that got edited (isolated, connected again, costs changed ...)</param>
+	template<class T_NodeType, class T_ConnectionType>
+	inline void CompressedGraph::UpdateNode(const IGraph<T_NodeType, T_ConnectionType>* pGraph, int idx)
+	{
+		assert(!m_IsReversed && "<CompressedGraph::UpdateNode>: a reversed copy has to be built again");
+		if (pGraph->GetNrOfNodes() != GetNrOfNodes())
+		{
+			Build(pGraph, m_NrOfSlotsPerNode);
+			return;
+		}
+
+		m_NodesToUpdate.clear();
+		AddNodesToUpdate(pGraph, idx);
+		ReadNodesToUpdate(pGraph);
+	}
+
+	/// <summary>
+	/// Patch the connections around a batch of edited nodes
+	/// all nodes to read get collected before any of them is read, reading a node first would hide the connections it lost
+	/// </summary>
+	/// <param name="pGraph">The edited graph</param>
+	/// <param name="nodeIndices">The nodes that got edited</param>
+	template<class T_NodeType, class T_ConnectionType>
+	inline void CompressedGraph::UpdateNodes(const IGraph<T_NodeType, T_ConnectionType>* pGraph, const std::vector<int>& nodeIndices)
+	{
+		assert(!m_IsReversed && "<CompressedGraph::UpdateNodes>: a reversed copy has to be built again");
+		if (pGraph->GetNrOfNodes() != GetNrOfNodes())
+		{
+			Build(pGraph, m_NrOfSlotsPerNode);
+			return;
+		}
+
+		m_NodesToUpdate.clear();
+		for (int idx : nodeIndices)
+		{
+			AddNodesToUpdate(pGraph, idx);
+		}
+		ReadNodesToUpdate(pGraph);
+	}
+
+	template<class T_NodeType, class T_ConnectionType>
+	inline void CompressedGraph::AddNodesToUpdate(const IGraph<T_NodeType, T_ConnectionType>* pGraph, int idx)
+	{
+		//the nodes it was connected to lost their connection to it, the nodes it is connected to now gained one
+		m_NodesToUpdate.push_back(idx);
+		ForEachConnection(idx, [this](int to, float) { m_NodesToUpdate.push_back(to); return true; });
+		for (const T_ConnectionType* pConnection : pGraph->GetNodeConnections(idx))
+		{
+			m_NodesToUpdate.push_back(pConnection->GetTo());
+		}
+	}
+
+	template<class T_NodeType, class T_ConnectionType>
+	inline void CompressedGraph::ReadNodesToUpdate(const IGraph<T_NodeType, T_ConnectionType>* pGraph)
+	{
+		for (int nodeIdx : m_NodesToUpdate)
+		{
+			if (!ReadConnections(pGraph, nodeIdx))
+			{
+				Build(pGraph, m_NrOfSlotsPerNode);
+				return;
+			}
+		}
+	}
+
+	/// <summary>
+	/// Copy the connections of one node into its slots
+	/// </summary>
+	/// <returns>false if they don't fit, the node is left untouched then</returns>
+	template<class T_NodeType, class T_ConnectionType>
+	inline bool CompressedGraph::ReadConnections(const IGraph<T_NodeType, T_ConnectionType>* pGraph, int idx)
+	{
+		const auto& connections = pGraph->GetNodeConnections(idx);
+		if (int(connections.size()) > m_Offsets[size_t(idx) + 1] - m_Offsets[idx])
+			return false;
+
+		int slot{ m_Offsets[idx] };
+		for (const T_ConnectionType* pConnection : connections)
+		{
+			m_To[slot] = pConnection->GetTo();
+			m_Costs[slot] = pConnection->GetCost();
+			++slot;
+		}
+		m_NrOfUsedSlots += int(connections.size()) - m_NrOfConnections[idx];
+		m_NrOfConnections[idx] = int(connections.size());
+		return true;
+	}
+
+	template<class T_Function>
+	inline bool CompressedGraph::ForEachConnection(int idx, T_Function function) const
+	{
+		const int firstSlot{ m_Offsets[idx] };
+		const int endSlot{ firstSlot + m_NrOfConnections[idx] };
+		for (int slot = firstSlot; slot < endSlot; ++slot)
+		{
+			if (!function(m_To[slot], m_Costs[slot]))
+				return false;
+		}
+		return true;
+	}
+
+	inline bool CompressedGraph::TryGetConnectionCost(int from, int to, float& cost) const
+	{
+		const int firstSlot{ m_Offsets[from] };
+		const int endSlot{ firstSlot + m_NrOfConnections[from] };
+		for (int slot = firstSlot; slot < endSlot; ++slot)
+		{
+			if (m_To[slot] == to)
+			{
+				cost = m_Costs[slot];
+				return true;
+			}
+		}
+		return false;
+	}
+
+	inline size_t CompressedGraph::GetMemorySize() const
+	{
+		return m_Offsets.capacity() * sizeof(int) + m_NrOfConnections.capacity() * sizeof(int)
+			+ m_To.capacity() * sizeof(int) + m_Costs.capacity() * sizeof(float) + m_NodesToUpdate.capacity() * sizeof(int);
+	}
+}
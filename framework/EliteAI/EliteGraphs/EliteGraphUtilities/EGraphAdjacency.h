@@ -0,0 +1,97 @@
+#pragma once
+
+namespace Elite
+{
+	// the connection lists of an IGraph behind the same interface as CompressedGraph, so a search can be written once for both
+	template<class T_NodeType, class T_ConnectionType>
+	class GraphAdjacency final
+	{
+	public:
+		explicit GraphAdjacency(const IGraph<T_NodeType, T_ConnectionType>* pGraph) : m_pGraph{ pGraph } {}
+
+		int GetNrOfNodes() const { return m_pGraph->GetNrOfNodes(); }
+		bool HasConnections(int idx) const { return !m_pGraph->GetNodeConnections(idx).empty(); }
+
+		// calls function(to, cost) for every connection of the node, stops as soon as function returns false
+		// returns false when it was stopped
+		template<class T_Function>
+		bool ForEachConnection(int idx, T_Function function) const
+		{
+			for (const T_ConnectionType* pConnection : m_pGraph->GetNodeConnections(idx))
+			{
+				if (!function(pConnection->GetTo(), pConnection->GetCost()))
+					return false;
+			}
+			return true;
+		}
+
+		bool TryGetConnectionCost(int from, int to, float& cost) const
+		{
+			const T_ConnectionType* pConnection{ m_pGraph->GetConnection(from, to) };
+			if (pConnection == nullptr)
+				return false;
+			cost = pConnection->GetCost();
+			return true;
+		}
+
+	private:
+		const IGraph<T_NodeType, T_ConnectionType>* m_pGraph;
+	};
+
+	// a rectangle of cells of a grid, numbered inside the rectangle row by row, connections that leave it are skipped
+	// a search that has to stay inside one cluster of the grid only needs buffers the size of the cluster this way
+	template<class T_Adjacency>
+	class ClusterAdjacency final
+	{
+	public:
+		ClusterAdjacency(const T_Adjacency& adjacency, int nrOfGridColumns, int left, int top, int nrOfColumns, int nrOfRows)
+			: m_Adjacency{ adjacency }
+			, m_NrOfGridColumns{ nrOfGridColumns }
+			, m_Left{ left }
+			, m_Top{ top }
+			, m_NrOfColumns{ nrOfColumns }
+			, m_NrOfRows{ nrOfRows }
+		{
+			assert(nrOfGridColumns > 2 && "<ClusterAdjacency::ClusterAdjacency>: the neighbors of a cell can't be told apart in a grid this narrow");
+		}
+
+		int GetNrOfNodes() const { return m_NrOfColumns * m_NrOfRows; }
+
+		bool Contains(int gridIdx) const
+		{
+			const int col{ gridIdx % m_NrOfGridColumns - m_Left };
+			const int row{ gridIdx / m_NrOfGridColumns - m_Top };
+			return col >= 0 && col < m_NrOfColumns && row >= 0 && row < m_NrOfRows;
+		}
+		int ToLocalIndex(int gridIdx) const { return (gridIdx / m_NrOfGridColumns - m_Top) * m_NrOfColumns + gridIdx % m_NrOfGridColumns - m_Left; }
+		int ToGridIndex(int localIdx) const { return (m_Top + localIdx / m_NrOfColumns) * m_NrOfGridColumns + m_Left + localIdx % m_NrOfColumns; }
+
+		// calls function(to, cost) for every connection of the cell that stays inside the rectangle, with local indices
+		// returns false when it was stopped
+		template<class T_Function>
+		bool ForEachConnection(int localIdx, T_Function function) const
+		{
+			const int col{ localIdx % m_NrOfColumns };
+			const int row{ localIdx / m_NrOfColumns };
+			const int gridIdx{ (m_Top + row) * m_NrOfGridColumns + m_Left + col };
+			return m_Adjacency.ForEachConnection(gridIdx, [&](int toIdx, float cost)
+			{
+				//a grid only connects a cell to its 8 neighbors, so the difference in index tells the row and column without dividing
+				const int delta{ toIdx - gridIdx };
+				const int deltaRow{ delta < -1 ? -1 : delta > 1 ? 1 : 0 };
+				const int deltaCol{ delta - deltaRow * m_NrOfGridColumns };
+				if (col + deltaCol < 0 || col + deltaCol >= m_NrOfColumns || row + deltaRow < 0 || row + deltaRow >= m_NrOfRows)
+					return true;
+				return function(localIdx + deltaRow * m_NrOfColumns + deltaCol, cost);
+			});
+		}
+
+	private:
+		const T_Adjacency& m_Adjacency;
+		int m_NrOfGridColumns;
+		int m_Left;
+		int m_Top;
+		int m_NrOfColumns;
+		int m_NrOfRows;
+	};
+}
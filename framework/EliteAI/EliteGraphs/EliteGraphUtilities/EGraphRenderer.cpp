@@ -28,6 +28,72 @@ namespace Elite
 
 	
 
+	void EGraphRenderer::RenderGraph(const ImplicitGridGraph* pGraph, bool renderNodes, bool renderNodeNumbers, bool renderConnections, bool renderConnectionsCosts) const
+	{
+		const float cellSize{ float(pGraph->GetCellSize()) };
+		if (renderNodes)
+		{
+			//Nodes/Grid
+			for (int idx = 0; idx < pGraph->GetNrOfNodes(); ++idx)
+			{
+				Vector2 cellPos{ pGraph->GetNodeWorldPos(idx) };
+				Vector2 verts[4]
+				{
+					Vector2(cellPos.x - cellSize / 2.0f, cellPos.y - cellSize / 2.0f),
+					Vector2(cellPos.x - cellSize / 2.0f, cellPos.y + cellSize / 2.0f),
+					Vector2(cellPos.x + cellSize / 2.0f, cellPos.y + cellSize / 2.0f),
+					Vector2(cellPos.x + cellSize / 2.0f, cellPos.y - cellSize / 2.0f)
+				};
+
+				//Grid
+				DEBUGRENDERER2D->DrawPolygon(&verts[0], 4, DEFAULT_NODE_COLOR, 0.0f);
+
+				//Node
+				std::string text{};
+				if (renderNodeNumbers)
+				{
+					text = to_string(idx);
+				}
+				RenderRectNode(cellPos, text, cellSize, pGraph->GetNodeColor(idx), 0.1f);
+			}
+		}
+
+		if (renderConnections)
+		{
+			for (int idx = 0; idx < pGraph->GetNrOfNodes(); ++idx)
+			{
+				//Connections, worked out from the terrain of the neighbors
+				pGraph->ForEachConnection(idx, [&](int toIdx, float cost)
+				{
+					std::string text{ };
+					if (renderConnectionsCosts)
+					{
+						std::stringstream ss;
+						ss << std::fixed << std::setprecision(1) << cost;
+						text = ss.str();
+					}
+					RenderConnection(nullptr, pGraph->GetNodeWorldPos(toIdx), pGraph->GetNodeWorldPos(idx), text);
+					return true;
+				});
+			}
+		}
+	}
+
+	void EGraphRenderer::RenderHighlightedGrid(const ImplicitGridGraph* pGraph, const std::vector<int>& path, Color col /*= HIGHLIGHTED_NODE_COLOR*/) const
+	{
+		for (int idx : path)
+		{
+			//Node
+			RenderCircleNode(
+				pGraph->GetNodeWorldPos(idx),
+				"",
+				3.1f,
+				col,
+				-0.2f
+			);
+		}
+	}
+
 	void EGraphRenderer::RenderConnection(GraphConnection* con, Elite::Vector2 toPos, Elite::Vector2 fromPos, std::string text, Elite::Color col, float depth/*= 0.0f*/) const
 	{
 		auto center = toPos + (fromPos - toPos) / 2;
@@ -5,6 +5,7 @@
 #include "framework\EliteAI\EliteGraphs\EGraphConnectionTypes.h"
 #include "framework\EliteAI\EliteGraphs\EGridGraph.h"
 #include "framework\EliteAI\EliteGraphs\EGraph2D.h"
+#include "framework\EliteAI\EliteGraphs\EImplicitGridGraph.h"
 
 namespace Elite 
 {
@@ -20,6 +21,10 @@ namespace Elite
 		template<class T_NodeType, class T_ConnectionType>
 		void RenderGraph(GridGraph<T_NodeType, T_ConnectionType>* pGraph, bool renderNodes, bool renderNodeNumbers, bool renderConnections, bool renderConnectionsCosts) const;
 
+		// an implicit grid has no node or connection objects, so it gets drawn from its terrain and node indices
+		void RenderGraph(const ImplicitGridGraph* pGraph, bool renderNodes, bool renderNodeNumbers, bool renderConnections, bool renderConnectionsCosts) const;
+		void RenderHighlightedGrid(const ImplicitGridGraph* pGraph, const std::vector<int>& path, Color col = HIGHLIGHTED_NODE_COLOR) const;
+
 		template<class T_NodeType>
 		void RenderHighlighted(std::vector<T_NodeType*> path, Color col = HIGHLIGHTED_NODE_COLOR) const;
 
@@ -0,0 +1,25 @@
+#pragma once
+
+namespace Elite
+{
+	// the 8 directions from a cell to its neighbors, clockwise starting east, straight directions have an even number
+	// 0: east, 1: south east, 2: south, 3: south west, 4: west, 5: north west, 6: north, 7: north east (rows grow southwards)
+	class GridDirections final
+	{
+	public:
+		enum { nr_of_directions = 8, invalid_direction = -1 };
+
+		static int GetDeltaCol(int direction) { static const int deltaCols[nr_of_directions]{ 1, 1, 0, -1, -1, -1, 0, 1 }; return deltaCols[direction]; }
+		static int GetDeltaRow(int direction) { static const int deltaRows[nr_of_directions]{ 0, 1, 1, 1, 0, -1, -1, -1 }; return deltaRows[direction]; }
+		static bool IsDiagonal(int direction) { return (direction & 1) != 0; }
+		// turns a direction clockwise over nrOfSteps eighths of a circle (negative turns counterclockwise)
+		static int Rotate(int direction, int nrOfSteps) { return (direction + nrOfSteps) & (nr_of_directions - 1); }
+
+		// deltaCol and deltaRow have to be -1, 0 or 1, returns invalid_direction when both are 0
+		static int GetDirection(int deltaCol, int deltaRow)
+		{
+			static const int directions[9]{ 5, 6, 7, 4, invalid_direction, 0, 3, 2, 1 };
+			return directions[(deltaRow + 1) * 3 + deltaCol + 1];
+		}
+	};
+}
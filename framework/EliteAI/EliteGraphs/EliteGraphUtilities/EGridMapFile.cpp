@@ -0,0 +1,157 @@
+#include "stdafx.h"
+#include "EGridMapFile.h"
+
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace Elite
+{
+	namespace
+	{
+		const char grid_map_magic[4]{ 'E', 'G', 'M', 'P' };
+	}
+
+	bool GridMapFile::Open(const std::string& path)
+	{
+		Close();
+
+		//map the file copy on write, pages only get read from disk when they are touched
+#ifdef _WIN32
+		HANDLE fileHandle{ CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr) };
+		if (fileHandle == INVALID_HANDLE_VALUE)
+			return false;
+
+		LARGE_INTEGER fileSize{};
+		HANDLE mappingHandle{ nullptr };
+		void* pView{ nullptr };
+		if (GetFileSizeEx(fileHandle, &fileSize) && fileSize.QuadPart >= LONGLONG(sizeof(Header)))
+			mappingHandle = CreateFileMappingA(fileHandle, nullptr, PAGE_WRITECOPY, 0, 0, nullptr);
+		if (mappingHandle)
+			pView = MapViewOfFile(mappingHandle, FILE_MAP_COPY, 0, 0, 0);
+		if (!pView)
+		{
+			if (mappingHandle)
+				CloseHandle(mappingHandle);
+			CloseHandle(fileHandle);
+			return false;
+		}
+
+		m_FileHandle = fileHandle;
+		m_MappingHandle = mappingHandle;
+		m_Size = size_t(fileSize.QuadPart);
+#else
+		const int fileDescriptor{ open(path.c_str(), O_RDONLY) };
+		if (fileDescriptor < 0)
+			return false;
+
+		struct stat fileStatus {};
+		void* pView{ MAP_FAILED };
+		if (fstat(fileDescriptor, &fileStatus) == 0 && size_t(fileStatus.st_size) >= sizeof(Header))
+			pView = mmap(nullptr, size_t(fileStatus.st_size), PROT_READ | PROT_WRITE, MAP_PRIVATE, fileDescriptor, 0);
+		//the mapping keeps the file alive by itself
+		close(fileDescriptor);
+		if (pView == MAP_FAILED)
+			return false;
+
+		m_Size = size_t(fileStatus.st_size);
+#endif
+		m_pData = static_cast<unsigned char*>(pView);
+		m_pHeader = reinterpret_cast<const Header*>(m_pData);
+
+		if (!IsValid(m_Size))
+		{
+			Close();
+			return false;
+		}
+		return true;
+	}
+
+	void GridMapFile::Close()
+	{
+		if (!m_pData)
+			return;
+
+#ifdef _WIN32
+		UnmapViewOfFile(m_pData);
+		CloseHandle(m_MappingHandle);
+		CloseHandle(m_FileHandle);
+		m_MappingHandle = nullptr;
+		m_FileHandle = nullptr;
+#else
+		munmap(m_pData, m_Size);
+#endif
+		m_pData = nullptr;
+		m_pHeader = nullptr;
+		m_Size = 0;
+	}
+
+	ImplicitGridGraph GridMapFile::CreateImplicitGridGraph() const
+	{
+		assert(IsOpen() && "<GridMapFile::CreateImplicitGridGraph>: no file is open");
+		return ImplicitGridGraph{ GetTerrain(), GetColumns(), GetRows(), GetCellSize(), IsConnectedDiagonally(), GetDefaultCostStraight(), GetDefaultCostDiagonal(),
+			IsCornerCuttingAllowed() };
+	}
+
+	bool GridMapFile::Write(const std::string& path, const ImplicitGridGraph& graph)
+	{
+		const Header header{ MakeHeader(graph.GetColumns(), graph.GetRows(), graph.GetCellSize(), graph.IsConnectedDiagonally(), graph.IsCornerCuttingAllowed(),
+			graph.GetDefaultCostStraight(), graph.GetDefaultCostDiagonal()) };
+		return WriteFile(path, header, graph.GetTerrainData());
+	}
+
+	GridMapFile::Header GridMapFile::MakeHeader(int columns, int rows, int cellSize, bool isConnectedDiagonally, bool isCornerCuttingAllowed, float costStraight, float costDiagonal)
+	{
+		Header header{};
+		std::copy(std::begin(grid_map_magic), std::end(grid_map_magic), header.magic);
+		header.version = version;
+		header.headerSize = sizeof(Header);
+		header.columns = columns;
+		header.rows = rows;
+		header.cellSize = cellSize;
+		header.flags = (isConnectedDiagonally ? connected_diagonally_flag : 0) | (isCornerCuttingAllowed ? 0 : no_corner_cutting_flag);
+		header.costStraight = costStraight;
+		header.costDiagonal = costDiagonal;
+		header.terrainOffset = (sizeof(Header) + terrain_alignment - 1) / terrain_alignment * terrain_alignment;
+		header.terrainSize = uint64_t(columns) * rows;
+		return header;
+	}
+
+	bool GridMapFile::WriteFile(const std::string& path, const Header& header, const unsigned char* pTerrain)
+	{
+		std::ofstream file{ path, std::ios::out | std::ios::binary | std::ios::trunc };
+		if (!file)
+			return false;
+
+		const char padding[terrain_alignment]{};
+		file.write(reinterpret_cast<const char*>(&header), sizeof(Header));
+		file.write(padding, header.terrainOffset - sizeof(Header));
+		file.write(reinterpret_cast<const char*>(pTerrain), std::streamsize(header.terrainSize));
+		return bool(file);
+	}
+
+	bool GridMapFile::IsValid(size_t fileSize) const
+	{
+		//fields added at the end only make the header bigger, a higher version is a layout this code can't read
+		const Header& header{ *m_pHeader };
+		if (!std::equal(std::begin(grid_map_magic), std::end(grid_map_magic), header.magic) || header.version == 0 || header.version > version
+			|| header.headerSize < sizeof(Header))
+			return false;
+
+		if (header.columns <= 0 || header.rows <= 0 || header.terrainSize != uint64_t(header.columns) * uint64_t(header.rows))
+			return false;
+
+		return header.terrainOffset >= header.headerSize && uint64_t(header.terrainOffset) + header.terrainSize <= fileSize;
+	}
+}
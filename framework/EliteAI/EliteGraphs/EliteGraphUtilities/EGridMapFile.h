@@ -0,0 +1,123 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+#include "framework/EliteAI/EliteGraphs/EGridGraph.h"
+#include "framework/EliteAI/EliteGraphs/EImplicitGridGraph.h"
+
+namespace Elite
+{
+	// binary grid map: a header followed by the terrain of every cell, one byte per cell in the format of ImplicitGridGraph
+	// (0 is blocked, otherwise the TerrainType value) and in node index order
+	// an opened file is mapped into memory and an ImplicitGridGraph searches the mapped terrain directly, nothing gets read or copied up front
+	// the mapping is copy on write, editing the terrain only copies the touched pages and never changes the file
+	// values are stored little endian, the terrain starts at a multiple of terrain_alignment bytes
+	class GridMapFile final
+	{
+	public:
+		enum { version = 1, terrain_alignment = 64 };
+
+		GridMapFile() = default;
+		~GridMapFile() { Close(); }
+
+		GridMapFile(const GridMapFile&) = delete;
+		GridMapFile& operator=(const GridMapFile&) = delete;
+
+		// returns false when the file can't be mapped or isn't a grid map of a version this code can read
+		bool Open(const std::string& path);
+		void Close();
+		bool IsOpen() const { return m_pData != nullptr; }
+
+		int GetColumns() const { return m_pHeader->columns; }
+		int GetRows() const { return m_pHeader->rows; }
+		int GetCellSize() const { return m_pHeader->cellSize; }
+		bool IsConnectedDiagonally() const { return (m_pHeader->flags & connected_diagonally_flag) != 0; }
+		// files from before the flag existed never forbid it
+		bool IsCornerCuttingAllowed() const { return (m_pHeader->flags & no_corner_cutting_flag) == 0; }
+		float GetDefaultCostStraight() const { return m_pHeader->costStraight; }
+		float GetDefaultCostDiagonal() const { return m_pHeader->costDiagonal; }
+		unsigned char* GetTerrain() const { return m_pData + m_pHeader->terrainOffset; }
+
+		// searches the mapped terrain, the file has to stay open as long as the graph is used
+		ImplicitGridGraph CreateImplicitGridGraph() const;
+		// builds a GridGraph and gives it the terrain of the file in one batch edit
+		template<class T_NodeType, class T_ConnectionType>
+		GridGraph<T_NodeType, T_ConnectionType>* CreateGridGraph(bool isDirectionalGraph) const;
+
+		static bool Write(const std::string& path, const ImplicitGridGraph& graph);
+		template<class T_NodeType, class T_ConnectionType>
+		static bool Write(const std::string& path, const GridGraph<T_NodeType, T_ConnectionType>* pGraph);
+
+	private:
+		enum { connected_diagonally_flag = 1, no_corner_cutting_flag = 2 };
+
+		// the layout on disk, only add fields at the end and raise the version when the meaning of one changes
+		struct Header
+		{
+			char magic[4];
+			uint32_t version;
+			uint32_t headerSize;
+			int32_t columns;
+			int32_t rows;
+			int32_t cellSize;
+			uint32_t flags;
+			float costStraight;
+			float costDiagonal;
+			uint32_t terrainOffset;
+			uint64_t terrainSize;
+		};
+
+		static Header MakeHeader(int columns, int rows, int cellSize, bool isConnectedDiagonally, bool isCornerCuttingAllowed, float costStraight, float costDiagonal);
+		static bool WriteFile(const std::string& path, const Header& header, const unsigned char* pTerrain);
+		bool IsValid(size_t fileSize) const;
+
+		unsigned char* m_pData = nullptr;
+		const Header* m_pHeader = nullptr;
+		size_t m_Size = 0;
+#ifdef _WIN32
+		void* m_FileHandle = nullptr;
+		void* m_MappingHandle = nullptr;
+#endif
+	};
+
+	/// <summary>
+	/// Create a GridGraph with the size and costs stored in the file and copy the terrain into it
+	/// </summary>
+	/// <param name="isDirectionalGraph">The file doesn't store this, a grid map is the same either way</param>
+	/// <returns>a new graph the caller owns</returns>
+	template<class T_NodeType, class T_ConnectionType>
+	inline GridGraph<T_NodeType, T_ConnectionType>* GridMapFile::CreateGridGraph(bool isDirectionalGraph) const
+	{
+		assert(IsOpen() && "<GridMapFile::CreateGridGraph>: no file is open");
+
+		auto pGraph = new GridGraph<T_NodeType, T_ConnectionType>(GetColumns(), GetRows(), GetCellSize(), isDirectionalGraph, IsConnectedDiagonally(),
+			GetDefaultCostStraight(), GetDefaultCostDiagonal(), IsCornerCuttingAllowed());
+
+		const int nrOfCells{ GetColumns() * GetRows() };
+		const unsigned char* pTerrain{ GetTerrain() };
+		std::vector<TerrainType> terrainTypes(nrOfCells);
+		for (int idx = 0; idx < nrOfCells; ++idx)
+			terrainTypes[idx] = ImplicitGridGraph::ToTerrainType(pTerrain[idx]);
+
+		pGraph->SetTerrainTypes(terrainTypes);
+		return pGraph;
+	}
+
+	/// <summary>
+	/// Save the size, costs and terrain of a GridGraph
+	/// </summary>
+	/// <returns>false when the file couldn't be written</returns>
+	template<class T_NodeType, class T_ConnectionType>
+	inline bool GridMapFile::Write(const std::string& path, const GridGraph<T_NodeType, T_ConnectionType>* pGraph)
+	{
+		const int nrOfCells{ pGraph->GetColumns() * pGraph->GetRows() };
+		std::vector<unsigned char> terrain(nrOfCells);
+		for (int idx = 0; idx < nrOfCells; ++idx)
+			terrain[idx] = ImplicitGridGraph::ToTerrainByte(pGraph->GetNode(idx)->GetTerrainType());
+
+		const Header header{ MakeHeader(pGraph->GetColumns(), pGraph->GetRows(), pGraph->GetCellSize(), pGraph->IsConnectedDiagonally(), pGraph->IsCornerCuttingAllowed(),
+			pGraph->GetDefaultCostStraight(), pGraph->GetDefaultCostDiagonal()) };
+		return WriteFile(path, header, terrain.data());
+	}
+}
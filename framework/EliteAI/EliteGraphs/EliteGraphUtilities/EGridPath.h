@@ -0,0 +1,44 @@
+#pragma once
+
+namespace Elite
+{
+	/// <summary>
+	/// Fill in the cells between the jump points of a path, consecutive jump points always lie on a straight or diagonal line
+	/// </summary>
+	/// <param name="path">node indices of the jump points on the path, gets replaced by the indices of every cell on the path</param>
+	/// <param name="nrOfColumns">amount of columns of the grid (GridGraph::GetColumns)</param>
+	inline void ExpandGridPath(std::vector<int>& path, int nrOfColumns)
+	{
+		if (path.size() < 2)
+			return;
+
+		auto getSteps = [nrOfColumns](int fromIdx, int toIdx)
+		{
+			int stepsX{ abs(toIdx % nrOfColumns - fromIdx % nrOfColumns) };
+			int stepsY{ abs(toIdx / nrOfColumns - fromIdx / nrOfColumns) };
+			return stepsX > stepsY ? stepsX : stepsY;
+		};
+
+		//count the cells first, so the jump points can be spread out from the back without a second buffer
+		const int nrOfJumpPoints{ int(path.size()) };
+		int nrOfCells{ 1 };
+		for (int i = 1; i < nrOfJumpPoints; ++i)
+			nrOfCells += getSteps(path[i - 1], path[i]);
+		path.resize(nrOfCells);
+
+		int cellIdx{ nrOfCells - 1 };
+		for (int i = nrOfJumpPoints - 1; i > 0; --i)
+		{
+			const int toIdx{ path[i] };
+			const int fromIdx{ path[i - 1] };
+			const int steps{ getSteps(fromIdx, toIdx) };
+			const int deltaX{ (toIdx % nrOfColumns > fromIdx % nrOfColumns) - (toIdx % nrOfColumns < fromIdx % nrOfColumns) };
+			const int deltaY{ (toIdx / nrOfColumns > fromIdx / nrOfColumns) - (toIdx / nrOfColumns < fromIdx / nrOfColumns) };
+			const int indexDelta{ deltaY * nrOfColumns + deltaX };
+
+			//the cells of this segment land at positions >= i, so the jump points that still have to be read stay intact
+			for (int step = 0; step < steps; ++step)
+				path[cellIdx--] = toIdx - step * indexDelta;
+		}
+	}
+}
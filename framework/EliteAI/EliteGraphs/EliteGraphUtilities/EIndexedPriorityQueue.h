@@ -0,0 +1,201 @@
+#pragma once
+
+namespace Elite
+{
+	// d-ary min-heap of node indices ordered on a key (f-cost for the pathfinders)
+	// every index remembers its slot in the heap, so an open node whose cost drops can be moved up in place (decrease-key)
+	// instead of searching the open list for it or pushing a duplicate
+	template <class T_KeyType = float, int T_Arity = 4>
+	class IndexedPriorityQueue
+	{
+	public:
+		IndexedPriorityQueue() = default;
+		explicit IndexedPriorityQueue(int nrOfIndices) { Resize(nrOfIndices); }
+
+		void Resize(int nrOfIndices);
+		void Clear();
+
+		bool IsEmpty() const { return m_Heap.empty(); }
+		int Size() const { return int(m_Heap.size()); }
+		int GetNrOfIndices() const { return int(m_Positions.size()); }
+		size_t GetMemorySize() const { return m_Heap.capacity() * sizeof(HeapEntry) + m_Positions.capacity() * sizeof(int); }
+		bool Contains(int idx) const { return m_Positions[idx] != invalid_position; }
+		T_KeyType GetKey(int idx) const { return m_Heap[m_Positions[idx]].key; }
+
+		int Top() const { return m_Heap.front().idx; }
+		int Pop();
+		void Push(int idx, T_KeyType key);
+		void DecreaseKey(int idx, T_KeyType key);
+
+		// operations since the last Clear, for the search statistics
+		int GetNrOfPushes() const { return m_NrOfPushes; }
+		int GetNrOfPops() const { return m_NrOfPops; }
+		int GetNrOfDecreaseKeys() const { return m_NrOfDecreaseKeys; }
+		int GetPeakSize() const { return m_PeakSize; }
+
+	private:
+		static_assert(T_Arity >= 2, "<IndexedPriorityQueue>: a heap needs at least 2 children per node");
+
+		enum { invalid_position = -1 };
+
+		struct HeapEntry
+		{
+			T_KeyType key;
+			int idx;
+		};
+
+		void SiftUp(int position);
+		void SiftDown(int position);
+		void Place(const HeapEntry& entry, int position);
+
+		std::vector<HeapEntry> m_Heap;
+		std::vector<int> m_Positions; // slot in m_Heap of every index, invalid_position when it is not queued
+
+		int m_NrOfPushes = 0;
+		int m_NrOfPops = 0;
+		int m_NrOfDecreaseKeys = 0;
+		int m_PeakSize = 0;
+	};
+
+	/// <summary>
+	/// Make room for indices [0, nrOfIndices), this empties the queue
+	/// </summary>
+	/// <param name="nrOfIndices">The amount of indices (nodes in the graph) that can be queued</param>
+	template<class T_KeyType, int T_Arity>
+	inline void IndexedPriorityQueue<T_KeyType, T_Arity>::Resize(int nrOfIndices)
+	{
+		Clear();
+		m_Positions.resize(nrOfIndices, invalid_position);
+		m_Heap.reserve(nrOfIndices);
+	}
+
+	/// <summary>
+	/// Empty the queue, only touches the indices that are still queued so it is cheap after a search
+	/// </summary>
+	template<class T_KeyType, int T_Arity>
+	inline void IndexedPriorityQueue<T_KeyType, T_Arity>::Clear()
+	{
+		for (const HeapEntry& entry : m_Heap)
+			m_Positions[entry.idx] = invalid_position;
+		m_Heap.clear();
+
+		m_NrOfPushes = 0;
+		m_NrOfPops = 0;
+		m_NrOfDecreaseKeys = 0;
+		m_PeakSize = 0;
+	}
+
+	/// <summary>
+	/// Remove the index with the lowest key from the queue
+	/// </summary>
+	/// <returns>the index that had the lowest key</returns>
+	template<class T_KeyType, int T_Arity>
+	inline int IndexedPriorityQueue<T_KeyType, T_Arity>::Pop()
+	{
+		assert(!m_Heap.empty() && "<IndexedPriorityQueue::Pop>: queue is empty");
+
+		int topIdx = m_Heap.front().idx;
+		m_Positions[topIdx] = invalid_position;
+		++m_NrOfPops;
+
+		HeapEntry last = m_Heap.back();
+		m_Heap.pop_back();
+		if (!m_Heap.empty())
+		{
+			Place(last, 0);
+			SiftDown(0);
+		}
+		return topIdx;
+	}
+
+	/// <summary>
+	/// Add an index that is not queued yet
+	/// </summary>
+	/// <param name="idx">The node index to queue</param>
+	/// <param name="key">The key to order on</param>
+	template<class T_KeyType, int T_Arity>
+	inline void IndexedPriorityQueue<T_KeyType, T_Arity>::Push(int idx, T_KeyType key)
+	{
+		assert(idx >= 0 && idx < int(m_Positions.size()) && "<IndexedPriorityQueue::Push>: invalid index");
+		assert(!Contains(idx) && "<IndexedPriorityQueue::Push>: index is already queued");
+
+		m_Heap.push_back(HeapEntry{ key, idx });
+		m_Positions[idx] = int(m_Heap.size()) - 1;
+		SiftUp(int(m_Heap.size()) - 1);
+
+		++m_NrOfPushes;
+		if (int(m_Heap.size()) > m_PeakSize)
+			m_PeakSize = int(m_Heap.size());
+	}
+
+	/// <summary>
+	/// Lower the key of an index that is already queued
+	/// </summary>
+	/// <param name="idx">The queued node index</param>
+	/// <param name="key">The new key, can not be higher than the current one</param>
+	template<class T_KeyType, int T_Arity>
+	inline void IndexedPriorityQueue<T_KeyType, T_Arity>::DecreaseKey(int idx, T_KeyType key)
+	{
+		assert(Contains(idx) && "<IndexedPriorityQueue::DecreaseKey>: index is not queued");
+		assert(!(GetKey(idx) < key) && "<IndexedPriorityQueue::DecreaseKey>: new key is higher than the current one");
+
+		int position = m_Positions[idx];
+		m_Heap[position].key = key;
+		SiftUp(position);
+		++m_NrOfDecreaseKeys;
+	}
+
+	template<class T_KeyType, int T_Arity>
+	inline void IndexedPriorityQueue<T_KeyType, T_Arity>::SiftUp(int position)
+	{
+		HeapEntry entry = m_Heap[position];
+		while (position > 0)
+		{
+			int parent = (position - 1) / T_Arity;
+			if (!(entry.key < m_Heap[parent].key))
+				break;
+
+			Place(m_Heap[parent], position);
+			position = parent;
+		}
+		Place(entry, position);
+	}
+
+	template<class T_KeyType, int T_Arity>
+	inline void IndexedPriorityQueue<T_KeyType, T_Arity>::SiftDown(int position)
+	{
+		const int size = int(m_Heap.size());
+		HeapEntry entry = m_Heap[position];
+		while (true)
+		{
+			int firstChild = position * T_Arity + 1;
+			if (firstChild >= size)
+				break;
+
+			//find the cheapest child
+			int lastChild = firstChild + T_Arity;
+			if (lastChild > size)
+				lastChild = size;
+			int cheapestChild = firstChild;
+			for (int child = firstChild + 1; child < lastChild; ++child)
+			{
+				if (m_Heap[child].key < m_Heap[cheapestChild].key)
+					cheapestChild = child;
+			}
+
+			if (!(m_Heap[cheapestChild].key < entry.key))
+				break;
+
+			Place(m_Heap[cheapestChild], position);
+			position = cheapestChild;
+		}
+		Place(entry, position);
+	}
+
+	template<class T_KeyType, int T_Arity>
+	inline void IndexedPriorityQueue<T_KeyType, T_Arity>::Place(const HeapEntry& entry, int position)
+	{
+		m_Heap[position] = entry;
+		m_Positions[entry.idx] = position;
+	}
+}
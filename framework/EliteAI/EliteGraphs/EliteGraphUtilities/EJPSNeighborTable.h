@@ -0,0 +1,76 @@
+#pragma once
+
+#include "framework/EliteAI/EliteGraphs/EliteGraphUtilities/EGridDirections.h"
+
+namespace Elite
+{
+	// JPS pruning as a lookup: which directions are worth jumping in after arriving in a cell, given the direction we arrived in
+	// and which of the 8 neighbors of the cell are blocked (bit i is direction i of GridDirections)
+	// the natural directions continue the movement, the forced ones go around a blocked neighbor
+	// without corner cutting a diagonal only gets past a blocked cell after a straight step, so the forced directions differ
+	class JPSNeighborTable final
+	{
+	public:
+		static unsigned char GetDirectionsToExplore(int direction, unsigned char blockedNeighbors, bool isCornerCuttingAllowed = true)
+		{
+			return GetTable().m_Directions[isCornerCuttingAllowed][direction][blockedNeighbors];
+		}
+
+	private:
+		JPSNeighborTable();
+		static const JPSNeighborTable& GetTable() { static const JPSNeighborTable table{}; return table; }
+
+		enum { nr_of_masks = 256 };
+		// indexed by whether corners can be cut first
+		unsigned char m_Directions[2][GridDirections::nr_of_directions][nr_of_masks];
+	};
+
+	inline JPSNeighborTable::JPSNeighborTable()
+	{
+		for (int direction = 0; direction < GridDirections::nr_of_directions; ++direction)
+		{
+			for (int blockedNeighbors = 0; blockedNeighbors < nr_of_masks; ++blockedNeighbors)
+			{
+				auto isBlocked = [blockedNeighbors, direction](int nrOfSteps) { return (blockedNeighbors & (1 << GridDirections::Rotate(direction, nrOfSteps))) != 0; };
+				auto toBit = [direction](int nrOfSteps) { return 1 << GridDirections::Rotate(direction, nrOfSteps); };
+
+				int directions{ toBit(0) };
+				if (GridDirections::IsDiagonal(direction))
+				{
+					//diagonal: both straight components are natural as well
+					//a blocked cell behind on one side forces the diagonal past it on that side
+					directions |= toBit(-1) | toBit(1);
+					if (isBlocked(3) && !isBlocked(2))
+						directions |= toBit(2);
+					if (isBlocked(-3) && !isBlocked(-2))
+						directions |= toBit(-2);
+				}
+				else
+				{
+					//straight: a blocked cell to the side forces the diagonal past it
+					if (isBlocked(2) && !isBlocked(1))
+						directions |= toBit(1);
+					if (isBlocked(-2) && !isBlocked(-1))
+						directions |= toBit(-1);
+				}
+				m_Directions[true][direction][blockedNeighbors] = static_cast<unsigned char>(directions & ~blockedNeighbors);
+
+				//without corner cutting a diagonal has no forced directions, only its straight components
+				//a straight line passing a blocked cell behind on one side forces the side and the diagonal towards it
+				directions = toBit(0);
+				if (GridDirections::IsDiagonal(direction))
+				{
+					directions |= toBit(-1) | toBit(1);
+				}
+				else
+				{
+					if (isBlocked(3) && !isBlocked(2))
+						directions |= toBit(2) | toBit(1);
+					if (isBlocked(-3) && !isBlocked(-2))
+						directions |= toBit(-2) | toBit(-1);
+				}
+				m_Directions[false][direction][blockedNeighbors] = static_cast<unsigned char>(directions & ~blockedNeighbors);
+			}
+		}
+	}
+}
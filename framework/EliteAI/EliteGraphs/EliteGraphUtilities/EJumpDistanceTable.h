@@ -0,0 +1,205 @@
+#pragma once
+
+#include <climits>
+
+#include "framework/EliteAI/EliteGraphs/EliteGraphUtilities/EWalkabilityGrid.h"
+#include "framework/EliteAI/EliteGraphs/EliteGraphUtilities/EGridDirections.h"
+
+namespace Elite
+{
+	// JPS+ lookup table: for every cell and every one of the 8 directions, how far a jump in that direction goes
+	// a positive distance ends on a jump point, 0 or a negative distance -n means the jump hits a wall after n steps
+	// jump points follow the same rules as BlockJPS, the destination is not in the table and gets checked while searching
+	class JumpDistanceTable final
+	{
+	public:
+		// the directions are the ones of GridDirections
+		enum { nr_of_directions = GridDirections::nr_of_directions };
+
+		JumpDistanceTable() = default;
+		~JumpDistanceTable() = default;
+
+		void Build(const WalkabilityGrid& grid);
+		void Repair(const WalkabilityGrid& grid, const std::vector<int>& changedCells);
+
+		int GetDistance(int idx, int direction) const { return m_Distances[size_t(idx) * nr_of_directions + direction]; }
+		size_t GetMemorySize() const { return m_Distances.capacity() * sizeof(short) + m_RepairQueue.capacity() * sizeof(int); }
+
+	private:
+		short ComputeDistance(const WalkabilityGrid& grid, int col, int row, int direction) const;
+		bool IsJumpPoint(const WalkabilityGrid& grid, int col, int row, int direction) const;
+		void RepairDirection(const WalkabilityGrid& grid, int direction, std::vector<int>* pChangedCells);
+
+		short& Distance(int idx, int direction) { return m_Distances[size_t(idx) * nr_of_directions + direction]; }
+
+		std::vector<short> m_Distances;
+		int m_NrOfColumns = 0;
+		int m_NrOfRows = 0;
+
+		// cells whose distances have to be computed again during a repair, and the straight distances a repair changed
+		std::vector<int> m_RepairQueue;
+		std::vector<int> m_ChangedStraightCells[nr_of_directions];
+	};
+
+	/// <summary>
+	/// Compute the distances of every cell
+	/// </summary>
+	/// <param name="grid">The walkability of the cells</param>
+	inline void JumpDistanceTable::Build(const WalkabilityGrid& grid)
+	{
+		m_NrOfColumns = grid.GetColumns();
+		m_NrOfRows = grid.GetRows();
+		assert(m_NrOfColumns <= SHRT_MAX && m_NrOfRows <= SHRT_MAX && "<JumpDistanceTable::Build>: grid is too big to store its distances in shorts");
+		m_Distances.assign(size_t(m_NrOfColumns) * m_NrOfRows * nr_of_directions, short(0));
+
+		//a distance builds on the distance of the next cell in the same direction, so walk against the direction
+		//diagonal distances also need the straight distances of the next cell, so those go first
+		const int directionOrder[nr_of_directions]{ 0, 2, 4, 6, 1, 3, 5, 7 };
+		for (int direction : directionOrder)
+		{
+			const int deltaCol{ GridDirections::GetDeltaCol(direction) };
+			const int deltaRow{ GridDirections::GetDeltaRow(direction) };
+			const int firstRow{ deltaRow > 0 ? m_NrOfRows - 1 : 0 };
+			const int rowStep{ deltaRow > 0 ? -1 : 1 };
+			const int firstCol{ deltaCol > 0 ? m_NrOfColumns - 1 : 0 };
+			const int colStep{ deltaCol > 0 ? -1 : 1 };
+
+			for (int row = firstRow; row >= 0 && row < m_NrOfRows; row += rowStep)
+			{
+				for (int col = firstCol; col >= 0 && col < m_NrOfColumns; col += colStep)
+					Distance(row * m_NrOfColumns + col, direction) = ComputeDistance(grid, col, row, direction);
+			}
+		}
+	}
+
+	/// <summary>
+	/// Fix the distances after some cells became walkable or blocked, only the lines through those cells get recomputed
+	/// and a line is only followed for as long as its distances change
+	/// </summary>
+	/// <param name="grid">The walkability of the cells, already updated</param>
+	/// <param name="changedCells">The indices of the cells that became walkable or blocked</param>
+	inline void JumpDistanceTable::Repair(const WalkabilityGrid& grid, const std::vector<int>& changedCells)
+	{
+		if (changedCells.empty())
+			return;
+
+		//a distance depends on the next cell and on the cells beside it (forced neighbors), so every cell within 2 cells
+		//of a change has to be computed again, from there on changes run back along the line
+		const int directionOrder[nr_of_directions]{ 0, 2, 4, 6, 1, 3, 5, 7 };
+		for (int direction : directionOrder)
+		{
+			m_RepairQueue.clear();
+			for (int changedIdx : changedCells)
+			{
+				const int changedCol{ changedIdx % m_NrOfColumns };
+				const int changedRow{ changedIdx / m_NrOfColumns };
+				for (int row = changedRow - 2; row <= changedRow + 2; ++row)
+				{
+					for (int col = changedCol - 2; col <= changedCol + 2; ++col)
+					{
+						if (col >= 0 && col < m_NrOfColumns && row >= 0 && row < m_NrOfRows)
+							m_RepairQueue.push_back(row * m_NrOfColumns + col);
+					}
+				}
+			}
+
+			if (GridDirections::IsDiagonal(direction))
+			{
+				//the diagonal jump stops where a straight jump from the next cell finds something
+				const int deltaCol{ GridDirections::GetDeltaCol(direction) };
+				const int deltaRow{ GridDirections::GetDeltaRow(direction) };
+				const int straightDirections[2]{ GridDirections::GetDirection(deltaCol, 0), GridDirections::GetDirection(0, deltaRow) };
+				for (int straightDirection : straightDirections)
+				{
+					for (int changedIdx : m_ChangedStraightCells[straightDirection])
+					{
+						const int col{ changedIdx % m_NrOfColumns - deltaCol };
+						const int row{ changedIdx / m_NrOfColumns - deltaRow };
+						if (col >= 0 && col < m_NrOfColumns && row >= 0 && row < m_NrOfRows)
+							m_RepairQueue.push_back(row * m_NrOfColumns + col);
+					}
+				}
+				RepairDirection(grid, direction, nullptr);
+			}
+			else
+			{
+				m_ChangedStraightCells[direction].clear();
+				RepairDirection(grid, direction, &m_ChangedStraightCells[direction]);
+			}
+		}
+	}
+
+	/// <summary>
+	/// Compute the distances of the queued cells again, when a distance changes the cell before it on the line is next
+	/// </summary>
+	inline void JumpDistanceTable::RepairDirection(const WalkabilityGrid& grid, int direction, std::vector<int>* pChangedCells)
+	{
+		const int deltaCol{ GridDirections::GetDeltaCol(direction) };
+		const int deltaRow{ GridDirections::GetDeltaRow(direction) };
+		for (int queuedIdx : m_RepairQueue)
+		{
+			int col{ queuedIdx % m_NrOfColumns };
+			int row{ queuedIdx / m_NrOfColumns };
+			while (col >= 0 && col < m_NrOfColumns && row >= 0 && row < m_NrOfRows)
+			{
+				const int idx{ row * m_NrOfColumns + col };
+				const short distance{ ComputeDistance(grid, col, row, direction) };
+				if (distance == Distance(idx, direction))
+					break;
+
+				Distance(idx, direction) = distance;
+				if (pChangedCells)
+					pChangedCells->push_back(idx);
+				col -= deltaCol;
+				row -= deltaRow;
+			}
+		}
+	}
+
+	/// <summary>
+	/// Compute the distance of one cell out of the distance of the next cell in the same direction
+	/// </summary>
+	inline short JumpDistanceTable::ComputeDistance(const WalkabilityGrid& grid, int col, int row, int direction) const
+	{
+		const int nextCol{ col + GridDirections::GetDeltaCol(direction) };
+		const int nextRow{ row + GridDirections::GetDeltaRow(direction) };
+		if (!grid.IsWalkable(nextCol, nextRow))
+			return 0;
+
+		if (IsJumpPoint(grid, nextCol, nextRow, direction))
+			return 1;
+
+		const short nextDistance{ m_Distances[size_t(nextRow * m_NrOfColumns + nextCol) * nr_of_directions + direction] };
+		return nextDistance > 0 ? nextDistance + 1 : nextDistance - 1;
+	}
+
+	/// <summary>
+	/// Check whether a walkable cell is a jump point when it gets reached moving in the given direction
+	/// </summary>
+	inline bool JumpDistanceTable::IsJumpPoint(const WalkabilityGrid& grid, int col, int row, int direction) const
+	{
+		const int deltaCol{ GridDirections::GetDeltaCol(direction) };
+		const int deltaRow{ GridDirections::GetDeltaRow(direction) };
+
+		//straight: a blocked cell beside this one with a walkable cell after it
+		if (deltaRow == 0)
+		{
+			return (!grid.IsWalkable(col, row - 1) && grid.IsWalkable(col + deltaCol, row - 1)) ||
+				(!grid.IsWalkable(col, row + 1) && grid.IsWalkable(col + deltaCol, row + 1));
+		}
+		if (deltaCol == 0)
+		{
+			return (!grid.IsWalkable(col - 1, row) && grid.IsWalkable(col - 1, row + deltaRow)) ||
+				(!grid.IsWalkable(col + 1, row) && grid.IsWalkable(col + 1, row + deltaRow));
+		}
+
+		//diagonal: a blocked cell behind on one side with a walkable cell diagonally past it
+		//or a straight jump from here along one of the components finds a jump point
+		if ((!grid.IsWalkable(col - deltaCol, row) && grid.IsWalkable(col - deltaCol, row + deltaRow)) ||
+			(!grid.IsWalkable(col, row - deltaRow) && grid.IsWalkable(col + deltaCol, row - deltaRow)))
+			return true;
+
+		const int idx{ row * m_NrOfColumns + col };
+		return GetDistance(idx, GridDirections::GetDirection(deltaCol, 0)) > 0 || GetDistance(idx, GridDirections::GetDirection(0, deltaRow)) > 0;
+	}
+}
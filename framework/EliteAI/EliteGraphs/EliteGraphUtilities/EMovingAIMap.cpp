@@ -0,0 +1,88 @@
+#include "stdafx.h"
+#include "EMovingAIMap.h"
+
+namespace Elite
+{
+	bool MovingAIMap::Load(const std::string& path)
+	{
+		std::ifstream file{ path };
+		if (!file)
+			return false;
+
+		//header lines ("type octile", "height h", "width w") until the "map" line, the order of height and width isn't fixed
+		int nrOfColumns{ 0 };
+		int nrOfRows{ 0 };
+		std::string line;
+		bool isOctile{ false };
+		while (std::getline(file, line))
+		{
+			std::istringstream lineStream{ line };
+			std::string key;
+			lineStream >> key;
+			if (key == "type")
+			{
+				std::string type;
+				lineStream >> type;
+				isOctile = type == "octile";
+			}
+			else if (key == "height")
+				lineStream >> nrOfRows;
+			else if (key == "width")
+				lineStream >> nrOfColumns;
+			else if (key == "map")
+				break;
+		}
+		if (!isOctile || nrOfColumns <= 0 || nrOfRows <= 0)
+			return false;
+
+		std::vector<TerrainType> terrainTypes;
+		terrainTypes.reserve(size_t(nrOfColumns) * nrOfRows);
+		for (int row = 0; row < nrOfRows; ++row)
+		{
+			//line endings of the other platforms leave a '\r' behind, it's past the last column
+			if (!std::getline(file, line) || int(line.size()) < nrOfColumns)
+				return false;
+
+			for (int col = 0; col < nrOfColumns; ++col)
+			{
+				const char cell{ line[col] };
+				const bool isWalkable{ cell == '.' || cell == 'G' || cell == 'S' };
+				terrainTypes.push_back(isWalkable ? TerrainType::Ground : TerrainType::Water);
+			}
+		}
+
+		m_NrOfColumns = nrOfColumns;
+		m_NrOfRows = nrOfRows;
+		m_TerrainTypes = std::move(terrainTypes);
+		return true;
+	}
+
+	bool MovingAIMap::LoadScenarios(const std::string& path, std::vector<MovingAIScenario>& scenarios)
+	{
+		std::ifstream file{ path };
+		if (!file)
+			return false;
+
+		//"version 1" followed by one line per scenario: bucket, map, map width, map height, start x, start y, goal x, goal y, optimal length
+		std::string line;
+		while (std::getline(file, line))
+		{
+			std::istringstream lineStream{ line };
+			MovingAIScenario scenario{};
+			std::string mapName;
+			int mapWidth{}, mapHeight{};
+			if (lineStream >> scenario.bucket >> mapName >> mapWidth >> mapHeight
+				>> scenario.startCol >> scenario.startRow >> scenario.goalCol >> scenario.goalRow >> scenario.optimalCost)
+				scenarios.push_back(scenario);
+		}
+		return true;
+	}
+
+	ImplicitGridGraph MovingAIMap::CreateImplicitGridGraph(int cellSize) const
+	{
+		ImplicitGridGraph graph{ m_NrOfColumns, m_NrOfRows, cellSize, true, GetCostStraight(), GetCostDiagonal(), false };
+		for (int idx = 0; idx < int(m_TerrainTypes.size()); ++idx)
+			graph.SetTerrainType(idx, m_TerrainTypes[idx]);
+		return graph;
+	}
+}
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <string>
+
+#include "framework/EliteAI/EliteGraphs/EGridGraph.h"
+#include "framework/EliteAI/EliteGraphs/EImplicitGridGraph.h"
+
+namespace Elite
+{
+	// one query of a Moving AI .scen file, columns and rows are the x and y of the file
+	struct MovingAIScenario
+	{
+		int bucket = 0;
+		int startCol = 0;
+		int startRow = 0;
+		int goalCol = 0;
+		int goalRow = 0;
+		double optimalCost = 0.0; // the octile path length the benchmark found, diagonals cost sqrt(2)
+	};
+
+	// a map of the Moving AI grid benchmark sets (https://movingai.com/benchmarks/grids.html) in the .map text format
+	// '.', 'G' and 'S' are walkable and become ground, everything else ('@', 'O', 'T', 'W') is blocked and becomes water
+	// the graphs made out of it use the costs of the benchmark: 1 for a straight step and sqrt(2) for a diagonal one
+	// the benchmark doesn't let paths cut corners, so neither do the graphs made out of it and their path costs match the optimal costs
+	class MovingAIMap final
+	{
+	public:
+		MovingAIMap() = default;
+		~MovingAIMap() = default;
+
+		// returns false when the file can't be read or isn't an octile map
+		bool Load(const std::string& path);
+		// returns false when the file can't be read, scenarios that can't be parsed are skipped
+		static bool LoadScenarios(const std::string& path, std::vector<MovingAIScenario>& scenarios);
+
+		int GetColumns() const { return m_NrOfColumns; }
+		int GetRows() const { return m_NrOfRows; }
+		// in node index order
+		const std::vector<TerrainType>& GetTerrainTypes() const { return m_TerrainTypes; }
+
+		template<class T_NodeType, class T_ConnectionType>
+		GridGraph<T_NodeType, T_ConnectionType>* CreateGridGraph(int cellSize, bool isDirectionalGraph) const;
+		ImplicitGridGraph CreateImplicitGridGraph(int cellSize) const;
+
+		static float GetCostStraight() { return 1.f; }
+		static float GetCostDiagonal() { return 1.41421356f; }
+
+	private:
+		int m_NrOfColumns = 0;
+		int m_NrOfRows = 0;
+		std::vector<TerrainType> m_TerrainTypes;
+	};
+
+	/// <summary>
+	/// Create a diagonally connected GridGraph with the terrain of the map, without corner cutting
+	/// </summary>
+	/// <returns>a new graph the caller owns</returns>
+	template<class T_NodeType, class T_ConnectionType>
+	inline GridGraph<T_NodeType, T_ConnectionType>* MovingAIMap::CreateGridGraph(int cellSize, bool isDirectionalGraph) const
+	{
+		auto pGraph = new GridGraph<T_NodeType, T_ConnectionType>(m_NrOfColumns, m_NrOfRows, cellSize, isDirectionalGraph, true,
+			GetCostStraight(), GetCostDiagonal(), false);
+		pGraph->SetTerrainTypes(m_TerrainTypes);
+		return pGraph;
+	}
+}
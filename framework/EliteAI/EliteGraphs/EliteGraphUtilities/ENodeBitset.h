@@ -0,0 +1,56 @@
+#pragma once
+
+namespace Elite
+{
+	// one bit per node, addressed by GraphNode::GetIndex()
+	// clearing touches nrOfNodes / 64 words, so it is cheap enough to do at the start of every search
+	class NodeBitset final
+	{
+	public:
+		NodeBitset() = default;
+		~NodeBitset() = default;
+
+		void Resize(int nrOfNodes);
+		void ClearAll() { std::fill(m_Words.begin(), m_Words.end(), 0ull); }
+
+		int GetNrOfNodes() const { return m_NrOfNodes; }
+		size_t GetMemorySize() const { return m_Words.capacity() * sizeof(unsigned long long); }
+
+		bool Test(int idx) const { return (m_Words[idx >> 6] & GetMask(idx)) != 0; }
+		void Set(int idx) { m_Words[idx >> 6] |= GetMask(idx); }
+		void Reset(int idx) { m_Words[idx >> 6] &= ~GetMask(idx); }
+		bool TestAndSet(int idx);
+
+	private:
+		static unsigned long long GetMask(int idx) { return 1ull << (idx & 63); }
+
+		std::vector<unsigned long long> m_Words;
+		int m_NrOfNodes = 0;
+	};
+
+	/// <summary>
+	/// Make room for the given amount of nodes, this clears all bits
+	/// </summary>
+	/// <param name="nrOfNodes">Amount of nodes in the graph (IGraph::GetNrOfNodes)</param>
+	inline void NodeBitset::Resize(int nrOfNodes)
+	{
+		m_NrOfNodes = nrOfNodes;
+		m_Words.assign((nrOfNodes + 63) / 64, 0ull);
+	}
+
+	/// <summary>
+	/// Set the bit of a node
+	/// </summary>
+	/// <param name="idx">Index of the node</param>
+	/// <returns>Whether the bit was already set</returns>
+	inline bool NodeBitset::TestAndSet(int idx)
+	{
+		assert((idx < m_NrOfNodes) && (idx >= 0) && "<NodeBitset::TestAndSet>: invalid index");
+
+		unsigned long long& word = m_Words[idx >> 6];
+		const unsigned long long mask = GetMask(idx);
+		const bool wasSet = (word & mask) != 0;
+		word |= mask;
+		return wasSet;
+	}
+}
@@ -0,0 +1,88 @@
+#pragma once
+
+namespace Elite
+{
+	// fixed capacity FIFO queue on one contiguous buffer
+	// the capacity is rounded up to a power of 2 so wrapping around is a mask instead of a division
+	template <class T>
+	class RingBuffer
+	{
+	public:
+		RingBuffer() = default;
+		explicit RingBuffer(int capacity) { Reserve(capacity); }
+
+		void Reserve(int capacity);
+		void Clear() { m_Head = 0; m_Size = 0; m_PeakSize = 0; }
+
+		bool IsEmpty() const { return m_Size == 0; }
+		bool IsFull() const { return m_Size == int(m_Buffer.size()); }
+		int Size() const { return m_Size; }
+		int GetCapacity() const { return int(m_Buffer.size()); }
+		// the most elements that were queued at once since the last Clear
+		int GetPeakSize() const { return m_PeakSize; }
+		size_t GetMemorySize() const { return m_Buffer.capacity() * sizeof(T); }
+
+		const T& Front() const { assert(!IsEmpty() && "<RingBuffer::Front>: buffer is empty"); return m_Buffer[m_Head]; }
+		void Push(const T& value);
+		T Pop();
+
+	private:
+		std::vector<T> m_Buffer;
+		int m_Head = 0;
+		int m_Size = 0;
+		int m_PeakSize = 0;
+	};
+
+	/// <summary>
+	/// Make sure the buffer can hold at least the given amount of elements, only allocates when it has to grow
+	/// </summary>
+	/// <param name="capacity">The amount of elements that have to fit</param>
+	template<class T>
+	inline void RingBuffer<T>::Reserve(int capacity)
+	{
+		if (capacity <= GetCapacity())
+			return;
+
+		int newCapacity{ 1 };
+		while (newCapacity < capacity)
+			newCapacity <<= 1;
+
+		//unwrap the queued elements to the start of the new buffer
+		std::vector<T> newBuffer(newCapacity);
+		for (int i = 0; i < m_Size; ++i)
+			newBuffer[i] = m_Buffer[(m_Head + i) & (GetCapacity() - 1)];
+
+		m_Buffer.swap(newBuffer);
+		m_Head = 0;
+	}
+
+	/// <summary>
+	/// Add an element at the back of the queue
+	/// </summary>
+	/// <param name="value">The element to add</param>
+	template<class T>
+	inline void RingBuffer<T>::Push(const T& value)
+	{
+		assert(!IsFull() && "<RingBuffer::Push>: buffer is full");
+
+		m_Buffer[(m_Head + m_Size) & (GetCapacity() - 1)] = value;
+		++m_Size;
+		if (m_Size > m_PeakSize)
+			m_PeakSize = m_Size;
+	}
+
+	/// <summary>
+	/// Remove the element at the front of the queue
+	/// </summary>
+	/// <returns>The removed element</returns>
+	template<class T>
+	inline T RingBuffer<T>::Pop()
+	{
+		assert(!IsEmpty() && "<RingBuffer::Pop>: buffer is empty");
+
+		T value = m_Buffer[m_Head];
+		m_Head = (m_Head + 1) & (GetCapacity() - 1);
+		--m_Size;
+		return value;
+	}
+}
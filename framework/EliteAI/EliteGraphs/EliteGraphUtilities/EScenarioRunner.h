@@ -0,0 +1,118 @@
+#pragma once
+
+#include <ostream>
+
+#include "framework/EliteAI/EliteGraphs/EliteGraphUtilities/EMovingAIMap.h"
+#include "framework/EliteAI/EliteGraphs/EliteGraphUtilities/ESearchContext.h"
+
+namespace Elite
+{
+	// what one pathfinder did with the scenarios of one bucket
+	struct ScenarioBucketResult
+	{
+		int bucket = 0;
+		int nrOfScenarios = 0;
+		int nrOfUnsolved = 0; // no path found, or a path that steps between cells that aren't connected
+		int nrOfSuboptimal = 0; // solved with a cost over the optimal cost
+		double totalTime = 0.0; // milliseconds, everything FindPath did
+		double maxTime = 0.0;
+		long long totalExpandedNodes = 0;
+		double totalCostRatio = 0.0; // sum of path cost / optimal cost over the solved scenarios
+		double minCostRatio = 0.0; // under 1 when a path is cheaper than the optimal cost, a graph that cuts corners for example
+		double maxCostRatio = 0.0;
+
+		int GetNrOfSolved() const { return nrOfScenarios - nrOfUnsolved; }
+		double GetAverageTime() const { return nrOfScenarios > 0 ? totalTime / nrOfScenarios : 0.0; }
+		double GetAverageExpandedNodes() const { return nrOfScenarios > 0 ? double(totalExpandedNodes) / nrOfScenarios : 0.0; }
+		double GetAverageCostRatio() const { return GetNrOfSolved() > 0 ? totalCostRatio / GetNrOfSolved() : 0.0; }
+	};
+
+	/// <summary>
+	/// Sum the connection costs along a path, the cells of the path have to be neighbors (expand JPS paths first)
+	/// </summary>
+	/// <param name="adjacency">GraphAdjacency, CompressedGraph or ImplicitGridGraph</param>
+	/// <param name="cost">The cost of the path, summed in double so a path of thousands of steps stays exact enough to compare with an optimal cost</param>
+	/// <returns>false when 2 cells after each other on the path aren't connected</returns>
+	template<class T_Adjacency>
+	inline bool TryGetPathCost(const T_Adjacency& adjacency, const std::vector<int>& path, double& cost)
+	{
+		cost = 0.0;
+		for (size_t i = 1; i < path.size(); ++i)
+		{
+			float connectionCost{};
+			if (!adjacency.TryGetConnectionCost(path[i - 1], path[i], connectionCost))
+				return false;
+			cost += connectionCost;
+		}
+		return true;
+	}
+
+	/// <summary>
+	/// Replay Moving AI scenarios through a pathfinder and measure it per bucket
+	/// </summary>
+	/// <typeparam name="T_Pathfinder">Anything with FindPath(startIdx, destinationIdx, context) that fills context.GetPath() with neighboring cells</typeparam>
+	/// <param name="adjacency">The graph the pathfinder searches, the path costs are measured on it</param>
+	/// <param name="nrOfColumns">Columns of the grid, to turn the cells of the scenarios into node indices</param>
+	/// <param name="scenarios">In bucket order, as they come out of MovingAIMap::LoadScenarios</param>
+	/// <param name="context">Searched with, warm it up with a query first to keep its allocations out of the timings</param>
+	/// <param name="maxCostRatioError">How far the path cost / optimal cost may be over 1 before a path counts as suboptimal, the optimal costs are rounded</param>
+	/// <returns>one result per bucket, in the order the buckets first show up</returns>
+	template<class T_Pathfinder, class T_Adjacency>
+	inline std::vector<ScenarioBucketResult> RunScenarios(T_Pathfinder& pathfinder, const T_Adjacency& adjacency, int nrOfColumns,
+		const std::vector<MovingAIScenario>& scenarios, SearchContext& context, double maxCostRatioError = 0.0001)
+	{
+		std::vector<ScenarioBucketResult> results;
+		for (const MovingAIScenario& scenario : scenarios)
+		{
+			if (results.empty() || results.back().bucket != scenario.bucket)
+			{
+				results.push_back(ScenarioBucketResult{});
+				results.back().bucket = scenario.bucket;
+			}
+			ScenarioBucketResult& result = results.back();
+
+			const int startIdx{ scenario.startRow * nrOfColumns + scenario.startCol };
+			const int goalIdx{ scenario.goalRow * nrOfColumns + scenario.goalCol };
+
+			const auto startTime = std::chrono::steady_clock::now();
+			const bool foundPath{ pathfinder.FindPath(startIdx, goalIdx, context) };
+			const double time{ std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - startTime).count() };
+
+			++result.nrOfScenarios;
+			result.totalTime += time;
+			result.maxTime = std::max(result.maxTime, time);
+			result.totalExpandedNodes += context.GetStats().nrOfExpandedNodes;
+
+			double cost{};
+			if (!foundPath || !TryGetPathCost(adjacency, context.GetPath(), cost))
+			{
+				++result.nrOfUnsolved;
+				continue;
+			}
+
+			//start and goal can be the same cell
+			const double costRatio{ scenario.optimalCost > 0.0 ? cost / scenario.optimalCost : 1.0 };
+			result.totalCostRatio += costRatio;
+			result.minCostRatio = result.GetNrOfSolved() == 1 ? costRatio : std::min(result.minCostRatio, costRatio);
+			result.maxCostRatio = std::max(result.maxCostRatio, costRatio);
+			if (costRatio > 1.0 + maxCostRatioError)
+				++result.nrOfSuboptimal;
+		}
+		return results;
+	}
+
+	/// <summary>
+	/// Write one line per bucket: scenarios, unsolved, suboptimal, average and max time, average expanded nodes, average, min and max cost ratio
+	/// </summary>
+	inline void PrintScenarioResults(std::ostream& stream, const std::string& name, const std::vector<ScenarioBucketResult>& results)
+	{
+		stream << name << '\n'
+			<< "bucket\tqueries\tunsolved\tsuboptimal\tavg ms\tmax ms\tavg expanded\tavg cost ratio\tmin cost ratio\tmax cost ratio\n";
+		for (const ScenarioBucketResult& result : results)
+		{
+			stream << result.bucket << '\t' << result.nrOfScenarios << '\t' << result.nrOfUnsolved << '\t' << result.nrOfSuboptimal << '\t'
+				<< result.GetAverageTime() << '\t' << result.maxTime << '\t' << result.GetAverageExpandedNodes() << '\t'
+				<< result.GetAverageCostRatio() << '\t' << result.minCostRatio << '\t' << result.maxCostRatio << '\n';
+		}
+	}
+}
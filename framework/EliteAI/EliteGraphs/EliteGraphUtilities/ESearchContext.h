@@ -0,0 +1,235 @@
+#pragma once
+
+#include "framework/EliteAI/EliteGraphs/EliteGraphUtilities/EIndexedPriorityQueue.h"
+#include "framework/EliteAI/EliteGraphs/EliteGraphUtilities/ESearchStateTable.h"
+#include "framework/EliteAI/EliteGraphs/EliteGraphUtilities/ENodeBitset.h"
+#include "framework/EliteAI/EliteGraphs/EliteGraphUtilities/ERingBuffer.h"
+#include "framework/EliteAI/EliteGraphs/EliteGraphUtilities/ESearchStats.h"
+
+namespace Elite
+{
+	// owns all scratch memory a pathfinder needs for a query: the open list, the per node states, the BFS frontier, visited bits and parents,
+	// the second open list and node states of a bidirectional search, the distances and goal bits of a one-to-many search, and the resulting path
+	// hand the same context to every query (or share it between pathfinders) and the buffers only grow until they fit the graph,
+	// after that a search does not allocate anymore
+	class SearchContext final
+	{
+	public:
+		SearchContext() = default;
+		~SearchContext() = default;
+
+		// prepares the open list and node states only, so a search that uses nothing else stays in the order of the nodes it touches
+		void BeginSearch(int nrOfNodes);
+		// also prepares the reverse open list and node states, for a search that runs from both ends at once
+		void BeginBidirectionalSearch(int nrOfNodes);
+		// also prepares the frontier and clears the visited bits, for BFS and Dijkstra which keep their state there instead of in the node states
+		void BeginBreadthFirstSearch(int nrOfNodes);
+		// also prepares the distances and clears the goal bits, for a search from one node to every other node or to many (Dijkstra)
+		void BeginOneToManySearch(int nrOfNodes);
+		// only clears the goal bits, for AStar with many destinations
+		void ClearGoals(int nrOfNodes);
+		void BeginReconstruction();
+		void EndSearch();
+
+		IndexedPriorityQueue<float>& GetOpenList() { return m_OpenList; }
+		SearchStateTable& GetNodeStates() { return m_NodeStates; }
+		const SearchStateTable& GetNodeStates() const { return m_NodeStates; }
+
+		// bidirectional state: the half of the search that runs back from the destination
+		IndexedPriorityQueue<float>& GetReverseOpenList() { return m_ReverseOpenList; }
+		SearchStateTable& GetReverseNodeStates() { return m_ReverseNodeStates; }
+		const SearchStateTable& GetReverseNodeStates() const { return m_ReverseNodeStates; }
+
+		// breadth first state: a node is only enqueued once, so the frontier can hold every node of the graph
+		RingBuffer<int>& GetFrontier() { return m_Frontier; }
+		NodeBitset& GetVisited() { return m_Visited; }
+		std::vector<int>& GetParents() { return m_Parents; }
+		const std::vector<int>& GetParents() const { return m_Parents; }
+
+		// one-to-many state: the visited bits and parents above, with the cost from the source to every visited node
+		std::vector<float>& GetDistances() { return m_Distances; }
+		const std::vector<float>& GetDistances() const { return m_Distances; }
+		NodeBitset& GetGoals() { return m_Goals; }
+		const NodeBitset& GetGoals() const { return m_Goals; }
+		// visited and taken off the open list, so its distance and parent are final
+		bool IsSettled(int idx) const { return m_Visited.Test(idx) && !m_OpenList.Contains(idx); }
+
+		// node indices of the last path, from start to destination
+		std::vector<int>& GetPath() { return m_Path; }
+		const std::vector<int>& GetPath() const { return m_Path; }
+
+		// timings and counters of the last search
+		const SearchStats& GetStats() const { return m_Stats; }
+		void CountExpandedNode() { ++m_Stats.nrOfExpandedNodes; }
+		void CountGeneratedNode() { ++m_Stats.nrOfGeneratedNodes; }
+		void CountReopenedNode() { ++m_Stats.nrOfReopenedNodes; }
+		void CountJumpSteps(int nrOfJumpSteps) { m_Stats.nrOfJumpSteps += nrOfJumpSteps; }
+
+		// amount of searches that had to grow one of the buffers, stays the same once the context is warmed up
+		// only the buffers of the context are watched, an allocation of the pathfinder itself doesn't count
+		unsigned int GetNrOfAllocatingSearches() const { return m_NrOfAllocatingSearches; }
+		size_t GetScratchMemorySize() const;
+
+	private:
+		IndexedPriorityQueue<float> m_OpenList;
+		SearchStateTable m_NodeStates;
+		IndexedPriorityQueue<float> m_ReverseOpenList;
+		SearchStateTable m_ReverseNodeStates;
+		bool m_IsBidirectionalSearch = false;
+		bool m_IsBreadthFirstSearch = false;
+		RingBuffer<int> m_Frontier;
+		NodeBitset m_Visited;
+		std::vector<int> m_Parents; // only valid for nodes with their visited bit set
+		std::vector<float> m_Distances; // only valid for nodes with their visited bit set
+		NodeBitset m_Goals;
+		std::vector<int> m_Path;
+
+		SearchStats m_Stats{};
+		std::chrono::steady_clock::time_point m_SearchStartTime{};
+		std::chrono::steady_clock::time_point m_ReconstructionStartTime{};
+
+		size_t m_ScratchMemorySize = 0;
+		unsigned int m_NrOfAllocatingSearches = 0;
+
+		//C++ make the class non-copyable
+		SearchContext(const SearchContext&) = delete;
+		SearchContext& operator=(const SearchContext&) = delete;
+	};
+
+	/// <summary>
+	/// Prepare the buffers for a search on a graph with the given amount of nodes
+	/// </summary>
+	/// <param name="nrOfNodes">Amount of nodes in the graph (IGraph::GetNrOfNodes)</param>
+	inline void SearchContext::BeginSearch(int nrOfNodes)
+	{
+		m_Stats = SearchStats{};
+		m_SearchStartTime = std::chrono::steady_clock::now();
+
+		m_NodeStates.BeginSearch(nrOfNodes);
+		if (m_OpenList.GetNrOfIndices() != nrOfNodes)
+			m_OpenList.Resize(nrOfNodes);
+		else
+			m_OpenList.Clear();
+		m_Path.clear();
+		m_IsBidirectionalSearch = false;
+		m_IsBreadthFirstSearch = false;
+	}
+
+	/// <summary>
+	/// Prepare the buffers for a bidirectional search, the reverse buffers only get allocated by the first one
+	/// </summary>
+	/// <param name="nrOfNodes">Amount of nodes in the graph (IGraph::GetNrOfNodes)</param>
+	inline void SearchContext::BeginBidirectionalSearch(int nrOfNodes)
+	{
+		BeginSearch(nrOfNodes);
+
+		m_ReverseNodeStates.BeginSearch(nrOfNodes);
+		if (m_ReverseOpenList.GetNrOfIndices() != nrOfNodes)
+			m_ReverseOpenList.Resize(nrOfNodes);
+		else
+			m_ReverseOpenList.Clear();
+		m_IsBidirectionalSearch = true;
+	}
+
+	/// <summary>
+	/// Prepare the buffers for a search that marks the nodes it generates in the visited bits, clearing them costs a pass over all of them
+	/// </summary>
+	/// <param name="nrOfNodes">Amount of nodes in the graph (IGraph::GetNrOfNodes)</param>
+	inline void SearchContext::BeginBreadthFirstSearch(int nrOfNodes)
+	{
+		BeginSearch(nrOfNodes);
+
+		m_Frontier.Reserve(nrOfNodes);
+		m_Frontier.Clear();
+		if (m_Visited.GetNrOfNodes() != nrOfNodes)
+			m_Visited.Resize(nrOfNodes);
+		else
+			m_Visited.ClearAll();
+		if (int(m_Parents.size()) != nrOfNodes)
+			m_Parents.resize(nrOfNodes);
+		m_IsBreadthFirstSearch = true;
+	}
+
+	/// <summary>
+	/// Prepare the buffers for a search from one node to many, the distances and goal bits only get allocated by the first one
+	/// </summary>
+	/// <param name="nrOfNodes">Amount of nodes in the graph (IGraph::GetNrOfNodes)</param>
+	inline void SearchContext::BeginOneToManySearch(int nrOfNodes)
+	{
+		BeginBreadthFirstSearch(nrOfNodes);
+
+		if (int(m_Distances.size()) != nrOfNodes)
+			m_Distances.resize(nrOfNodes);
+		ClearGoals(nrOfNodes);
+	}
+
+	/// <summary>
+	/// Clear the goal bits, they only get allocated by the first search that uses them
+	/// </summary>
+	/// <param name="nrOfNodes">Amount of nodes in the graph (IGraph::GetNrOfNodes)</param>
+	inline void SearchContext::ClearGoals(int nrOfNodes)
+	{
+		if (m_Goals.GetNrOfNodes() != nrOfNodes)
+			m_Goals.Resize(nrOfNodes);
+		else
+			m_Goals.ClearAll();
+	}
+
+	/// <summary>
+	/// Mark the end of the search itself, what follows until EndSearch is timed as path reconstruction
+	/// </summary>
+	inline void SearchContext::BeginReconstruction()
+	{
+		m_ReconstructionStartTime = std::chrono::steady_clock::now();
+		m_Stats.searchTime = std::chrono::duration<double, std::milli>(m_ReconstructionStartTime - m_SearchStartTime).count();
+
+		//the open list and the frontier count their own operations, only one of them is used by a search
+		//the frontier is only cleared by a breadth first search, for the others it still holds the peak of an older one
+		m_Stats.nrOfHeapPushes = m_OpenList.GetNrOfPushes();
+		m_Stats.nrOfHeapPops = m_OpenList.GetNrOfPops();
+		m_Stats.nrOfDecreaseKeys = m_OpenList.GetNrOfDecreaseKeys();
+		m_Stats.peakOpenListSize = m_IsBreadthFirstSearch ? std::max(m_OpenList.GetPeakSize(), m_Frontier.GetPeakSize()) : m_OpenList.GetPeakSize();
+		//a bidirectional search adds the work of its reverse half, the peaks of both halves are added up
+		if (m_IsBidirectionalSearch)
+		{
+			m_Stats.nrOfHeapPushes += m_ReverseOpenList.GetNrOfPushes();
+			m_Stats.nrOfHeapPops += m_ReverseOpenList.GetNrOfPops();
+			m_Stats.nrOfDecreaseKeys += m_ReverseOpenList.GetNrOfDecreaseKeys();
+			m_Stats.peakOpenListSize += m_ReverseOpenList.GetPeakSize();
+		}
+	}
+
+	/// <summary>
+	/// Finish a search, keeps track of whether the search had to allocate
+	/// </summary>
+	inline void SearchContext::EndSearch()
+	{
+		m_Stats.reconstructionTime = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - m_ReconstructionStartTime).count();
+
+		size_t scratchMemorySize = GetScratchMemorySize();
+		if (scratchMemorySize != m_ScratchMemorySize)
+		{
+			++m_NrOfAllocatingSearches;
+			m_ScratchMemorySize = scratchMemorySize;
+		}
+		m_Stats.scratchMemory = scratchMemorySize;
+	}
+
+	/// <summary>
+	/// Get the amount of memory reserved by the buffers of this context
+	/// </summary>
+	/// <returns>the size in bytes</returns>
+	inline size_t SearchContext::GetScratchMemorySize() const
+	{
+		return m_OpenList.GetMemorySize()
+			+ m_NodeStates.GetMemorySize()
+			+ m_ReverseOpenList.GetMemorySize()
+			+ m_ReverseNodeStates.GetMemorySize()
+			+ m_Frontier.GetMemorySize()
+			+ m_Visited.GetMemorySize()
+			+ m_Parents.capacity() * sizeof(int)
+			+ m_Distances.capacity() * sizeof(float)
+			+ m_Goals.GetMemorySize()
+			+ m_Path.capacity() * sizeof(int);
+	}
+}
@@ -0,0 +1,49 @@
+#pragma once
+
+namespace Elite
+{
+	// what a pathfinder reports while it searches, the observer is a template argument of FindPath so its calls get inlined
+	// OnNodeGenerated(idx): the node was put on the open list (or the BFS frontier), or got a cheaper cost while it was on it
+	// OnNodeExpanded(idx): the node was taken off the open list and its connections (or jumps) were looked at
+	namespace SearchObservers
+	{
+		// reports nothing, FindPath without an observer uses this one and compiles to the same code as a search without the calls
+		struct None
+		{
+			void OnNodeGenerated(int) {}
+			void OnNodeExpanded(int) {}
+		};
+
+		// keeps the node indices in the order they were reported, to draw the open and closed list
+		class Recorder final
+		{
+		public:
+			void OnNodeGenerated(int idx) { m_GeneratedNodes.push_back(idx); }
+			void OnNodeExpanded(int idx) { m_ExpandedNodes.push_back(idx); }
+
+			const std::vector<int>& GetGeneratedNodes() const { return m_GeneratedNodes; }
+			const std::vector<int>& GetExpandedNodes() const { return m_ExpandedNodes; }
+			// keeps the memory for the next search
+			void Clear()
+			{
+				m_GeneratedNodes.clear();
+				m_ExpandedNodes.clear();
+			}
+
+		private:
+			std::vector<int> m_GeneratedNodes;
+			std::vector<int> m_ExpandedNodes;
+		};
+
+		// only counts, over every search it was handed to until it gets reset
+		struct Statistics
+		{
+			long long nrOfGeneratedNodes = 0;
+			long long nrOfExpandedNodes = 0;
+
+			void OnNodeGenerated(int) { ++nrOfGeneratedNodes; }
+			void OnNodeExpanded(int) { ++nrOfExpandedNodes; }
+			void Reset() { *this = Statistics{}; }
+		};
+	}
+}
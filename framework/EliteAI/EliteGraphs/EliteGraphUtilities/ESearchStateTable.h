@@ -0,0 +1,87 @@
+#pragma once
+
+namespace Elite
+{
+	enum class SearchNodeStatus : unsigned char
+	{
+		Unvisited,
+		Open,
+		Closed
+	};
+
+	// everything a search remembers about one node
+	struct SearchNodeState
+	{
+		float costSoFar = 0.f; // g-cost
+		float estimatedTotalCost = 0.f; // f-cost (= costSoFar + h-cost)
+		int parentIdx = invalid_node_index;
+		unsigned int generation = 0; // search this state was written in, older states count as unvisited
+		SearchNodeStatus status = SearchNodeStatus::Unvisited;
+	};
+
+	// per node search state, addressed by GraphNode::GetIndex()
+	// every search gets a new generation number, so states left behind by a previous search are ignored instead of cleared
+	class SearchStateTable final
+	{
+	public:
+		SearchStateTable() = default;
+		~SearchStateTable() = default;
+
+		void BeginSearch(int nrOfNodes);
+
+		int GetNrOfNodes() const { return int(m_States.size()); }
+		size_t GetMemorySize() const { return m_States.capacity() * sizeof(SearchNodeState); }
+
+		bool IsVisited(int idx) const { return m_States[idx].generation == m_Generation; }
+		bool IsOpen(int idx) const { return IsVisited(idx) && m_States[idx].status == SearchNodeStatus::Open; }
+		bool IsClosed(int idx) const { return IsVisited(idx) && m_States[idx].status == SearchNodeStatus::Closed; }
+
+		// only valid for nodes that were visited in the current search
+		SearchNodeState& GetState(int idx) { assert(IsVisited(idx) && "<SearchStateTable::GetState>: node was not visited in this search"); return m_States[idx]; }
+		const SearchNodeState& GetState(int idx) const { assert(IsVisited(idx) && "<SearchStateTable::GetState>: node was not visited in this search"); return m_States[idx]; }
+
+		SearchNodeState& Visit(int idx);
+
+	private:
+		std::vector<SearchNodeState> m_States;
+		unsigned int m_Generation = 0;
+	};
+
+	/// <summary>
+	/// Start a new search on a graph with the given amount of nodes, all nodes become unvisited
+	/// </summary>
+	/// <param name="nrOfNodes">Amount of nodes in the graph (IGraph::GetNrOfNodes)</param>
+	inline void SearchStateTable::BeginSearch(int nrOfNodes)
+	{
+		if (int(m_States.size()) != nrOfNodes)
+			m_States.resize(nrOfNodes);
+
+		++m_Generation;
+
+		//the counter wrapped around, so old states could match the new generation: wipe them once
+		if (m_Generation == 0)
+		{
+			for (SearchNodeState& state : m_States)
+				state.generation = 0;
+			m_Generation = 1;
+		}
+	}
+
+	/// <summary>
+	/// Get the state of a node, resetting it first if the current search did not visit it yet
+	/// </summary>
+	/// <param name="idx">Index of the node</param>
+	/// <returns>The state of the node in the current search</returns>
+	inline SearchNodeState& SearchStateTable::Visit(int idx)
+	{
+		assert((idx < int(m_States.size())) && (idx >= 0) && "<SearchStateTable::Visit>: invalid index");
+
+		SearchNodeState& state = m_States[idx];
+		if (state.generation != m_Generation)
+		{
+			state = SearchNodeState{};
+			state.generation = m_Generation;
+		}
+		return state;
+	}
+}
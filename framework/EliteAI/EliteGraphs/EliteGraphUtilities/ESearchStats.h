@@ -0,0 +1,25 @@
+#pragma once
+
+namespace Elite
+{
+	// measurements of the last search that ran on a SearchContext
+	struct SearchStats
+	{
+		double searchTime = 0.0; // milliseconds spent expanding nodes until the destination was reached (or the open list ran empty)
+		double reconstructionTime = 0.0; // milliseconds spent building the path out of the parents
+		int nrOfExpandedNodes = 0; // nodes taken off the open list (or BFS frontier) whose connections got looked at
+		int nrOfGeneratedNodes = 0; // nodes put on the open list (or BFS frontier), or given a cheaper cost while they were on it
+		int nrOfReopenedNodes = 0; // closed nodes put back on the open list because a cheaper path to them was found
+
+		// work done on the open list, stays 0 for BFS
+		int nrOfHeapPushes = 0;
+		int nrOfHeapPops = 0;
+		int nrOfDecreaseKeys = 0;
+		int peakOpenListSize = 0; // the most nodes on the open list (or BFS frontier) at once
+
+		// JPS: cells stepped onto while jumping, BlockJPS: diagonal steps and 63 cell reads of the bit grid, JPS+: lookups in the jump distance table
+		int nrOfJumpSteps = 0;
+
+		size_t scratchMemory = 0; // bytes held by the buffers of the search context after the search
+	};
+}
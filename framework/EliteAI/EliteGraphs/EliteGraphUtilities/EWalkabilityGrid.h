@@ -0,0 +1,292 @@
+#pragma once
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace Elite
+{
+	// bit scans on 64 bit words, bits must not be 0
+	inline int CountTrailingZeros(unsigned long long bits)
+	{
+#if defined(_MSC_VER)
+		unsigned long idx;
+		_BitScanForward64(&idx, bits);
+		return int(idx);
+#else
+		return __builtin_ctzll(bits);
+#endif
+	}
+
+	inline int CountLeadingZeros(unsigned long long bits)
+	{
+#if defined(_MSC_VER)
+		unsigned long idx;
+		_BitScanReverse64(&idx, bits);
+		return 63 - int(idx);
+#else
+		return __builtin_clzll(bits);
+#endif
+	}
+
+	// walkability of a grid packed in bits, 1 = walkable
+	// the grid is stored twice: once row by row and once column by column, so both horizontal and vertical lines
+	// can be read 64 cells at a time. Cells outside the grid read as blocked
+	class WalkabilityGrid final
+	{
+	public:
+		// one copy of the grid, a line is a row (row-major) or a column (column-major)
+		class BitPlane final
+		{
+		public:
+			void Resize(int nrOfLines, int lineLength);
+
+			int GetNrOfLines() const { return m_NrOfLines; }
+			int GetLineLength() const { return m_LineLength; }
+			size_t GetMemorySize() const { return m_Words.capacity() * sizeof(unsigned long long); }
+
+			bool Get(int line, int pos) const;
+			void Set(int line, int pos, bool isWalkable);
+
+			// 64 cells of a line, bit i is cell pos + i
+			unsigned long long GetBitsFrom(int line, int pos) const;
+			// 64 cells of a line, bit 63 - i is cell pos - i
+			unsigned long long GetBitsUntil(int line, int pos) const { return GetBitsFrom(line, pos - 63); }
+
+		private:
+			// every line gets a word of padding in front and two behind, so reads that go past its ends don't need bounds checks
+			enum { padding_front = 1, padding_back = 2 };
+
+			std::vector<unsigned long long> m_Words;
+			int m_NrOfLines = 0;
+			int m_LineLength = 0;
+			int m_WordsPerLine = 0;
+		};
+
+		WalkabilityGrid() = default;
+		~WalkabilityGrid() = default;
+
+		template<class T_NodeType, class T_ConnectionType>
+		void Build(const GridGraph<T_NodeType, T_ConnectionType>* pGraph);
+		template<class T_NodeType, class T_ConnectionType>
+		void UpdateCell(const GridGraph<T_NodeType, T_ConnectionType>* pGraph, int col, int row, std::vector<int>* pChangedCells = nullptr);
+
+		int GetColumns() const { return m_Rows.GetLineLength(); }
+		int GetRows() const { return m_Rows.GetNrOfLines(); }
+		// vector<bool> packs its flags, one bit each
+		size_t GetMemorySize() const { return m_Rows.GetMemorySize() + m_Columns.GetMemorySize() + (m_IsCellUniform.capacity() + 7) / 8; }
+
+		// true when every walkable cell is connected to all its walkable neighbours (diagonals included)
+		// with the default costs of the graph for straight and diagonal steps, only then the bits describe the graph completely
+		bool IsUniformCost() const { return m_NrOfNonUniformCells == 0; }
+		float GetCostStraight() const { return m_CostStraight; }
+		float GetCostDiagonal() const { return m_CostDiagonal; }
+
+		bool IsWalkable(int col, int row) const { return m_Rows.Get(row, col); }
+		void SetWalkable(int col, int row, bool isWalkable);
+
+		const BitPlane& GetRowMajor() const { return m_Rows; }
+		const BitPlane& GetColumnMajor() const { return m_Columns; }
+
+	private:
+		template<class T_NodeType, class T_ConnectionType>
+		bool IsCellUniform(const GridGraph<T_NodeType, T_ConnectionType>* pGraph, int col, int row) const;
+		void SetCellUniform(int idx, bool isUniform);
+
+		BitPlane m_Rows;
+		BitPlane m_Columns;
+
+		std::vector<bool> m_IsCellUniform;
+		int m_NrOfNonUniformCells = 0;
+		float m_CostStraight = 0.f;
+		float m_CostDiagonal = 0.f;
+	};
+
+	/// <summary>
+	/// Make room for the given amount of lines, all cells become blocked
+	/// </summary>
+	/// <param name="nrOfLines">Amount of lines</param>
+	/// <param name="lineLength">Amount of cells on a line</param>
+	inline void WalkabilityGrid::BitPlane::Resize(int nrOfLines, int lineLength)
+	{
+		m_NrOfLines = nrOfLines;
+		m_LineLength = lineLength;
+		m_WordsPerLine = padding_front + (lineLength + 63) / 64 + padding_back;
+		m_Words.assign(size_t(m_NrOfLines) * m_WordsPerLine, 0ull);
+	}
+
+	inline bool WalkabilityGrid::BitPlane::Get(int line, int pos) const
+	{
+		if (line < 0 || line >= m_NrOfLines || pos < 0 || pos >= m_LineLength)
+			return false;
+
+		const int bit{ pos + padding_front * 64 };
+		return (m_Words[size_t(line) * m_WordsPerLine + (bit >> 6)] >> (bit & 63)) & 1ull;
+	}
+
+	inline void WalkabilityGrid::BitPlane::Set(int line, int pos, bool isWalkable)
+	{
+		assert(line >= 0 && line < m_NrOfLines && pos >= 0 && pos < m_LineLength && "<BitPlane::Set>: cell is outside the grid");
+
+		const int bit{ pos + padding_front * 64 };
+		unsigned long long& word = m_Words[size_t(line) * m_WordsPerLine + (bit >> 6)];
+		if (isWalkable)
+			word |= 1ull << (bit & 63);
+		else
+			word &= ~(1ull << (bit & 63));
+	}
+
+	/// <summary>
+	/// Read 64 cells of a line at once
+	/// </summary>
+	/// <param name="line">The line to read, lines outside the grid read as blocked</param>
+	/// <param name="pos">First cell to read, can lie up to 64 cells in front of the line or 64 cells past it</param>
+	/// <returns>The walkability bits, bit i is cell pos + i</returns>
+	inline unsigned long long WalkabilityGrid::BitPlane::GetBitsFrom(int line, int pos) const
+	{
+		if (line < 0 || line >= m_NrOfLines)
+			return 0ull;
+
+		assert(pos >= -64 && pos <= m_LineLength + 64 && "<BitPlane::GetBitsFrom>: read goes past the padding");
+
+		const int bit{ pos + padding_front * 64 };
+		const unsigned long long* pWords{ &m_Words[size_t(line) * m_WordsPerLine + (bit >> 6)] };
+		const int shift{ bit & 63 };
+		if (shift == 0)
+			return pWords[0];
+		return (pWords[0] >> shift) | (pWords[1] << (64 - shift));
+	}
+
+	/// <summary>
+	/// Mark a cell as walkable or blocked in both copies of the grid
+	/// </summary>
+	/// <param name="col">Column of the cell</param>
+	/// <param name="row">Row of the cell</param>
+	/// <param name="isWalkable">Whether the cell can be walked on</param>
+	inline void WalkabilityGrid::SetWalkable(int col, int row, bool isWalkable)
+	{
+		m_Rows.Set(row, col, isWalkable);
+		m_Columns.Set(col, row, isWalkable);
+	}
+
+	inline void WalkabilityGrid::SetCellUniform(int idx, bool isUniform)
+	{
+		if (m_IsCellUniform[idx] == isUniform)
+			return;
+
+		m_IsCellUniform[idx] = isUniform;
+		m_NrOfNonUniformCells += isUniform ? -1 : 1;
+	}
+
+	/// <summary>
+	/// Derive the walkability bits from the connections of a grid graph, a cell is walkable when it has connections
+	/// (water is isolated, so it ends up blocked)
+	/// </summary>
+	/// <typeparam name="T_NodeType">The type of node used on the graph</typeparam>
+	/// <typeparam name="T_ConnectionType"><The type of connection used on the graph/typeparam>
+	/// <param name="pGraph">The grid to read</param>
+	template<class T_NodeType, class T_ConnectionType>
+	inline void WalkabilityGrid::Build(const GridGraph<T_NodeType, T_ConnectionType>* pGraph)
+	{
+		const int nrOfColumns{ pGraph->GetColumns() };
+		const int nrOfRows{ pGraph->GetRows() };
+		m_Rows.Resize(nrOfRows, nrOfColumns);
+		m_Columns.Resize(nrOfColumns, nrOfRows);
+
+		for (int row = 0; row < nrOfRows; ++row)
+		{
+			for (int col = 0; col < nrOfColumns; ++col)
+			{
+				if (!pGraph->GetConnections(pGraph->GetIndex(col, row)).empty())
+					SetWalkable(col, row, true);
+			}
+		}
+
+		m_IsCellUniform.assign(size_t(nrOfColumns) * nrOfRows, true);
+		m_NrOfNonUniformCells = 0;
+		m_CostStraight = pGraph->GetDefaultCostStraight();
+		m_CostDiagonal = pGraph->GetDefaultCostDiagonal();
+		for (int row = 0; row < nrOfRows; ++row)
+		{
+			for (int col = 0; col < nrOfColumns; ++col)
+				SetCellUniform(pGraph->GetIndex(col, row), IsCellUniform(pGraph, col, row));
+		}
+	}
+
+	/// <summary>
+	/// Read the walkability of a cell that was edited (and its neighbors, their connections changed with it) from the graph again
+	/// </summary>
+	/// <typeparam name="T_NodeType">The type of node used on the graph</typeparam>
+	/// <typeparam name="T_ConnectionType"><The type of connection used on the graph/typeparam>
+	/// <param name="pGraph">The grid the bits were built from</param>
+	/// <param name="col">Column of the edited cell</param>
+	/// <param name="row">Row of the edited cell</param>
+	/// <param name="pChangedCells">optional vector that gets the indices of the cells that became walkable or blocked</param>
+	template<class T_NodeType, class T_ConnectionType>
+	inline void WalkabilityGrid::UpdateCell(const GridGraph<T_NodeType, T_ConnectionType>* pGraph, int col, int row, std::vector<int>* pChangedCells)
+	{
+		for (int neighborRow = row - 1; neighborRow <= row + 1; ++neighborRow)
+		{
+			for (int neighborCol = col - 1; neighborCol <= col + 1; ++neighborCol)
+			{
+				if (!pGraph->IsWithinBounds(neighborCol, neighborRow))
+					continue;
+
+				const int idx{ pGraph->GetIndex(neighborCol, neighborRow) };
+				const bool isWalkable{ !pGraph->GetConnections(idx).empty() };
+				if (isWalkable == IsWalkable(neighborCol, neighborRow))
+					continue;
+
+				SetWalkable(neighborCol, neighborRow, isWalkable);
+				if (pChangedCells)
+					pChangedCells->push_back(idx);
+			}
+		}
+
+		//a cell checks the bits of its neighbors, so everything within 2 cells of the edit has to be checked again
+		for (int neighborRow = row - 2; neighborRow <= row + 2; ++neighborRow)
+		{
+			for (int neighborCol = col - 2; neighborCol <= col + 2; ++neighborCol)
+			{
+				if (pGraph->IsWithinBounds(neighborCol, neighborRow))
+					SetCellUniform(pGraph->GetIndex(neighborCol, neighborRow), IsCellUniform(pGraph, neighborCol, neighborRow));
+			}
+		}
+	}
+
+	/// <summary>
+	/// Check whether the bits describe the connections of a cell: it connects to exactly its walkable neighbors
+	/// with the default costs of the graph
+	/// </summary>
+	template<class T_NodeType, class T_ConnectionType>
+	inline bool WalkabilityGrid::IsCellUniform(const GridGraph<T_NodeType, T_ConnectionType>* pGraph, int col, int row) const
+	{
+		if (!IsWalkable(col, row))
+			return true;
+
+		int nrOfWalkableNeighbors{ 0 };
+		for (int deltaRow = -1; deltaRow <= 1; ++deltaRow)
+		{
+			for (int deltaCol = -1; deltaCol <= 1; ++deltaCol)
+			{
+				if ((deltaCol != 0 || deltaRow != 0) && IsWalkable(col + deltaCol, row + deltaRow))
+					++nrOfWalkableNeighbors;
+			}
+		}
+
+		const auto& connections = pGraph->GetConnections(pGraph->GetIndex(col, row));
+		if (int(connections.size()) != nrOfWalkableNeighbors)
+			return false;
+
+		//terrain that changes the cost of a step (mud) makes the cell non-uniform, even when all of the grid has it
+		const int nrOfColumns{ pGraph->GetColumns() };
+		for (auto pConnection : connections)
+		{
+			const int toIdx{ pConnection->GetTo() };
+			const bool isDiagonal{ toIdx % nrOfColumns != col && toIdx / nrOfColumns != row };
+			if (pConnection->GetCost() != (isDiagonal ? pGraph->GetDefaultCostDiagonal() : pGraph->GetDefaultCostStraight()))
+				return false;
+		}
+		return true;
+	}
+}
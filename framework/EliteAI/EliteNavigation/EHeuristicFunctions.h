@@ -44,5 +44,54 @@ namespace Elite
 			return std::max(x, y);
 		}
 	};
+
+	//The same heuristics as types, a pathfinder templated on one of these calls it directly so it can be inlined
+	//the int overloads get the column and row distance on a grid
+	namespace HeuristicPolicies
+	{
+		struct Manhattan
+		{
+			float operator()(float x, float y) const { return x + y; }
+			float operator()(int x, int y) const { return float(x + y); }
+		};
+
+		struct Euclidean
+		{
+			float operator()(float x, float y) const { return sqrtf(x * x + y * y); }
+			float operator()(int x, int y) const { return sqrtf(float(x * x + y * y)); }
+		};
+
+		struct SqrtEuclidean
+		{
+			float operator()(float x, float y) const { return x * x + y * y; }
+			float operator()(int x, int y) const { return float(x * x + y * y); }
+		};
+
+		struct Octile
+		{
+			float operator()(float x, float y) const
+			{
+				const float f = 0.414213562373095048801f; // == sqrt(2) - 1;
+				return (x < y) ? f * x + y : f * y + x;
+			}
+			float operator()(int x, int y) const { return (*this)(float(x), float(y)); }
+		};
+
+		struct Chebyshev
+		{
+			float operator()(float x, float y) const { return (x < y) ? y : x; }
+			float operator()(int x, int y) const { return float((x < y) ? y : x); }
+		};
+
+		//Calls a heuristic function picked at runtime (HeuristicFunctions), what the pathfinders use by default
+		struct Function
+		{
+			Function(Heuristic function = HeuristicFunctions::Chebyshev) : function{ function } {}
+			float operator()(float x, float y) const { return function(x, y); }
+			float operator()(int x, int y) const { return function(float(x), float(y)); }
+
+			Heuristic function;
+		};
+	}
 }
 #endif
\ No newline at end of file
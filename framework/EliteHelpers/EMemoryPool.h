@@ -2,17 +2,19 @@
 // Copyright 2017-2018 Elite Engine
 // Authors: Matthieu Delaere
 /*=============================================================================*/
-// EMemoryPool.h: class that implements a memory pool. Pool is expandable, but NOT pointer to other pool SAFE.
-// TODO: make EMemoryPool thread safe - fix expandability pointer to pool problem!
+// EMemoryPool.h: class that implements a memory pool. Pool is expandable and grows in chunks that never move,
+// so pointers to units stay valid. Returned units are reused through a free list.
+// TODO: make EMemoryPool thread safe
 /*=============================================================================*/
 #ifndef ELITE_MEMORYPOOL
 #define ELITE_MEMORYPOOL
 #include <stdlib.h>
-#include "EMemoryPoolHelpers.h"
+#include <new>
+#include <utility>
 
 namespace Elite
 {
-	template<class T, class = std::enable_if<std::is_base_of<IPoolable<T>, T>::value>>
+	template<class T>
 	class EMemoryPool final
 	{
 	public:
@@ -22,58 +24,96 @@ namespace Elite
 		{ DestroyPool(); }
 
 		//--- Public Functions ---
-		//Initialize should be called before using MemoryPool. 
+		//Initialize should be called before using MemoryPool.
 		//This prevents memory pool allocation for local objects that are used as parameters for copying Data in pool
+		//An expandable pool adds a chunk as big as the whole pool so far every time it runs out
 		void InitializePool(unsigned int amount, bool isExpandable = false)
 		{
 			if (m_IsInitialized)
 				return;
 
-			m_TotalAmountUnits = amount;
 			m_IsExpandable = isExpandable;
 			m_IsInitialized = true;
-
-			//Calculate size of pool
-			auto sizePerUnit = sizeof(T);
-			auto totalSizePool = amount * sizePerUnit;
-
-			//Allocate pool and prepare datamembers for usage
-			m_pMemoryBlock = static_cast<T*>(malloc(totalSizePool));
-			m_pFreeHead = m_pMemoryBlock;
+			AddChunk(amount);
 		}
 
 		void DestroyPool()
 		{
 			//Safety, pool has to be initialized first and it should have data!
-			if (!m_IsInitialized || !m_pMemoryBlock)
+			if (!m_IsInitialized || m_Chunks.empty())
 				return;
-			//Flush pool to call all Destroy() functions
+			//Flush pool to destroy all units still in use
 			Flush();
 			//Deallocate pool
-			free(m_pMemoryBlock);
-			m_pMemoryBlock = nullptr;
+			for (const Chunk& chunk : m_Chunks)
+				free(chunk.pUnits);
+			m_Chunks.clear();
+			m_IsUnitInUse.clear();
+			m_TotalAmountUnits = 0;
+			m_IsInitialized = false;
+		}
+
+		//Make sure amount more units can be handed out without expanding again, in one chunk of exactly the missing size
+		void Reserve(unsigned int amount)
+		{
+			if (!m_IsInitialized)
+				return;
+
+			const unsigned int amountAvailable{ m_TotalAmountUnits - m_AmountHandedOut };
+			if (amountAvailable < amount)
+				AddChunk(amount - amountAvailable);
 		}
 
-		T* GetAvailableUnit()
+		//Constructs a unit out of the given arguments, returns nullptr when the pool is full and can't expand
+		template<class... T_Args>
+		T* GetAvailableUnit(T_Args&&... args)
 		{
 			//Safety, pool has to be initialized first!
 			if (!m_IsInitialized)
 				return nullptr;
-			//If we currently have reached the limit, check if we are allowed to resize
-			if (m_CurrentAmountInUse == m_TotalAmountUnits && !m_IsExpandable)
-				return nullptr; //If not, return a nullptr
-			else if (m_CurrentAmountInUse == m_TotalAmountUnits && m_IsExpandable)
-				ExpandPool(); //Else expand the pool
-
-			//Return available head and adjust variables
-			auto pAvailableUnit = m_pFreeHead;
-			*pAvailableUnit = {}; //Set data of unit to NULL if you want to
-			++m_pFreeHead;
+
+			//Reuse a returned unit first, then the untouched units at the end of the last chunk
+			Unit* pAvailableUnit{ m_pFreeHead };
+			if (pAvailableUnit)
+			{
+				m_pFreeHead = pAvailableUnit->pNextFree;
+				m_IsUnitInUse[GetUnitIndex(pAvailableUnit)] = true;
+			}
+			else
+			{
+				//If we currently have reached the limit, check if we are allowed to resize
+				if (m_AmountHandedOut == m_TotalAmountUnits && !m_IsExpandable)
+					return nullptr; //If not, return a nullptr
+				else if (m_AmountHandedOut == m_TotalAmountUnits && m_IsExpandable)
+					AddChunk(m_TotalAmountUnits); //Else expand the pool
+
+				pAvailableUnit = GetUnit(m_AmountHandedOut);
+				m_IsUnitInUse[m_AmountHandedOut] = true;
+				++m_AmountHandedOut;
+			}
 			++m_CurrentAmountInUse;
-			return pAvailableUnit;
+			return new (pAvailableUnit->object) T(std::forward<T_Args>(args)...);
+		}
+
+		//Destroys a unit and puts its memory on the free list
+		void ReturnUnit(T* pUnit)
+		{
+			assert(IsUnitOfPool(pUnit) && "<EMemoryPool::ReturnUnit>: unit doesn't belong to this pool");
+			pUnit->~T();
+
+			Unit* pFreeUnit{ reinterpret_cast<Unit*>(pUnit) };
+			m_IsUnitInUse[GetUnitIndex(pFreeUnit)] = false;
+			pFreeUnit->pNextFree = m_pFreeHead;
+			m_pFreeHead = pFreeUnit;
+			--m_CurrentAmountInUse;
 		}
 
-		//Return pointer to first used unit and the amount of units in use.
+		bool IsUnitOfPool(const T* pUnit) const
+		{
+			return FindChunk(reinterpret_cast<const Unit*>(pUnit)) != nullptr;
+		}
+
+		//Return pointers to all units in use.
 		//This can be used to iterate over all the active unites.
 		std::vector<T*> GetAllActiveUnits() const
 		{
@@ -83,13 +123,14 @@ namespace Elite
 			if (!m_IsInitialized)
 				return container;
 			//Reserve space and copy all pointers in container and return.
-			//TODO: optimize this!
 			container.reserve(m_CurrentAmountInUse);
-			auto tempUnit = m_pMemoryBlock;
-			for (unsigned int i = 0; i < m_CurrentAmountInUse; ++i)
+			for (const Chunk& chunk : m_Chunks)
 			{
-				container.push_back(tempUnit);
-				++tempUnit;
+				for (unsigned int i = 0; i < chunk.amount && chunk.firstUnitIndex + i < m_AmountHandedOut; ++i)
+				{
+					if (m_IsUnitInUse[chunk.firstUnitIndex + i])
+						container.push_back(reinterpret_cast<T*>(chunk.pUnits[i].object));
+				}
 			}
 			return container;
 		}
@@ -97,51 +138,114 @@ namespace Elite
 		void Flush()
 		{
 			//Safety, pool has to be initialized first and it should have data!
-			if (!m_IsInitialized || !m_pMemoryBlock)
+			if (!m_IsInitialized || m_Chunks.empty())
 				return;
 
-			//Keep memoryblock, do not reset units, but reset the variables
-			T* pCurrentObj = m_pMemoryBlock;
-			for (unsigned int i = 0; i < m_CurrentAmountInUse; ++i)
+			//Keep memory, destroy the units still in use and start handing out from the first unit again
+			for (const Chunk& chunk : m_Chunks)
 			{
-				//Every T inherits from IPoolable, which should provide implementation Destroy()!
-				pCurrentObj->Destroy();
-				++pCurrentObj;
+				for (unsigned int i = 0; i < chunk.amount && chunk.firstUnitIndex + i < m_AmountHandedOut; ++i)
+				{
+					if (m_IsUnitInUse[chunk.firstUnitIndex + i])
+					{
+						reinterpret_cast<T*>(chunk.pUnits[i].object)->~T();
+						m_IsUnitInUse[chunk.firstUnitIndex + i] = false;
+					}
+				}
 			}
-			m_pFreeHead = m_pMemoryBlock;
+			m_pFreeHead = nullptr;
+			m_AmountHandedOut = 0;
 			m_CurrentAmountInUse = 0;
 		}
 
+		unsigned int GetAmountInUse() const { return m_CurrentAmountInUse; }
+		size_t GetMemorySize() const { return size_t(m_TotalAmountUnits) * sizeof(Unit) + m_IsUnitInUse.capacity() / 8; }
+
+		EMemoryPool(const EMemoryPool&) = delete;
+		EMemoryPool& operator=(const EMemoryPool&) = delete;
+
 	private:
+		//--- Private Types ---
+		//A unit holds an object while it's in use and the link to the next free unit after it was returned
+		union Unit
+		{
+			alignas(T) unsigned char object[sizeof(T)];
+			Unit* pNextFree;
+		};
+
+		//Units of a chunk are numbered on from the units of the chunks before it
+		struct Chunk
+		{
+			Unit* pUnits;
+			unsigned int firstUnitIndex;
+			unsigned int amount;
+		};
+
 		//--- Private Functions ---
-		void ExpandPool()
+		void AddChunk(unsigned int amount)
 		{
-			//Safety, pool has to be initialized first and it should have data!
-			if (!m_IsInitialized || !m_pMemoryBlock)
+			if (amount == 0)
 				return;
 
-			//Allocate new block of double the size
-			auto sizePerUnit = sizeof(T);
-			auto newSizePool = (m_TotalAmountUnits * 2) * sizePerUnit;
-			auto pNewMemoryBlock = static_cast<T*>(malloc(newSizePool));
-			//Copy all data from old block to new block
-			auto oldSizePool = m_TotalAmountUnits * sizePerUnit;
-			memcpy(pNewMemoryBlock, m_pMemoryBlock, oldSizePool);
-			//Free old memory block
-			free(m_pMemoryBlock);
-			//Set new variables
-			m_pMemoryBlock = pNewMemoryBlock;
-			m_pFreeHead = m_pMemoryBlock + m_TotalAmountUnits; //Set to end of previous block, starting at the beginning of new segment
-			m_TotalAmountUnits *= 2;
+			//Allocate new block, the old blocks stay where they are
+			Chunk chunk{};
+			chunk.pUnits = static_cast<Unit*>(malloc(amount * sizeof(Unit)));
+			chunk.firstUnitIndex = m_TotalAmountUnits;
+			chunk.amount = amount;
+
+			//Units are handed out in order, so the free space at the end of the last chunk moves to the new chunk
+			//by splitting it off onto the free list
+			for (unsigned int i = m_AmountHandedOut; i < m_TotalAmountUnits; ++i)
+			{
+				Unit* pUnit{ GetUnit(i) };
+				pUnit->pNextFree = m_pFreeHead;
+				m_pFreeHead = pUnit;
+			}
+			m_AmountHandedOut = m_TotalAmountUnits;
+
+			m_Chunks.push_back(chunk);
+			m_TotalAmountUnits += amount;
+			m_IsUnitInUse.resize(m_TotalAmountUnits, false);
+		}
+
+		const Chunk* FindChunk(const Unit* pUnit) const
+		{
+			//Chunks grow with the pool, so there are only a few of them
+			for (const Chunk& chunk : m_Chunks)
+			{
+				if (pUnit >= chunk.pUnits && pUnit < chunk.pUnits + chunk.amount)
+					return &chunk;
+			}
+			return nullptr;
+		}
+
+		unsigned int GetUnitIndex(const Unit* pUnit) const
+		{
+			const Chunk* pChunk{ FindChunk(pUnit) };
+			return pChunk->firstUnitIndex + static_cast<unsigned int>(pUnit - pChunk->pUnits);
+		}
+
+		Unit* GetUnit(unsigned int unitIndex) const
+		{
+			//The last chunk is the most likely one, so search backwards
+			for (auto chunkIt = m_Chunks.rbegin(); chunkIt != m_Chunks.rend(); ++chunkIt)
+			{
+				if (unitIndex >= chunkIt->firstUnitIndex)
+					return chunkIt->pUnits + (unitIndex - chunkIt->firstUnitIndex);
+			}
+			return nullptr;
 		}
 
 		//--- Datamembers ---
-		T* m_pMemoryBlock = nullptr;
-		T* m_pFreeHead = nullptr;
+		std::vector<Chunk> m_Chunks;
+		std::vector<bool> m_IsUnitInUse;
+		Unit* m_pFreeHead = nullptr;
 		unsigned int m_TotalAmountUnits = 0;
+		//Units before this index were handed out at some point, the ones after it were never touched
+		unsigned int m_AmountHandedOut = 0;
 		unsigned int m_CurrentAmountInUse = 0;
 		bool m_IsExpandable = false;
 		bool m_IsInitialized = false;
 	};
 }
-#endif
\ No newline at end of file
+#endif
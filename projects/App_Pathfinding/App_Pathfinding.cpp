@@ -3,15 +3,21 @@
 
 //Includes
 #include "App_Pathfinding.h"
-#include "framework\EliteAI\EliteGraphs\EliteGraphAlgorithms\EAstar.h"
-#include "framework\EliteAI\EliteGraphs\EliteGraphAlgorithms\EBFS.h"
-#include "framework\EliteAI\EliteGraphs\EliteGraphAlgorithms\EJPS.h"
 
 using namespace Elite;
 
 //Destructor
 App_Pathfinding::~App_Pathfinding()
 {
+	SAFE_DELETE(m_pManhattanPathfinders);
+	SAFE_DELETE(m_pEuclideanPathfinders);
+	SAFE_DELETE(m_pSqrtEuclideanPathfinders);
+	SAFE_DELETE(m_pOctilePathfinders);
+	SAFE_DELETE(m_pChebyshevPathfinders);
+	SAFE_DELETE(m_pBreathPathfinder);
+	SAFE_DELETE(m_pBlockJumpPathfinder);
+	SAFE_DELETE(m_pJumpPlusPathfinder);
+	SAFE_DELETE(m_pHierarchicalPathfinder);
 	SAFE_DELETE(m_pGridGraph);
 }
 
@@ -27,6 +33,25 @@ void App_Pathfinding::Start()
 	//Create Graph
 	MakeGridGraph();
 
+	//Create Pathfinders, the ones that walk the graph node by node search its compressed copy
+	//every cell gets room for its 8 neighbors, so editing a cell never needs a full rebuild
+	m_CompressedGraph.Build(m_pGridGraph, 8);
+	m_pManhattanPathfinders = new HeuristicPathfinders<HeuristicPolicies::Manhattan>(m_pGridGraph, &m_CompressedGraph);
+	m_pEuclideanPathfinders = new HeuristicPathfinders<HeuristicPolicies::Euclidean>(m_pGridGraph, &m_CompressedGraph);
+	m_pSqrtEuclideanPathfinders = new HeuristicPathfinders<HeuristicPolicies::SqrtEuclidean>(m_pGridGraph, &m_CompressedGraph);
+	m_pOctilePathfinders = new HeuristicPathfinders<HeuristicPolicies::Octile>(m_pGridGraph, &m_CompressedGraph);
+	m_pChebyshevPathfinders = new HeuristicPathfinders<HeuristicPolicies::Chebyshev>(m_pGridGraph, &m_CompressedGraph);
+	m_pBreathPathfinder = new BFS<GridTerrainNode, GraphConnection>(m_pGridGraph);
+	m_pBreathPathfinder->SetCompressedGraph(&m_CompressedGraph);
+	m_pBlockJumpPathfinder = new BlockJPS<GridTerrainNode, GraphConnection>(m_pGridGraph, m_pHeuristicFunction);
+	m_pJumpPlusPathfinder = new JPSPlus<GridTerrainNode, GraphConnection>(m_pGridGraph, m_pHeuristicFunction);
+	//clusters of 5 by 5 cells, so the small grid still has a few of them to show the abstract search
+	m_pHierarchicalPathfinder = new HPAStar<GridTerrainNode, GraphConnection>(m_pGridGraph, 5, m_pHeuristicFunction);
+	m_pHierarchicalPathfinder->SetCompressedGraph(&m_CompressedGraph);
+
+	//the grid lets us know once per terrain edit which cells changed, so the copies above only get patched there
+	m_pGridGraph->SetTerrainChangedCallback([this](const std::vector<int>& changedNodes) { OnTerrainChanged(changedNodes); });
+
 	startPathIdx = 0;
 	endPathIdx = 4;
 }
@@ -78,34 +103,37 @@ void App_Pathfinding::Update(float deltaTime)
 		auto startNode = m_pGridGraph->GetNode(startPathIdx);
 		auto endNode = m_pGridGraph->GetNode(endPathIdx);
 		
-		auto breathPathfinder = BFS<GridTerrainNode, GraphConnection>(m_pGridGraph, m_pHeuristicFunction);
-		auto starPathfinder = AStar<GridTerrainNode, GraphConnection>(m_pGridGraph, m_pHeuristicFunction);
-		auto jumpPathfinder = JPS<GridTerrainNode, GraphConnection>(m_pGridGraph, m_pHeuristicFunction);
-		m_OpenList.clear();
-		m_ClosedList.clear();
+		m_SearchRecorder.Clear();
 		std::chrono::system_clock::time_point startTime = std::chrono::system_clock::now();
-		std::cout << "Using ";
-		// Some computation here
-		switch (m_SearchAlgorithmUsed)
+
+		//pick the pathfinders of the heuristic once, everything in the search below gets it inlined
+		switch (m_SelectedHeuristic)
 		{
-		case SearchAlgorithmUsed::Breath:
-			//BFS Pathfinding
-			std::cout << "Breath First Search" << std::endl;
-			m_vPath = breathPathfinder.FindPath(startNode, endNode, m_OpenList, m_ClosedList);
+		case 0:
+			CalculatePath(*m_pManhattanPathfinders, startNode, endNode);
 			break;
-		case SearchAlgorithmUsed::Star:
-			//A* Pathfinding
-			std::cout << "A star" << std::endl;
-			m_vPath = starPathfinder.FindPath(startNode, endNode, m_OpenList, m_ClosedList);
+		case 1:
+			CalculatePath(*m_pEuclideanPathfinders, startNode, endNode);
 			break;
-		case SearchAlgorithmUsed::JumpPoint:
-			//JPS Pathfinding
-			std::cout << "Jump Point Search" << std::endl;
-			m_vPath = jumpPathfinder.FindPath(startNode, endNode, m_OpenList, m_ClosedList);
+		case 2:
+			CalculatePath(*m_pSqrtEuclideanPathfinders, startNode, endNode);
+			break;
+		case 3:
+			CalculatePath(*m_pOctilePathfinders, startNode, endNode);
 			break;
 		default:
+			CalculatePath(*m_pChebyshevPathfinders, startNode, endNode);
 			break;
 		}
+		m_vPath.clear();
+		for (int idx : m_SearchContext.GetPath())
+			m_vPath.push_back(m_pGridGraph->GetNode(idx));
+		m_OpenList.clear();
+		for (int idx : m_SearchRecorder.GetGeneratedNodes())
+			m_OpenList.push_back(m_pGridGraph->GetNode(idx));
+		m_ClosedList.clear();
+		for (int idx : m_SearchRecorder.GetExpandedNodes())
+			m_ClosedList.push_back(m_pGridGraph->GetNode(idx));
 		std::chrono::system_clock::time_point endTime = std::chrono::system_clock::now();
 		std::chrono::duration<float> elapsedTime = endTime - startTime;
 		m_UpdatePath = false;
@@ -113,6 +141,62 @@ void App_Pathfinding::Update(float deltaTime)
 	}
 }
 
+template<class T_HeuristicPolicy>
+void App_Pathfinding::CalculatePath(HeuristicPathfinders<T_HeuristicPolicy>& pathfinders, GridTerrainNode* pStartNode, GridTerrainNode* pEndNode)
+{
+	//BlockJPS, JPS+ and HPA* keep their grid between searches, they get the heuristic at runtime
+	m_pBlockJumpPathfinder->SetHeuristicFunction(m_pHeuristicFunction);
+	m_pJumpPlusPathfinder->SetHeuristicFunction(m_pHeuristicFunction);
+	m_pHierarchicalPathfinder->SetHeuristicFunction(m_pHeuristicFunction);
+
+	//search by index so the recorder can watch, the nodes it reports get looked up after the search
+	const int startIdx{ pStartNode->GetIndex() };
+	const int endIdx{ pEndNode->GetIndex() };
+
+	std::cout << "Using ";
+	// Some computation here
+	switch (m_SearchAlgorithmUsed)
+	{
+	case SearchAlgorithmUsed::Breath:
+		//BFS Pathfinding
+		std::cout << "Breath First Search" << std::endl;
+		m_pBreathPathfinder->FindPath(startIdx, endIdx, m_SearchContext, m_SearchRecorder);
+		break;
+	case SearchAlgorithmUsed::Star:
+		//A* Pathfinding
+		std::cout << "A star" << std::endl;
+		pathfinders.starPathfinder.FindPath(startIdx, endIdx, m_SearchContext, m_SearchRecorder);
+		break;
+	case SearchAlgorithmUsed::JumpPoint:
+		//JPS Pathfinding
+		std::cout << "Jump Point Search" << std::endl;
+		pathfinders.jumpPathfinder.FindPath(startIdx, endIdx, m_SearchContext, m_SearchRecorder);
+		break;
+	case SearchAlgorithmUsed::BlockJumpPoint:
+		//Block JPS Pathfinding
+		std::cout << "Block Jump Point Search" << std::endl;
+		m_pBlockJumpPathfinder->FindPath(startIdx, endIdx, m_SearchContext, m_SearchRecorder);
+		break;
+	case SearchAlgorithmUsed::JumpPointPlus:
+		//JPS+ Pathfinding
+		std::cout << "Jump Point Search Plus" << std::endl;
+		m_pJumpPlusPathfinder->FindPath(startIdx, endIdx, m_SearchContext, m_SearchRecorder);
+		break;
+	case SearchAlgorithmUsed::BidirectionalStar:
+		//Bidirectional A* Pathfinding
+		std::cout << "Bidirectional A star" << std::endl;
+		pathfinders.bidirectionalPathfinder.FindPath(startIdx, endIdx, m_SearchContext, m_SearchRecorder);
+		break;
+	case SearchAlgorithmUsed::HierarchicalStar:
+		//HPA* Pathfinding, the open and closed list only show the transitions between the clusters
+		std::cout << "Hierarchical A star" << std::endl;
+		m_pHierarchicalPathfinder->FindPath(startIdx, endIdx, m_SearchContext, m_SearchRecorder);
+		break;
+	default:
+		break;
+	}
+}
+
 void App_Pathfinding::Render(float deltaTime) const
 {
 	UNREFERENCED_PARAMETER(deltaTime);
@@ -155,8 +239,32 @@ void App_Pathfinding::Render(float deltaTime) const
 	}
 }
 
+void App_Pathfinding::OnTerrainChanged(const std::vector<int>& changedNodes)
+{
+	m_CompressedGraph.UpdateNodes(m_pGridGraph, changedNodes);
+	//block JPS and JPS+ only read the bits around the changed cells again, JPS+ repairs its table there too
+	m_pBlockJumpPathfinder->UpdateNodes(changedNodes);
+	m_pJumpPlusPathfinder->UpdateNodes(changedNodes);
+	//HPA* only rebuilds the clusters the changed cells lie in or border on
+	m_pHierarchicalPathfinder->UpdateNodes(changedNodes);
+	//bidirectional A* keeps a reversed copy of a directed grid, for an undirected one this does nothing
+	m_pManhattanPathfinders->bidirectionalPathfinder.UpdateReverseGraph();
+	m_pEuclideanPathfinders->bidirectionalPathfinder.UpdateReverseGraph();
+	m_pSqrtEuclideanPathfinders->bidirectionalPathfinder.UpdateReverseGraph();
+	m_pOctilePathfinders->bidirectionalPathfinder.UpdateReverseGraph();
+	m_pChebyshevPathfinders->bidirectionalPathfinder.UpdateReverseGraph();
+}
+
 void App_Pathfinding::MakeGridGraph()
 {
+	//a saved map has its own size and costs, the file only has to stay open while the grid gets built
+	GridMapFile mapFile{};
+	if (mapFile.Open(m_MapFilePath))
+	{
+		m_pGridGraph = mapFile.CreateGridGraph<GridTerrainNode, GraphConnection>(false);
+		return;
+	}
+
 	m_pGridGraph = new GridGraph<GridTerrainNode, GraphConnection>(
 		COLUMNS, 
 		ROWS, 
@@ -222,6 +330,10 @@ void App_Pathfinding::UpdateImGui()
 		ImGui::Checkbox("NodeNumbers", &m_bDrawNodeNumbers);
 		ImGui::Checkbox("Connections", &m_bDrawConnections);
 		ImGui::Checkbox("Connections Costs", &m_bDrawConnectionsCosts);
+		if (ImGui::Button("Save Map"))
+		{
+			GridMapFile::Write(m_MapFilePath, m_pGridGraph);
+		}
 		if (ImGui::Combo("Heuristic", &m_SelectedHeuristic, "Manhattan\0Euclidean\0SqrtEuclidean\0Octile\0Chebyshev", 4))
 		{
 			switch (m_SelectedHeuristic)
@@ -247,7 +359,7 @@ void App_Pathfinding::UpdateImGui()
 			}
 		}
 		ImGui::Spacing();
-		if (ImGui::Combo("Algorithm", &m_SelectedAlgorithm, "BFS\0AStar\0JPS\0None", 3))
+		if (ImGui::Combo("Algorithm", &m_SelectedAlgorithm, "BFS\0AStar\0JPS\0BlockJPS\0JPS+\0Bidirectional A*\0HPA*\0None", 7))
 		{
 			switch (m_SelectedAlgorithm)
 			{
@@ -260,12 +372,42 @@ void App_Pathfinding::UpdateImGui()
 			case 2:
 				m_SearchAlgorithmUsed = SearchAlgorithmUsed::JumpPoint;
 				break;
+			case 3:
+				m_SearchAlgorithmUsed = SearchAlgorithmUsed::BlockJumpPoint;
+				break;
+			case 4:
+				m_SearchAlgorithmUsed = SearchAlgorithmUsed::JumpPointPlus;
+				break;
+			case 5:
+				m_SearchAlgorithmUsed = SearchAlgorithmUsed::BidirectionalStar;
+				break;
+			case 6:
+				m_SearchAlgorithmUsed = SearchAlgorithmUsed::HierarchicalStar;
+				break;
 			default:
 				m_SearchAlgorithmUsed = SearchAlgorithmUsed::None;
 				break;
 			}
 		}
 
+		/*Spacing*/ImGui::Spacing(); ImGui::Separator(); ImGui::Spacing(); ImGui::Spacing();
+
+		//counters of the last search, to explain why one algorithm is slower than another
+		const SearchStats& searchStats = m_SearchContext.GetStats();
+		ImGui::Text("LAST SEARCH");
+		ImGui::Indent();
+		ImGui::Text("%.3f ms search", searchStats.searchTime);
+		ImGui::Text("%.3f ms reconstruction", searchStats.reconstructionTime);
+		ImGui::Text("%d expanded", searchStats.nrOfExpandedNodes);
+		ImGui::Text("%d generated", searchStats.nrOfGeneratedNodes);
+		ImGui::Text("%d reopened", searchStats.nrOfReopenedNodes);
+		ImGui::Text("%d / %d heap push/pop", searchStats.nrOfHeapPushes, searchStats.nrOfHeapPops);
+		ImGui::Text("%d decrease-key", searchStats.nrOfDecreaseKeys);
+		ImGui::Text("%d peak open list", searchStats.peakOpenListSize);
+		ImGui::Text("%d jump steps", searchStats.nrOfJumpSteps);
+		ImGui::Text("%.1f KB scratch", searchStats.scratchMemory / 1024.f);
+		ImGui::Unindent();
+
 		ImGui::Spacing();
 
 		//End
@@ -7,6 +7,14 @@
 #include "framework\EliteAI\EliteGraphs\EGridGraph.h"
 #include "framework\EliteAI\EliteGraphs\EliteGraphUtilities\EGraphEditor.h"
 #include "framework\EliteAI\EliteGraphs\EliteGraphUtilities\EGraphRenderer.h"
+#include "framework\EliteAI\EliteGraphs\EliteGraphUtilities\EGridMapFile.h"
+#include "framework\EliteAI\EliteGraphs\EliteGraphAlgorithms\EAstar.h"
+#include "framework\EliteAI\EliteGraphs\EliteGraphAlgorithms\EBFS.h"
+#include "framework\EliteAI\EliteGraphs\EliteGraphAlgorithms\EJPS.h"
+#include "framework\EliteAI\EliteGraphs\EliteGraphAlgorithms\EBlockJPS.h"
+#include "framework\EliteAI\EliteGraphs\EliteGraphAlgorithms\EJPSPlus.h"
+#include "framework\EliteAI\EliteGraphs\EliteGraphAlgorithms\EBidirectionalAStar.h"
+#include "framework\EliteAI\EliteGraphs\EliteGraphAlgorithms\EHPAStar.h"
 
 
 //-----------------------------------------------------------------
@@ -17,6 +25,10 @@ enum class SearchAlgorithmUsed
 	Breath,
 	Star,
 	JumpPoint,
+	BlockJumpPoint,
+	JumpPointPlus,
+	BidirectionalStar,
+	HierarchicalStar,
 	None
 };
 
@@ -42,6 +54,8 @@ private:
 	static const int COLUMNS = 20;
 	static const int ROWS = 20;
 	unsigned int m_SizeCell = 15;
+	//loaded instead of the empty grid when it exists, the Save Map button writes the grid to it
+	const std::string m_MapFilePath = "Pathfinding.egmp";
 	Elite::GridGraph<Elite::GridTerrainNode, Elite::GraphConnection>* m_pGridGraph;
 
 	//Pathfinding datamembers
@@ -52,6 +66,41 @@ private:
 	std::vector<Elite::GridTerrainNode*> m_ClosedList;
 	bool m_UpdatePath = true;
 
+	//A*, JPS and bidirectional A* get the heuristic inlined, so they exist once for every heuristic policy
+	template<class T_HeuristicPolicy>
+	struct HeuristicPathfinders final
+	{
+		HeuristicPathfinders(Elite::GridGraph<Elite::GridTerrainNode, Elite::GraphConnection>* pGraph, const Elite::CompressedGraph* pCompressedGraph)
+			: starPathfinder{ pGraph }
+			, jumpPathfinder{ pGraph }
+			, bidirectionalPathfinder{ pGraph }
+		{
+			starPathfinder.SetCompressedGraph(pCompressedGraph);
+			jumpPathfinder.SetCompressedGraph(pCompressedGraph);
+			bidirectionalPathfinder.SetCompressedGraph(pCompressedGraph);
+		}
+
+		Elite::AStar<Elite::GridTerrainNode, Elite::GraphConnection, T_HeuristicPolicy> starPathfinder;
+		Elite::JPS<Elite::GridTerrainNode, Elite::GraphConnection, T_HeuristicPolicy> jumpPathfinder;
+		Elite::BidirectionalAStar<Elite::GridTerrainNode, Elite::GraphConnection, T_HeuristicPolicy> bidirectionalPathfinder;
+	};
+
+	//Pathfinders, created once in Start and sharing one search context so recomputing a path doesn't allocate
+	HeuristicPathfinders<Elite::HeuristicPolicies::Manhattan>* m_pManhattanPathfinders = nullptr;
+	HeuristicPathfinders<Elite::HeuristicPolicies::Euclidean>* m_pEuclideanPathfinders = nullptr;
+	HeuristicPathfinders<Elite::HeuristicPolicies::SqrtEuclidean>* m_pSqrtEuclideanPathfinders = nullptr;
+	HeuristicPathfinders<Elite::HeuristicPolicies::Octile>* m_pOctilePathfinders = nullptr;
+	HeuristicPathfinders<Elite::HeuristicPolicies::Chebyshev>* m_pChebyshevPathfinders = nullptr;
+	Elite::BFS<Elite::GridTerrainNode, Elite::GraphConnection>* m_pBreathPathfinder = nullptr;
+	Elite::BlockJPS<Elite::GridTerrainNode, Elite::GraphConnection>* m_pBlockJumpPathfinder = nullptr;
+	Elite::JPSPlus<Elite::GridTerrainNode, Elite::GraphConnection>* m_pJumpPlusPathfinder = nullptr;
+	Elite::HPAStar<Elite::GridTerrainNode, Elite::GraphConnection>* m_pHierarchicalPathfinder = nullptr;
+	Elite::SearchContext m_SearchContext{};
+	//remembers which nodes the last search put on its open and closed list, to draw them
+	Elite::SearchObservers::Recorder m_SearchRecorder{};
+	//copy of the connections of the grid in flat arrays, patched after every edit
+	Elite::CompressedGraph m_CompressedGraph{};
+
 	//Editor and Visualisation
 	Elite::EGraphEditor m_GraphEditor{};
 	Elite::EGraphRenderer m_GraphRenderer{};
@@ -64,11 +113,14 @@ private:
 	bool m_StartSelected = true;
 	int m_SelectedHeuristic = 4;
 	Elite::Heuristic m_pHeuristicFunction = Elite::HeuristicFunctions::Chebyshev;
-	int m_SelectedAlgorithm = 3;
+	int m_SelectedAlgorithm = 7;
 	SearchAlgorithmUsed  m_SearchAlgorithmUsed = SearchAlgorithmUsed::None;
 
 	//Functions
 	void MakeGridGraph();
+	void OnTerrainChanged(const std::vector<int>& changedNodes);
+	template<class T_HeuristicPolicy>
+	void CalculatePath(HeuristicPathfinders<T_HeuristicPolicy>& pathfinders, Elite::GridTerrainNode* pStartNode, Elite::GridTerrainNode* pEndNode);
 	void UpdateImGui();
 
 	//C++ make the class non-copyable